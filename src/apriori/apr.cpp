@@ -1,6 +1,9 @@
 #include "apr.hpp"
 #include "dataload/data_loader.hpp"
 #include "threadsignal.hpp"
+#include "miner/support.hpp"
+#include "profile/profiler.hpp"
+#include "sched/parallel_for.hpp"
 #include <clocale>
 #include <cmath>
 #include <algorithm>
@@ -8,6 +11,8 @@
 #include <iostream>
 #include <mutex>
 #include <future>
+#include <limits>
+#include <string>
 #include <unordered_set>
 
 using std::mutex;
@@ -22,20 +27,25 @@ using std::ceil;
 using std::sqrt;
 using std::unordered_set;
 
-Apriori::Apriori(const DataLoader& db, double confidencel, int tnumber)
-    : db(db), confidence(confidencel), co(tnumber)
+namespace {
+
+// 水平计数每批候选至少可用的字节数：预算已被数据集占满时不至于每行候选就扫描一遍事务
+constexpr size_t kMinHorizontalBatchBytes = 4u << 20;
+
+std::string megabytes(size_t bytes) {
+    return std::to_string(bytes / (1024 * 1024)) + " MB";
+}
+
+} // namespace
+
+Apriori::Apriori(const DataLoader& db, double confidencel, int tnumber, ItemsetSink* sink, size_t memory_budget)
+    : db_(db), confidence(confidencel), co(tnumber), sink_(sink), memory_budget_(memory_budget)
 {
-    double support_count = confidence * db.all_count;
-    confidence_count = static_cast<size_t>(std::ceil(support_count));
-    if (confidence_count < 1) confidence_count = 1;
+    confidence_count = resolveSupportCount(confidence, db.all_count);
 
-    // DataLoader 已经完成了倒排索引的转换，直接复制到 node_map
-    // 获取倒排索引
+    // DataLoader 已经完成了倒排索引的转换，level0 直接从倒排索引取 tid 列表（不复制整个数据集）
     const auto& invertedIndex = db.getInvertedIndex();
 
-    // 直接复制倒排索引到 node_map
-    node_map = invertedIndex;
-
     // 初始化level0 - 单个元素的频繁项集（使用线程池并发处理）
     Level level0;
     mutex level0Mutex;
@@ -46,6 +56,21 @@ Apriori::Apriori(const DataLoader& db, double confidencel, int tnumber)
 
     level0.reserve(invertedIndex.size());
 
+    // level0 的 tid 列表就放不下时，从一开始就使用水平计数
+    if (memory_budget_ > 0) {
+        size_t level0_bytes = 0;
+        for (const auto& tids : invertedIndex) {
+            if (tids.size() >= confidence_count) {
+                level0_bytes += tids.size() * sizeof(int) + sizeof(node) + sizeof(int);
+            }
+        }
+        if (level0_bytes > memory_budget_) {
+            horizontal_ = true;
+            fallback_ = "从 level 0 起不保存 tid 列表，改为水平计数（level0 的 tid 列表 " + megabytes(level0_bytes)
+                + "，可用 " + megabytes(memory_budget_) + "）";
+        }
+    }
+
     for (int i=0;i<invertedIndex.size();i++){
         // 使用静态记录的支持计数进行比较，避免重复的除法运算
         if (invertedIndex[i].size() < confidence_count){
@@ -54,15 +79,19 @@ Apriori::Apriori(const DataLoader& db, double confidencel, int tnumber)
 
         node n;
         n.items = {i};
-        n.records = invertedIndex[i];
-        level0.push_back(n);
+        if (!horizontal_) {
+            n.records = invertedIndex[i];
+        }
+        n.support = invertedIndex[i].size();
+        level0.push_back(std::move(n));
     }
 
     // 将level0添加到lmap
-    lmap.push_back(level0);
+    lmap.push_back(std::move(level0));
 
     // 预分配一些空 level，避免后续越界
     lmap.resize(10);
+    accountLevels();
 
     // 并发分片数量
     int blocks = CaculateBlocks(tnumber);
@@ -112,23 +141,10 @@ void Apriori::buildAprioriTable(size_t blocks) {
     int currentLevel = 1;
 
     while (currentLevel > 0 &&  !lmap[currentLevel-1].empty()) {
+        ProfileScope level_scope("apriori.level");
         cout << "构建Level " << currentLevel << "（" << (currentLevel+1) << "项集）..." << endl;
         cout << "从Level " << (currentLevel-1) << "（" << currentLevel << "项集）开始，包含 " << lmap[currentLevel-1].size() << " 个项集" << endl;
 
-        const auto& currentLevelMap = lmap[currentLevel-1];
-        size_t totalItemsets = currentLevelMap.size();
-
-        // 存储所有任务的future
-        vector<future<void>> futures;
-
-        auto nums = min(static_cast<size_t>(blocks), currentLevelMap.size());
-        auto blocksize = currentLevelMap.size() / nums;
-        blocksize+=1;
-
-        mutex writeMutex;
-
-        auto& pool = getThreadPool(this->co > 0 ? this->co : hard_thread);
-
         // 初始化当前 level（清空之前的可能残留数据）
         if (currentLevel >= static_cast<int>(lmap.size())) {
             lmap.resize(currentLevel + 1);
@@ -136,24 +152,63 @@ void Apriori::buildAprioriTable(size_t blocks) {
             lmap[currentLevel].clear();
         }
 
-        auto runtimeset = unordered_set<vector<int>, VectorHash, VectorEqual>();
+        // 有内存预算时，新 level 的 tid 列表只能使用上一级剩下的部分
+        size_t held = 0;
+        if (!horizontal_ && memory_budget_ > 0) {
+            for (const auto& n : lmap[currentLevel-1]) {
+                held += n.records.capacity() * sizeof(int) + sizeof(node);
+            }
+            level_limit_ = memory_budget_ > held ? memory_budget_ - held : 0;
+            level_bytes_.store(0, std::memory_order_relaxed);
+            over_budget_.store(false, std::memory_order_relaxed);
+        }
+
+        if (!horizontal_) {
+            const auto& currentLevelMap = lmap[currentLevel-1];
+
+            // 存储所有任务的future
+            vector<future<void>> futures;
+
+            auto nums = min(static_cast<size_t>(blocks), currentLevelMap.size());
+            auto blocksize = currentLevelMap.size() / nums;
+            blocksize+=1;
 
+            mutex writeMutex;
 
-        // 处理所有块对：包括同一块内的组合（i==j）和不同块之间的组合（i<j）
-        for(int i=0;i<(nums);i++){
-            for(int j=i;j<(nums);j++){  // 改为 j=i，包含 i==j 的情况
+            auto& pool = getThreadPool(this->co > 0 ? this->co : hard_thread);
 
-                futures.push_back(pool.submit_task([this, i, j, blocksize, &runtimeset, currentLevel, &writeMutex]() {
-                    processItemsetPairs(i, j, blocksize, currentLevel, writeMutex, runtimeset);
-                }));
+            auto runtimeset = unordered_set<vector<int>, VectorHash, VectorEqual>();
+
+            // 处理所有块对：包括同一块内的组合（i==j）和不同块之间的组合（i<j）
+            for(int i=0;i<(nums);i++){
+                for(int j=i;j<(nums);j++){  // 改为 j=i，包含 i==j 的情况
+
+                    futures.push_back(pool.submit_task([this, i, j, blocksize, &runtimeset, currentLevel, &writeMutex]() {
+                        processItemsetPairs(i, j, blocksize, currentLevel, writeMutex, runtimeset);
+                    }));
+                }
             }
-        }
 
-        for(auto& future : futures){
-            future.wait();
+            for(auto& future : futures){
+                future.wait();
+            }
+
+            // 上一级和新 level 的 tid 列表同时存在会超出预算：放弃这一级的结果，之后都用水平计数
+            if (over_budget_.load(std::memory_order_relaxed)) {
+                Level().swap(lmap[currentLevel]);
+                switchToHorizontal(currentLevel, "上一级 tid 列表 " + megabytes(held) + "，新 level 超过剩余的 "
+                    + megabytes(level_limit_) + "，预算 " + megabytes(memory_budget_));
+            }
+        }
+        if (horizontal_) {
+            buildLevelHorizontal(currentLevel);
         }
 
         cout << "Level " << currentLevel << " 构建完成，生成 " << lmap[currentLevel].size() << " 个项集" << endl;
+        accountLevels();
+
+        // 上一级已经用完，可以推送并释放
+        streamLevel(currentLevel - 1);
 
         // 检查下一级是否有结果，如果没有就停止
         if (lmap[currentLevel].empty()) {
@@ -168,9 +223,210 @@ void Apriori::buildAprioriTable(size_t blocks) {
             break;
         }
     }
+
+    // 推送剩余的level
+    for (size_t level = 0; level < lmap.size(); level++) {
+        streamLevel(level);
+    }
+}
+
+void Apriori::streamLevel(size_t level) {
+    if (sink_ == nullptr || level >= lmap.size() || lmap[level].empty()) {
+        return;
+    }
+
+    SinkWriter writer(*sink_);
+    for (const auto& n : lmap[level]) {
+        writer.emit(n.items.data(), n.items.size(), static_cast<uint32_t>(n.support));
+    }
+    writer.flush();
+
+    Level().swap(lmap[level]);
+    accountLevels();
+}
+
+void Apriori::accountLevels() {
+    if (!MemoryTracker::enabled()) {
+        return;
+    }
+    size_t bytes = lmap.capacity() * sizeof(Level);
+    for (const auto& level : lmap) {
+        bytes += level.capacity() * sizeof(node);
+        for (const auto& n : level) {
+            bytes += (n.items.capacity() + n.records.capacity()) * sizeof(int);
+        }
+    }
+    levels_memory_.set(MemoryCategory::TidLists, bytes);
+}
+
+void Apriori::switchToHorizontal(int currentLevel, const std::string& reason) {
+    horizontal_ = true;
+    for (auto& n : lmap[currentLevel-1]) {
+        vector<int>().swap(n.records);
+    }
+    fallback_ = "从 level " + std::to_string(currentLevel) + " 起丢弃 tid 列表，改为水平计数（" + reason + "）";
+    cout << "内存预算不足，" << fallback_ << endl;
+    accountLevels();
+}
+
+void Apriori::buildLevelHorizontal(int currentLevel) {
+    ProfileScope scope("apriori.horizontal");
+    Level& prev = lmap[currentLevel-1];
+    Level& next = lmap[currentLevel];
+    size_t k = static_cast<size_t>(currentLevel);   // 上一级项集的长度
+    size_t width = k + 1;
+
+    // 上一级按项集字典序排列：前 k-1 项相同的项集相邻，子集检查可以二分查找
+    std::sort(prev.begin(), prev.end(), [](const node& a, const node& b) {
+        return a.items < b.items;
+    });
+    auto frequent = [&prev](const vector<int>& items) {
+        auto found = std::lower_bound(prev.begin(), prev.end(), items, [](const node& n, const vector<int>& key) {
+            return n.items < key;
+        });
+        return found != prev.end() && found->items == items;
+    };
+
+    // 候选分批生成和计数：每批的候选和计数数组不超过预算扣除上一级与已得结果后剩下的部分
+    // 一批的最小单位是一行（一个项集与其后同前缀项集的全部连接）
+    const size_t candidate_bytes = width * sizeof(int) + sizeof(uint32_t);
+    size_t held = prev.capacity() * sizeof(node);
+    for (const auto& n : prev) {
+        held += n.items.capacity() * sizeof(int);
+    }
+    auto batchCapacity = [&]() -> size_t {
+        if (memory_budget_ == 0) {
+            return std::numeric_limits<size_t>::max();
+        }
+        size_t used = held + next.capacity() * sizeof(node) + next.size() * width * sizeof(int);
+        size_t available = memory_budget_ > used ? memory_budget_ - used : 0;
+        return std::max(available, kMinHorizontalBatchBytes) / candidate_bytes;
+    };
+
+    // 候选：前 k-1 项相同的两个项集连接，按字典序扁平存放（每个候选 width 项）
+    vector<int> candidates;
+    vector<uint32_t> supports;
+    uint64_t generated = 0, pruned = 0;
+    size_t batches = 0;
+    auto countBatch = [&]() {
+        size_t count = candidates.size() / width;
+        if (count == 0) {
+            return;
+        }
+        supports.assign(count, 0);
+        countHorizontal(candidates, width, supports);
+        for (size_t c = 0; c < count; c++) {
+            if (supports[c] < confidence_count) {
+                pruned++;
+                continue;
+            }
+            node n;
+            n.items.assign(candidates.begin() + c * width, candidates.begin() + (c + 1) * width);
+            n.support = supports[c];
+            next.push_back(std::move(n));
+        }
+        candidates.clear();
+        batches++;
+    };
+
+    size_t capacity = batchCapacity();
+    vector<int> candidate;
+    vector<int> subset;
+    for (size_t a = 0; a < prev.size(); ) {
+        size_t b = a + 1;
+        while (b < prev.size() && std::equal(prev[a].items.begin(), prev[a].items.end() - 1, prev[b].items.begin())) {
+            b++;
+        }
+        for (size_t i = a; i < b; i++) {
+            if (!candidates.empty() && candidates.size() / width + (b - i - 1) > capacity) {
+                countBatch();
+                capacity = batchCapacity();
+            }
+            for (size_t j = i + 1; j < b; j++) {
+                candidate = prev[i].items;
+                candidate.push_back(prev[j].items.back());
+                generated++;
+                // 去掉最后两项之一得到的就是两个父项集，其余 k-1 个子集也必须频繁
+                bool keep = true;
+                for (size_t drop = 0; drop + 1 < k && keep; drop++) {
+                    subset.clear();
+                    for (size_t m = 0; m < width; m++) {
+                        if (m != drop) {
+                            subset.push_back(candidate[m]);
+                        }
+                    }
+                    keep = frequent(subset);
+                }
+                if (keep) {
+                    candidates.insert(candidates.end(), candidate.begin(), candidate.end());
+                } else {
+                    pruned++;
+                }
+            }
+        }
+        a = b;
+    }
+    countBatch();
+
+    if (batches > 1) {
+        cout << "Level " << currentLevel << " 候选分 " << batches << " 批计数" << endl;
+    }
+    Profiler::count(ProfileCounter::CandidatesGenerated, generated);
+    Profiler::count(ProfileCounter::CandidatesPruned, pruned);
+}
+
+void Apriori::countHorizontal(const vector<int>& candidates, size_t width, vector<uint32_t>& supports) const {
+    size_t count = supports.size();
+
+    // 候选按字典序生成，首项相同的候选连续：按首项记录区间，扫描事务时只检查首项出现过的候选
+    int max_item = db_.getMaxValue();
+    vector<size_t> range_begin(max_item + 1, 0), range_end(max_item + 1, 0);
+    for (size_t c = count; c-- > 0; ) {
+        int first = candidates[c * width];
+        if (range_end[first] == 0) {
+            range_end[first] = c + 1;
+        }
+        range_begin[first] = c;
+    }
+
+    // 候选按下标切成若干段，每段由一个任务独占并扫描全部事务，计数直接写入共享数组中自己的那一段：
+    // 不需要每个线程一份计数，也不需要原子操作；多切几段让首项分布不均时负载也能摊开
+    const auto& records = db_.getOriginalData();
+    size_t threads = resolveThreadCount(co);
+    parallelFor(count, threads, count / (threads * 4) + 1, [&](size_t lo, size_t hi) {
+        vector<char> mark(max_item + 1, 0);
+        vector<int> present;
+        for (const auto& record : records) {
+            if (record.size() < width) {
+                continue;
+            }
+            present.clear();
+            for (int item : record) {
+                if (item >= 0 && item <= max_item && !mark[item]) {
+                    mark[item] = 1;
+                    present.push_back(item);
+                }
+            }
+            for (int item : present) {
+                size_t end = std::min(range_end[item], hi);
+                for (size_t c = std::max(range_begin[item], lo); c < end; c++) {
+                    const int* items = candidates.data() + c * width;
+                    bool contained = true;
+                    for (size_t m = 1; m < width && contained; m++) {
+                        contained = mark[items[m]] != 0;
+                    }
+                    supports[c] += contained ? 1 : 0;
+                }
+            }
+            for (int item : present) {
+                mark[item] = 0;
+            }
+        }
+    });
 }
 
 void Apriori::processItemsetPairs(size_t startblock, size_t endblock,size_t block_size, int currentLevel, mutex& writeMutex, unordered_set<vector<int>, VectorHash, VectorEqual>& runtimeset) {
+    ProfileScope scope("apriori.pairs");
 
     auto& level_map = lmap[currentLevel-1];
 
@@ -184,8 +440,11 @@ void Apriori::processItemsetPairs(size_t startblock, size_t endblock,size_t bloc
     auto b2 = endblock*block_size;
     auto e2 = min(b2+block_size, level_map.size());
 
+    // 计数先在本地累加，任务结束时一次性计入
+    uint64_t generated = 0, pruned = 0, bytes = 0;
+
     // 处理同一块内的组合（i==j）和不同块之间的组合（i<j）
-    for (int i=b1;i<e1;i++){
+    for (int i=b1;i<e1 && !over_budget_.load(std::memory_order_relaxed);i++){
         // 当处理同一块时（startblock == endblock），只处理 i < j 的情况，避免重复
         // 当处理不同块时，处理所有组合
         int j_start = (startblock == endblock) ? (i + 1) : b2;
@@ -201,16 +460,37 @@ void Apriori::processItemsetPairs(size_t startblock, size_t endblock,size_t bloc
             auto& v1 = level_map[i].records;
             auto& v2 = level_map[j].records;
             auto value = intersectSets(v1, v2);
+            generated++;
 
             // 使用静态记录的支持计数进行比较，避免重复的除法运算
             if (value.size() < confidence_count){
+                pruned++;
                 continue;
             }
 
-            local_stroage.push_back({key, value});
+            bytes += (key.size() + value.size()) * sizeof(int);
+            size_t support = value.size();
+            if (memory_budget_ > 0) {
+                size_t need = (key.capacity() + value.capacity()) * sizeof(int) + sizeof(node);
+                if (level_bytes_.fetch_add(need, std::memory_order_relaxed) + need > level_limit_) {
+                    over_budget_.store(true, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            local_stroage.push_back({key, std::move(value), support});
         }
     }
 
+    Profiler::count(ProfileCounter::CandidatesGenerated, generated);
+    Profiler::count(ProfileCounter::Intersections, generated);
+    Profiler::count(ProfileCounter::CandidatesPruned, pruned);
+    Profiler::count(ProfileCounter::BytesAllocated, bytes);
+
+    // 超出预算时这一级会整体重建，本地结果直接丢弃
+    if (over_budget_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
     lock_guard<mutex> lock(writeMutex);
     for(auto item : local_stroage){
         auto  get = runtimeset.find(item.items);
@@ -287,13 +567,13 @@ void Apriori::displayLevel0() {
     std::cout << "项集\t\t支持度" << std::endl;
     std::cout << "----------------------" << std::endl;
 
-    for (const auto& [itemset, recordSet] : lmap[0]) {
+    for (const auto& [itemset, recordSet, support] : lmap[0]) {
         std::cout << "{";
         for (size_t i = 0; i < itemset.size(); ++i) {
             std::cout << itemset[i];
             if (i < itemset.size() - 1) std::cout << ", ";
         }
-        std::cout << "}\t\t" << recordSet.size() << std::endl;
+        std::cout << "}\t\t" << support << std::endl;
     }
 
     std::cout << "总计: " << lmap[0].size() << " 个频繁1项集" << std::endl;
@@ -345,14 +625,22 @@ void Apriori::displayLevel(int level) {
     std::cout << "项集\t\t支持度" << std::endl;
     std::cout << "----------------------" << std::endl;
 
-    for (const auto& [itemset, recordSet] : lmap[level]) {
+    for (const auto& [itemset, recordSet, support] : lmap[level]) {
         std::cout << "{";
         for (size_t i = 0; i < itemset.size(); ++i) {
             std::cout << itemset[i];
             if (i < itemset.size() - 1) std::cout << ", ";
         }
-        std::cout << "}\t\t" << recordSet.size() << std::endl;
+        std::cout << "}\t\t" << support << std::endl;
     }
 
     std::cout << "总计: " << lmap[level].size() << " 个频繁" << (level + 1) << "项集" << std::endl;
 }
+
+void Apriori::collectItemsets(ItemsetPool& out) const {
+    for (const auto& level : lmap) {
+        for (const auto& n : level) {
+            out.insert(n.items.data(), n.items.size(), static_cast<uint32_t>(n.support));
+        }
+    }
+}
@@ -2,11 +2,17 @@
 #define APR_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <string>
 #include "dataload/data_loader.hpp"
+#include "profile/memory.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
 
 // 为 vector<int> 提供哈希函数
 struct VectorHash {
@@ -46,11 +52,20 @@ public:
 
     struct node{
         vector<int> items;
-        vector<int> records;
+        vector<int> records;    // tid 列表，水平计数模式下为空
+        size_t support = 0;     // 支持计数
     };
 
     using Level = vector<node>;
-    Apriori(const DataLoader& db, double confidence,int tnumber);
+    /**
+     * 构造函数：执行完整的Apriori算法
+     * @param db 数据加载器
+     * @param confidence 最小支持度（小于1为相对支持度，大于等于1为绝对支持计数）
+     * @param tnumber 线程数
+     * @param sink 结果接收端，不为空时每个level在不再需要后立即推送并释放
+     * @param memory_budget tid 列表可用的字节数，0 表示不限制；预计超出时丢弃 tid 列表，改为扫描事务的水平计数
+     */
+    Apriori(const DataLoader& db, double confidence,int tnumber, ItemsetSink* sink = nullptr, size_t memory_budget = 0);
     ~Apriori();
 
 
@@ -99,20 +114,79 @@ public:
 
      void displayLevel(int level);
 
+    /**
+     * 将所有level的频繁项集及支持计数追加到结果池
+     * @param out 结果池
+     */
+    void collectItemsets(ItemsetPool& out) const;
+
+    /**
+     * 为满足内存预算使用的降级模式，为空表示全程使用 tid 列表
+     */
+    const std::string& fallback() const noexcept {
+        return fallback_;
+    }
+
 private:
-    //input vector
-    DataLoader db;
+    const DataLoader& db_;
     double confidence;
     int co;
 
     //置信度频繁数量
     size_t confidence_count;
 
+    //结果接收端（可为空）
+    ItemsetSink* sink_;
+
     //aprior table
     vector<Level> lmap;
-    vector<vector<int>> node_map;
+
+    //lmap 中 tid 列表的内存登记
+    MemoryCharge levels_memory_;
+
+    //内存预算（字节，0 表示不限制）
+    size_t memory_budget_;
+
+    //是否已切换到水平计数（不再保存 tid 列表）
+    bool horizontal_ = false;
+    std::string fallback_;
+
+    //构建一个 level 时新 tid 列表可用的字节数、已占用的字节数，超出后各任务尽快退出
+    size_t level_limit_ = 0;
+    std::atomic<size_t> level_bytes_{0};
+    std::atomic<bool> over_budget_{false};
 
     bool CheckInDB(vector<int> data);
+
+    /**
+     * 把指定level推送到结果接收端并释放其内存（未指定接收端时不做任何事）
+     */
+    void streamLevel(size_t level);
+
+    /**
+     * 按当前内容重新登记 lmap 占用的内存（未启用内存统计时不做任何事）
+     */
+    void accountLevels();
+
+    /**
+     * 丢弃 level-1 的 tid 列表，之后的 level 都用水平计数构建
+     * @param currentLevel 即将构建的 level
+     * @param reason 降级原因（写入 fallback）
+     */
+    void switchToHorizontal(int currentLevel, const std::string& reason);
+
+    /**
+     * 水平计数构建一个 level：前缀连接 + 子集剪枝生成候选，按剩余预算分批，每批扫描一遍事务统计支持计数
+     */
+    void buildLevelHorizontal(int currentLevel);
+
+    /**
+     * 扫描全部事务统计一批候选的支持计数
+     * @param candidates 按字典序扁平存放的候选（每个候选 width 项）
+     * @param width 候选长度
+     * @param supports 各候选的支持计数，调用前清零，大小即候选个数
+     */
+    void countHorizontal(const vector<int>& candidates, size_t width, vector<uint32_t>& supports) const;
     int CaculateBlocks(int co);
     
 };
@@ -0,0 +1,237 @@
+#include "bench.hpp"
+#include "cli/mine_command.hpp"
+#include "dataload/data_loader.hpp"
+#include "miner/miner.hpp"
+#include "result/file_sink.hpp"
+#include "result/result_file.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using std::string;
+using std::vector;
+
+TimingStats TimingStats::of(vector<double> samples) {
+    TimingStats stats;
+    stats.samples = samples;
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    size_t rank = static_cast<size_t>(std::ceil(0.95 * static_cast<double>(n)));
+    stats.p95 = samples[std::max<size_t>(rank, 1) - 1];
+    double sum = 0;
+    for (double s : samples) {
+        sum += s;
+    }
+    stats.mean = sum / static_cast<double>(n);
+    if (n > 1) {
+        double squares = 0;
+        for (double s : samples) {
+            squares += (s - stats.mean) * (s - stats.mean);
+        }
+        stats.stddev = std::sqrt(squares / static_cast<double>(n - 1));
+    }
+    return stats;
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct EngineBench {
+    string engine;
+    size_t itemsets = 0;
+    TimingStats mine;
+    bool has_output = false;
+    TimingStats output;
+};
+
+void writeStats(JsonWriter& json, const TimingStats& stats) {
+    json.beginObject()
+        .key("min").value(stats.min)
+        .key("median").value(stats.median)
+        .key("p95").value(stats.p95)
+        .key("mean").value(stats.mean)
+        .key("stddev").value(stats.stddev)
+        .key("max").value(stats.max)
+        .key("samples").array(stats.samples)
+        .endObject();
+}
+
+void printRow(std::ostream& out, const string& phase, const TimingStats& stats) {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %10.2f %10.2f %10.2f %10.2f %10.2f\n", phase.c_str(),
+                  stats.min, stats.median, stats.p95, stats.mean, stats.stddev);
+    out << line;
+}
+
+} // namespace
+
+int runBenchCommand(const MineOptions& options) {
+    if (options.out_of_core) {
+        throw std::invalid_argument("dig bench 不支持 --out-of-core，请用 dig mine");
+    }
+    // 计时期间屏蔽加载器和引擎的进度输出，控制台打印不计入任何阶段
+    ConsoleSilencer silencer(true);
+    startProfiling(options);
+    int rounds = options.warmup + options.repeat;
+
+    // 加载和建索引：每轮重新构造数据加载器，先释放上一轮的数据，避免两份数据同时驻留
+    // 加载阶段为构造总耗时减去建索引耗时（合成数据时即为生成耗时）
+    vector<double> load_ms, index_ms;
+    std::unique_ptr<DataLoader> loader;
+    for (int r = 0; r < rounds; r++) {
+        loader.reset();
+        auto start = Clock::now();
+        loader = openDataset(options);
+        double total = elapsedMs(start);
+        if (r >= options.warmup) {
+            double index = loader->getLoadTimings().index_ms;
+            load_ms.push_back(total - index);
+            index_ms.push_back(index);
+        }
+    }
+    if (loader->size() == 0) {
+        throw std::runtime_error("数据文件为空: " + options.input);
+    }
+
+    DatasetView data(*loader);
+    size_t transactions = data.transactionCount();
+    size_t min_count = options.minSupportCount(transactions);
+    SupportThreshold threshold{static_cast<double>(min_count)};
+    double min_support = options.support_is_count
+        ? static_cast<double>(min_count) / static_cast<double>(transactions) : options.support;
+    OutputFormat format = options.resolvedFormat();
+
+    vector<EngineBench> benches;
+    for (const string& name : options.engines) {
+        EngineBench bench;
+        bench.engine = name;
+        auto miner = createMiner(options, name);
+
+        // 挖掘：结果只计数，不含输出开销
+        vector<double> mine_ms;
+        for (int r = 0; r < rounds; r++) {
+            CountingSink counter;
+            auto start = Clock::now();
+            miner->mine(data, threshold, counter);
+            double ms = elapsedMs(start);
+            bench.itemsets = counter.size();
+            if (r >= options.warmup) {
+                mine_ms.push_back(ms);
+            }
+        }
+        bench.mine = TimingStats::of(mine_ms);
+
+        // 输出：收集一次结果，之后每轮把同一批结果写入新的文件接收端
+        if (format == OutputFormat::Text || format == OutputFormat::Binary) {
+            CollectSink collected;
+            miner->mine(data, threshold, collected);
+            string path = options.outputPathFor(name);
+            vector<double> output_ms;
+            for (int r = 0; r < rounds; r++) {
+                auto start = Clock::now();
+                std::unique_ptr<ItemsetSink> sink;
+                if (format == OutputFormat::Binary) {
+                    sink = std::make_unique<BinaryFileSink>(path, transactions, min_count, min_support);
+                } else {
+                    sink = std::make_unique<TextFileSink>(path);
+                }
+                sink->consume(collected.itemsets());
+                sink->finish();
+                sink.reset();
+                double ms = elapsedMs(start);
+                if (r >= options.warmup) {
+                    output_ms.push_back(ms);
+                }
+            }
+            bench.has_output = true;
+            bench.output = TimingStats::of(output_ms);
+        }
+        benches.push_back(std::move(bench));
+    }
+    silencer.restore();
+
+    TimingStats load = TimingStats::of(load_ms);
+    TimingStats index = TimingStats::of(index_ms);
+
+    if (options.json) {
+        std::ofstream file;
+        if (!options.json_path.empty()) {
+            file.open(options.json_path);
+            if (!file) {
+                throw std::runtime_error("无法写入文件: " + options.json_path);
+            }
+        }
+        std::ostream& out = options.json_path.empty() ? std::cout : file;
+        JsonWriter json(out);
+        json.beginObject()
+            .key("input").value(options.input)
+            .key("transactions").value(transactions)
+            .key("threads").value(options.threads)
+            .key("min_support").value(min_support)
+            .key("min_count").value(min_count)
+            .key("warmup").value(options.warmup)
+            .key("repeat").value(options.repeat)
+            .key("unit").value("ms");
+        json.key("load");
+        writeStats(json, load);
+        json.key("index");
+        writeStats(json, index);
+        json.key("engines").beginArray();
+        for (const auto& bench : benches) {
+            json.beginObject()
+                .key("engine").value(bench.engine)
+                .key("itemsets").value(bench.itemsets);
+            json.key("mine");
+            writeStats(json, bench.mine);
+            if (bench.has_output) {
+                json.key("output");
+                writeStats(json, bench.output);
+            }
+            json.endObject();
+        }
+        json.endArray();
+        finishProfiling(options, std::cerr, &json);
+        json.endObject();
+        out << '\n';
+        return 0;
+    }
+
+    std::cout << "数据: " << options.input << "，记录总数 " << transactions
+              << "，最小支持计数 " << min_count << "，线程数 " << options.threads
+              << "，预热 " << options.warmup << " 次，计时 " << options.repeat << " 次\n\n";
+    char header[160];
+    std::snprintf(header, sizeof(header), "%-24s %10s %10s %10s %10s %10s\n",
+                  "phase (ms)", "min", "median", "p95", "mean", "stddev");
+    std::cout << header;
+    printRow(std::cout, "load", load);
+    printRow(std::cout, "index", index);
+    for (const auto& bench : benches) {
+        printRow(std::cout, "mine:" + bench.engine, bench.mine);
+        if (bench.has_output) {
+            printRow(std::cout, "output:" + bench.engine, bench.output);
+        }
+    }
+    std::cout << "\n";
+    for (const auto& bench : benches) {
+        std::cout << bench.engine << ": " << bench.itemsets << " 个项集\n";
+    }
+    finishProfiling(options, std::cout, nullptr);
+    std::cout.flush();
+    return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef CLI_BENCH_HPP
+#define CLI_BENCH_HPP
+
+#include <cstddef>
+#include <vector>
+#include "cli/options.hpp"
+
+/**
+ * 一组计时样本的统计量（毫秒）
+ */
+struct TimingStats {
+    std::vector<double> samples;
+    double min = 0;
+    double median = 0;
+    double p95 = 0;       // 最近秩法：排序后第 ceil(0.95n) 个样本
+    double mean = 0;
+    double stddev = 0;    // 样本标准差（n-1），只有一个样本时为0
+    double max = 0;
+
+    /**
+     * 由样本计算统计量（samples 保持原始顺序）
+     */
+    static TimingStats of(std::vector<double> samples);
+};
+
+/**
+ * dig bench：加载（读取+解析）、建索引、挖掘、输出四个阶段分别预热 warmup 次后计时 repeat 次，
+ * 报告最短、中位数、P95、平均值和标准差；--json 输出可以直接在不同提交之间比较
+ * 输出阶段把一次挖掘收集到的结果按 --output/--format 写出，只计写出的开销；未指定输出时跳过
+ * @return 进程退出码
+ * @throws std::runtime_error 文件无法读取或写入
+ */
+int runBenchCommand(const MineOptions& options);
+
+#endif // CLI_BENCH_HPP
@@ -0,0 +1,48 @@
+#ifndef CONSOLE_SILENCER_HPP
+#define CONSOLE_SILENCER_HPP
+
+#include <iostream>
+#include <streambuf>
+
+/**
+ * 在作用域内屏蔽标准输出（引擎和数据加载器直接向 cout 打印进度）
+ * 析构时恢复原来的缓冲区
+ * 替换的是整个进程的 cout 缓冲区，只能在命令行入口使用：常驻服务中并发处理的请求会互相影响
+ */
+class ConsoleSilencer {
+public:
+    explicit ConsoleSilencer(bool enabled) {
+        if (enabled) {
+            saved_ = std::cout.rdbuf(&null_);
+        }
+    }
+
+    ~ConsoleSilencer() {
+        restore();
+    }
+
+    /**
+     * 提前恢复标准输出
+     */
+    void restore() {
+        if (saved_) {
+            std::cout.rdbuf(saved_);
+            saved_ = nullptr;
+        }
+    }
+
+    ConsoleSilencer(const ConsoleSilencer&) = delete;
+    ConsoleSilencer& operator=(const ConsoleSilencer&) = delete;
+
+private:
+    struct NullBuffer : public std::streambuf {
+        int overflow(int c) override {
+            return c;
+        }
+    };
+
+    NullBuffer null_;
+    std::streambuf* saved_ = nullptr;
+};
+
+#endif // CONSOLE_SILENCER_HPP
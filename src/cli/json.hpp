@@ -0,0 +1,140 @@
+#ifndef CLI_JSON_HPP
+#define CLI_JSON_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 流式 JSON 输出：按调用顺序写出对象和数组，自动处理逗号和字符串转义
+ * 用法：json.beginObject().key("n").value(3).endObject();
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::ostream& out) : out_(out) {}
+
+    JsonWriter& beginObject() {
+        separate();
+        out_ << '{';
+        first_.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& endObject() {
+        first_.pop_back();
+        out_ << '}';
+        return *this;
+    }
+
+    JsonWriter& beginArray() {
+        separate();
+        out_ << '[';
+        first_.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& endArray() {
+        first_.pop_back();
+        out_ << ']';
+        return *this;
+    }
+
+    JsonWriter& key(const std::string& name) {
+        separate();
+        writeString(name);
+        out_ << ':';
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(const std::string& text) {
+        separate();
+        writeString(text);
+        return *this;
+    }
+
+    JsonWriter& value(const char* text) {
+        return value(std::string(text));
+    }
+
+    JsonWriter& value(bool flag) {
+        separate();
+        out_ << (flag ? "true" : "false");
+        return *this;
+    }
+
+    JsonWriter& value(double number) {
+        separate();
+        if (!std::isfinite(number)) {
+            out_ << "null";
+        } else {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%.10g", number);
+            out_ << buffer;
+        }
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+    JsonWriter& value(T number) {
+        separate();
+        out_ << +number;
+        return *this;
+    }
+
+    template <typename T>
+    JsonWriter& array(const std::vector<T>& values) {
+        beginArray();
+        for (const auto& v : values) {
+            value(v);
+        }
+        return endArray();
+    }
+
+private:
+    // 同一层级的第二个元素起前面加逗号；键之后的值不加
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!first_.empty()) {
+            if (!first_.back()) {
+                out_ << ',';
+            }
+            first_.back() = false;
+        }
+    }
+
+    void writeString(const std::string& text) {
+        out_ << '"';
+        for (unsigned char c : text) {
+            switch (c) {
+                case '"': out_ << "\\\""; break;
+                case '\\': out_ << "\\\\"; break;
+                case '\n': out_ << "\\n"; break;
+                case '\r': out_ << "\\r"; break;
+                case '\t': out_ << "\\t"; break;
+                default:
+                    if (c < 0x20) {
+                        char buffer[8];
+                        std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                        out_ << buffer;
+                    } else {
+                        out_ << c;
+                    }
+            }
+        }
+        out_ << '"';
+    }
+
+    std::ostream& out_;
+    std::vector<bool> first_;
+    bool after_key_ = false;
+};
+
+#endif // CLI_JSON_HPP
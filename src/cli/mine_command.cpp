@@ -0,0 +1,365 @@
+#include "mine_command.hpp"
+#include "dataload/quest_generator.hpp"
+#include "dataload/transaction_file.hpp"
+#include "miner/miner.hpp"
+#include "partition/son.hpp"
+#include "shard/sharded.hpp"
+#include "profile/memory.hpp"
+#include "profile/perf_counters.hpp"
+#include "result/file_sink.hpp"
+#include "result/result_file.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const char* kindId(ItemsetKind kind) {
+    switch (kind) {
+        case ItemsetKind::Frequent: return "frequent";
+        case ItemsetKind::Closed: return "closed";
+        case ItemsetKind::Maximal: return "maximal";
+        case ItemsetKind::TopK: return "topk";
+    }
+    return "unknown";
+}
+
+struct EngineRun {
+    string engine;
+    ItemsetKind kind = ItemsetKind::Frequent;
+    string output;
+    vector<size_t> levels;
+    size_t itemsets = 0;
+    vector<double> mine_ms;
+    string fallback;             // 非常规的运行模式（内存预算降级、外存或分区挖掘）
+};
+
+void writePerfJson(const PerfPhases& phases, JsonWriter& json) {
+    json.key("perf").beginArray();
+    for (const auto& phase : phases.phases()) {
+        json.beginObject().key("phase").value(phase.name).key("events").beginObject();
+        for (size_t e = 0; e < PerfCounters::Count; e++) {
+            if (phase.sample.available[e]) {
+                json.key(PerfCounters::eventName(static_cast<PerfCounters::Event>(e))).value(phase.sample.values[e]);
+            }
+        }
+        json.endObject()
+            .key("ipc").value(phase.sample.ipc())
+            .key("intersections").value(phase.intersections)
+            .key("nodes").value(phase.nodes)
+            .endObject();
+    }
+    json.endArray();
+}
+
+void writeMemoryJson(const MemoryReport& report, JsonWriter& json) {
+    const size_t categories = static_cast<size_t>(MemoryCategory::Count);
+    json.key("memory").beginObject()
+        .key("rss").value(report.process.rss)
+        .key("peak_rss").value(report.process.peak)
+        .key("phases").beginArray();
+    for (const auto& phase : report.phases) {
+        json.beginObject()
+            .key("phase").value(phase.name)
+            .key("rss_before").value(phase.rss_before)
+            .key("rss_after").value(phase.rss_after)
+            .key("peak_rss").value(phase.peak_rss)
+            .key("peak_exact").value(phase.peak_exact)
+            .key("peak").beginObject();
+        for (size_t c = 0; c < categories; c++) {
+            json.key(memoryCategoryName(static_cast<MemoryCategory>(c))).value(phase.peak[c]);
+        }
+        json.endObject().endObject();
+    }
+    json.endArray().key("structures").beginObject();
+    for (size_t c = 0; c < categories; c++) {
+        json.key(memoryCategoryName(static_cast<MemoryCategory>(c))).beginObject()
+            .key("peak").value(report.peak[c])
+            .key("current").value(report.current[c])
+            .endObject();
+    }
+    json.endObject().endObject();
+}
+
+} // namespace
+
+void startProfiling(const MineOptions& options) {
+    // --perf 需要剖析器的求交 / 节点计数来换算每单位的缺失数
+    if (options.profile || !options.trace_path.empty() || options.perf) {
+        Profiler::instance().start();
+    }
+}
+
+void finishProfiling(const MineOptions& options, std::ostream& table_out, JsonWriter* json) {
+    if (!options.profile && options.trace_path.empty() && !options.perf) {
+        return;
+    }
+    Profiler& profiler = Profiler::instance();
+    profiler.stop();
+    if (!options.trace_path.empty()) {
+        std::ofstream trace(options.trace_path);
+        if (!trace) {
+            throw std::runtime_error("无法写入文件: " + options.trace_path);
+        }
+        profiler.writeChromeTrace(trace);
+    }
+    if (!options.profile) {
+        return;
+    }
+    ProfileReport report = profiler.report();
+    if (json == nullptr) {
+        report.print(table_out);
+        return;
+    }
+    json->key("profile").beginObject()
+        .key("wall_ms").value(report.wall_ns / 1e6)
+        .key("timers").beginArray();
+    for (const auto& timer : report.timers) {
+        json->beginObject()
+            .key("name").value(timer.name)
+            .key("calls").value(timer.calls)
+            .key("total_ms").value(timer.total_ns / 1e6)
+            .key("max_ms").value(timer.max_ns / 1e6)
+            .key("threads").value(timer.threads)
+            .endObject();
+    }
+    json->endArray().key("counters").beginObject();
+    for (size_t c = 0; c < static_cast<size_t>(ProfileCounter::Count); c++) {
+        json->key(profileCounterName(static_cast<ProfileCounter>(c))).value(report.counters[c]);
+    }
+    json->endObject().endObject();
+}
+
+std::unique_ptr<DataLoader> openDataset(const MineOptions& options) {
+    const string prefix = "quest:";
+    if (options.input.compare(0, prefix.size(), prefix) == 0) {
+        QuestGenerator generator(QuestParams::parse(options.input.substr(prefix.size())));
+        return std::make_unique<DataLoader>(generator.generate(options.threads), options.threads);
+    }
+    return std::make_unique<DataLoader>(options.input, options.delimiter, options.threads);
+}
+
+std::unique_ptr<Miner> createMiner(const MineOptions& options, const string& name) {
+    std::unique_ptr<Miner> miner;
+    if (options.son) {
+        miner = std::make_unique<SonMiner>(name, options.threads, options.partitions);
+    } else if (options.shards > 0) {
+        miner = std::make_unique<ShardedMiner>(name, options.threads, options.shards, options.numa);
+    } else {
+        miner = MinerRegistry::instance().create(name, options.threads);
+    }
+    miner->setMemoryBudget(MemoryBudget{options.memory_budget, options.spill_dir});
+    return miner;
+}
+
+int runMineCommand(const MineOptions& options) {
+    // JSON 写到标准输出时，过程日志会混进去，一律屏蔽
+    ConsoleSilencer silencer(options.quiet || (options.json && options.json_path.empty()));
+    startProfiling(options);
+    PerfPhases perf;
+    MemoryTracker& memory = MemoryTracker::instance();
+    if (options.memory) {
+        memory.start();
+    }
+    if (options.perf && options.threads != 1) {
+        // 计数器只能附着在已有线程上，先建好线程池，工作线程才会计入各阶段
+        getThreadPool(resolveThreadCount(options.threads));
+    }
+
+    auto load_start = Clock::now();
+    if (options.perf) {
+        perf.begin("load");
+    }
+    if (options.memory) {
+        memory.beginPhase("load");
+    }
+    // 外存模式不载入数据，只扫描一遍统计事务数，挖掘时再流式读取
+    std::unique_ptr<DataLoader> dataset;
+    std::unique_ptr<TransactionFile> stream;
+    if (options.out_of_core) {
+        stream = std::make_unique<TransactionFile>(options.input, options.delimiter);
+    } else {
+        dataset = openDataset(options);
+    }
+    if (options.memory) {
+        memory.endPhase();
+    }
+    if (options.perf) {
+        perf.end();
+    }
+    double load_ms = elapsedMs(load_start);
+    size_t transactions = stream ? stream->transactionCount() : dataset->all_count;
+    int max_item = stream ? stream->maxItem() : dataset->getMaxValue();
+    if (transactions == 0 || (dataset && dataset->size() == 0)) {
+        throw std::runtime_error("数据文件为空或无法读取: " + options.input);
+    }
+
+    size_t min_count = options.minSupportCount(transactions);
+    // 引擎按 SupportThreshold 的约定解释阈值：换算成绝对计数后传入，相对支持度 1.0 也不会被当成计数
+    SupportThreshold threshold{static_cast<double>(min_count)};
+    double min_support = options.support_is_count
+        ? static_cast<double>(min_count) / static_cast<double>(transactions) : options.support;
+    OutputFormat format = options.resolvedFormat();
+
+    auto& registry = MinerRegistry::instance();
+    vector<EngineRun> runs;
+    for (const string& name : options.engines) {
+        EngineRun run;
+        run.engine = name;
+        for (const auto& entry : registry.entries()) {
+            if (entry.name == name) {
+                run.kind = entry.kind;
+            }
+        }
+        run.output = format == OutputFormat::Count ? "-" : options.outputPathFor(name);
+        auto miner = createMiner(options, name);
+
+        for (int r = 0; r < options.warmup + options.repeat; r++) {
+            CountingSink counter;
+            std::unique_ptr<ItemsetSink> file_sink;
+            if (format == OutputFormat::Binary) {
+                file_sink = std::make_unique<BinaryFileSink>(run.output, transactions, min_count, min_support);
+            } else if (format == OutputFormat::Text) {
+                file_sink = std::make_unique<TextFileSink>(run.output);
+            }
+            TeeSink sink(counter, file_sink.get());
+
+            // 预热轮不计入性能计数
+            bool measured = options.perf && r >= options.warmup;
+            if (measured) {
+                perf.begin("mine:" + name);
+            }
+            if (options.memory) {
+                memory.beginPhase("mine:" + name);
+            }
+            auto mine_start = Clock::now();
+            // SON 分区、投影数据库（外存或超出内存预算时）会多次运行引擎，逐个打印进度没有意义
+            ConsoleSilencer nested(options.son || options.out_of_core || options.memory_budget > 0);
+            if (stream) {
+                miner->mineFile(*stream, threshold, sink);
+            } else {
+                miner->mine(DatasetView(*dataset), threshold, sink);
+            }
+            nested.restore();
+            file_sink.reset();
+            double ms = elapsedMs(mine_start);
+            if (options.memory) {
+                memory.endPhase();
+            }
+            if (measured) {
+                perf.end();
+            }
+            if (r < options.warmup) {
+                continue;
+            }
+            run.mine_ms.push_back(ms);
+            run.itemsets = counter.size();
+            run.fallback = miner->fallback();
+            // 最大项集等结果的短level可能为空，只去掉末尾的空level
+            run.levels.clear();
+            for (size_t level = 0; level < counter.levelCount(); level++) {
+                run.levels.push_back(counter.levelSize(level));
+            }
+            while (!run.levels.empty() && run.levels.back() == 0) {
+                run.levels.pop_back();
+            }
+        }
+        runs.push_back(std::move(run));
+    }
+    silencer.restore();
+    MemoryReport memory_report;
+    if (options.memory) {
+        memory_report = memory.report();
+        memory.stop();
+    }
+
+    if (options.json) {
+        std::ofstream file;
+        if (!options.json_path.empty()) {
+            file.open(options.json_path);
+            if (!file) {
+                throw std::runtime_error("无法写入文件: " + options.json_path);
+            }
+        }
+        std::ostream& out = options.json_path.empty() ? std::cout : file;
+        JsonWriter json(out);
+        json.beginObject()
+            .key("input").value(options.input)
+            .key("transactions").value(transactions)
+            .key("max_item").value(max_item)
+            .key("threads").value(options.threads)
+            .key("min_support").value(min_support)
+            .key("min_count").value(min_count)
+            .key("memory_budget").value(options.memory_budget)
+            .key("load_ms").value(load_ms)
+            .key("runs").beginArray();
+        for (const auto& run : runs) {
+            json.beginObject()
+                .key("engine").value(run.engine)
+                .key("kind").value(kindId(run.kind))
+                .key("itemsets").value(run.itemsets)
+                .key("levels").array(run.levels)
+                .key("output").value(run.output)
+                .key("mine_ms").array(run.mine_ms)
+                .key("fallback").value(run.fallback)
+                .endObject();
+        }
+        json.endArray();
+        if (options.perf) {
+            writePerfJson(perf, json);
+        }
+        if (options.memory) {
+            writeMemoryJson(memory_report, json);
+        }
+        finishProfiling(options, std::cerr, &json);
+        json.endObject();
+        out << '\n';
+        return 0;
+    }
+
+    std::cout << "数据: " << options.input << "，记录总数 " << transactions
+              << "，最大元素值 " << max_item << "，加载耗时 " << load_ms << " ms\n"
+              << "最小支持度: " << min_support << " (最小支持计数: " << min_count << ")\n";
+    for (const auto& run : runs) {
+        std::cout << "\n" << run.engine << " (" << itemsetKindName(run.kind) << "): " << run.itemsets << " 个项集\n";
+        for (size_t level = 0; level < run.levels.size(); level++) {
+            std::cout << "level: " << level << " " << run.levels[level] << "\n";
+        }
+        if (run.output != "-") {
+            std::cout << "结果已写入: " << run.output << "\n";
+        }
+        if (!run.fallback.empty()) {
+            std::cout << "运行模式: " << run.fallback << "\n";
+        }
+        std::cout << "挖掘时间:";
+        for (double ms : run.mine_ms) {
+            std::cout << " " << ms;
+        }
+        std::cout << " ms";
+        if (run.mine_ms.size() > 1) {
+            std::cout << "（最短 " << *std::min_element(run.mine_ms.begin(), run.mine_ms.end()) << " ms）";
+        }
+        std::cout << "\n";
+    }
+    if (options.perf) {
+        perf.print(std::cout);
+    }
+    if (options.memory) {
+        memory_report.print(std::cout);
+    }
+    finishProfiling(options, std::cout, nullptr);
+    std::cout.flush();
+    return 0;
+}
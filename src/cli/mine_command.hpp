@@ -0,0 +1,47 @@
+#ifndef CLI_MINE_COMMAND_HPP
+#define CLI_MINE_COMMAND_HPP
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include "cli/console_silencer.hpp"
+#include "cli/json.hpp"
+#include "cli/options.hpp"
+#include "dataload/data_loader.hpp"
+#include "miner/miner.hpp"
+#include "profile/profiler.hpp"
+
+/**
+ * 按 --input 打开数据集：quest:key=value,... 在内存中生成合成数据（见 QuestParams::parse），否则读取文件
+ * @throws std::runtime_error 文件无法读取
+ * @throws std::invalid_argument 合成数据参数无效
+ */
+std::unique_ptr<DataLoader> openDataset(const MineOptions& options);
+
+/**
+ * 按名称创建引擎并设置内存预算，--son 时包装为 SON 分区挖掘，--shards 时包装为多进程分片挖掘
+ * @throws std::invalid_argument --son / --shards 用于不输出全部频繁项集的引擎
+ */
+std::unique_ptr<Miner> createMiner(const MineOptions& options, const std::string& name);
+
+/**
+ * 按 --profile / --trace 开始剖析（两者都未指定时不启用）
+ */
+void startProfiling(const MineOptions& options);
+
+/**
+ * 停止剖析并导出：--trace 写 trace 文件；--profile 把汇总表打印到 table_out，
+ * report 不为空时同时写入 JSON（键 profile）
+ * @throws std::runtime_error 无法写入 trace 文件
+ */
+void finishProfiling(const MineOptions& options, std::ostream& table_out, JsonWriter* report);
+
+/**
+ * dig mine：按参数加载数据、依次运行各引擎（每个重复 repeat 次），输出结果和汇总
+ * 汇总默认为中文文本，--json 时为一个 JSON 对象
+ * @return 进程退出码
+ * @throws std::runtime_error 文件无法读取或写入
+ */
+int runMineCommand(const MineOptions& options);
+
+#endif // CLI_MINE_COMMAND_HPP
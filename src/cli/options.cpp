@@ -0,0 +1,309 @@
+#include "options.hpp"
+#include "miner/miner.hpp"
+#include "miner/support.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+
+size_t MineOptions::minSupportCount(size_t transaction_count) const {
+    if (support_is_count) {
+        return static_cast<size_t>(support);
+    }
+    return relativeSupportCount(support, transaction_count);
+}
+
+OutputFormat MineOptions::resolvedFormat() const {
+    if (format != OutputFormat::Auto) {
+        return format;
+    }
+    if (output == "-") {
+        return OutputFormat::Count;
+    }
+    bool binary = output.size() > 4 && output.compare(output.size() - 4, 4, ".bin") == 0;
+    return binary ? OutputFormat::Binary : OutputFormat::Text;
+}
+
+string MineOptions::outputPathFor(const string& engine) const {
+    if (engines.size() <= 1) {
+        return output;
+    }
+    size_t dot = output.find_last_of('.');
+    size_t slash = output.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash)) {
+        return output + "." + engine;
+    }
+    return output.substr(0, dot) + "." + engine + output.substr(dot);
+}
+
+size_t parseByteSize(const string& text) {
+    size_t pos = 0;
+    double value = 0;
+    try {
+        value = std::stod(text, &pos);
+    } catch (const std::exception&) {
+        throw std::invalid_argument("无法解析字节数: " + text);
+    }
+    string suffix = text.substr(pos);
+    double scale = 1;
+    if (suffix == "" || suffix == "B") {
+        scale = 1;
+    } else if (suffix == "K" || suffix == "k" || suffix == "KB") {
+        scale = 1024.0;
+    } else if (suffix == "M" || suffix == "m" || suffix == "MB") {
+        scale = 1024.0 * 1024;
+    } else if (suffix == "G" || suffix == "g" || suffix == "GB") {
+        scale = 1024.0 * 1024 * 1024;
+    } else {
+        throw std::invalid_argument("无法解析字节数: " + text);
+    }
+    if (value < 0) {
+        throw std::invalid_argument("字节数不能为负: " + text);
+    }
+    return static_cast<size_t>(value * scale);
+}
+
+char parseDelimiter(const string& text) {
+    if (text == "space") return ' ';
+    if (text == "tab" || text == "\\t") return '\t';
+    if (text == "comma") return ',';
+    if (text.size() == 1) return text[0];
+    throw std::invalid_argument("分隔符必须是单个字符或 space/tab/comma: " + text);
+}
+
+InputOptions parseInputOptions(int argc, char** argv, int first, std::vector<string>& positional) {
+    InputOptions options;
+    for (int i = first; i < argc; i++) {
+        string option = argv[i];
+        string name = option.substr(0, option.find('='));
+        bool input = option == "-i" || name == "--input";
+        bool delimiter = option == "-d" || name == "--delimiter";
+        if (!input && !delimiter) {
+            positional.push_back(option);
+            continue;
+        }
+        string value;
+        if (name != option) {
+            value = option.substr(name.size() + 1);
+        } else if (i + 1 < argc) {
+            value = argv[++i];
+        } else {
+            throw std::invalid_argument("参数 " + option + " 缺少取值");
+        }
+        if (input) {
+            options.input = value;
+            options.input_given = true;
+        } else {
+            options.delimiter = parseDelimiter(value);
+        }
+    }
+    return options;
+}
+
+namespace {
+
+double parseNumber(const string& option, const string& text) {
+    size_t pos = 0;
+    double value = 0;
+    try {
+        value = std::stod(text, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != text.size()) {
+        throw std::invalid_argument(option + " 需要数字参数: " + text);
+    }
+    return value;
+}
+
+int parseInteger(const string& option, const string& text, int minimum) {
+    double value = parseNumber(option, text);
+    if (value != std::floor(value) || value < minimum) {
+        throw std::invalid_argument(option + " 需要不小于 " + std::to_string(minimum) + " 的整数: " + text);
+    }
+    return static_cast<int>(value);
+}
+
+} // namespace
+
+MineOptions parseMineOptions(int argc, char** argv, int first, const MineOptions& defaults) {
+    MineOptions options = defaults;
+    for (int i = first; i < argc; i++) {
+        string option = argv[i];
+        // 开关类参数
+        if (option == "-q" || option == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+        if (option == "--json") {
+            options.json = true;
+            continue;
+        }
+        if (option == "--profile") {
+            options.profile = true;
+            continue;
+        }
+        if (option == "--perf") {
+            options.perf = true;
+            continue;
+        }
+        if (option == "--memory") {
+            options.memory = true;
+            continue;
+        }
+        if (option == "--out-of-core") {
+            options.out_of_core = true;
+            continue;
+        }
+        if (option == "--son") {
+            options.son = true;
+            continue;
+        }
+        if (option == "--numa") {
+            options.numa = true;
+            continue;
+        }
+        // 带值的参数：--name value 或 --name=value
+        string value;
+        size_t eq = option.find('=');
+        if (option.compare(0, 2, "--") == 0 && eq != string::npos) {
+            value = option.substr(eq + 1);
+            option = option.substr(0, eq);
+        } else {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("参数 " + option + " 缺少取值");
+            }
+            value = argv[++i];
+        }
+
+        if (option == "-i" || option == "--input") {
+            options.input = value;
+        } else if (option == "-d" || option == "--delimiter") {
+            options.delimiter = parseDelimiter(value);
+        } else if (option == "-e" || option == "--engine") {
+            options.engines.clear();
+            std::stringstream list(value);
+            for (string name; std::getline(list, name, ',');) {
+                if (name.empty()) continue;
+                if (name == "all") {
+                    for (const auto& entry : MinerRegistry::instance().entries()) {
+                        options.engines.push_back(entry.name);
+                    }
+                } else if (!MinerRegistry::instance().contains(name)) {
+                    throw std::invalid_argument("未知的挖掘引擎: " + name);
+                } else {
+                    options.engines.push_back(name);
+                }
+            }
+            if (options.engines.empty()) {
+                throw std::invalid_argument("引擎列表为空");
+            }
+        } else if (option == "-s" || option == "--support") {
+            // 小于1为相对支持度，大于等于1为绝对支持计数
+            options.support = parseNumber(option, value);
+            options.support_is_count = options.support >= 1.0;
+            if (options.support <= 0) {
+                throw std::invalid_argument("支持度必须大于0: " + value);
+            }
+            if (options.support_is_count && options.support != std::floor(options.support)) {
+                throw std::invalid_argument("绝对支持计数必须是整数: " + value);
+            }
+        } else if (option == "--min-count") {
+            options.support = parseInteger(option, value, 1);
+            options.support_is_count = true;
+        } else if (option == "--min-support") {
+            options.support = parseNumber(option, value);
+            options.support_is_count = false;
+            if (options.support <= 0 || options.support > 1) {
+                throw std::invalid_argument("相对支持度必须在 (0, 1] 之间: " + value);
+            }
+        } else if (option == "-t" || option == "--threads") {
+            options.threads = parseInteger(option, value, 0);
+        } else if (option == "-o" || option == "--output") {
+            options.output = value;
+        } else if (option == "-f" || option == "--format") {
+            if (value == "text") options.format = OutputFormat::Text;
+            else if (value == "binary") options.format = OutputFormat::Binary;
+            else if (value == "count") options.format = OutputFormat::Count;
+            else throw std::invalid_argument("输出格式必须是 text/binary/count: " + value);
+        } else if (option == "-m" || option == "--memory-budget") {
+            options.memory_budget = parseByteSize(value);
+        } else if (option == "--spill-dir") {
+            options.spill_dir = value;
+        } else if (option == "--partitions") {
+            options.son = true;
+            options.partitions = static_cast<size_t>(parseInteger(option, value, 1));
+        } else if (option == "--shards") {
+            options.shards = static_cast<size_t>(parseInteger(option, value, 1));
+        } else if (option == "-r" || option == "--repeat") {
+            options.repeat = parseInteger(option, value, 1);
+        } else if (option == "-w" || option == "--warmup") {
+            options.warmup = parseInteger(option, value, 0);
+        } else if (option == "--json-file") {
+            options.json = true;
+            options.json_path = value;
+        } else if (option == "--trace") {
+            options.trace_path = value;
+        } else {
+            throw std::invalid_argument("未知参数: " + option);
+        }
+    }
+    if (options.out_of_core && options.input.compare(0, 6, "quest:") == 0) {
+        throw std::invalid_argument("--out-of-core 需要数据文件，不能用于合成数据");
+    }
+    if (options.son && options.shards > 0) {
+        throw std::invalid_argument("--son 与 --shards 不能同时使用");
+    }
+    if (options.numa && options.shards == 0) {
+        throw std::invalid_argument("--numa 需要与 --shards 同时使用");
+    }
+    if (options.son || options.shards > 0) {
+        // 闭项集、最大项集不能由分区结果的并集得到
+        for (const auto& entry : MinerRegistry::instance().entries()) {
+            if (entry.kind != ItemsetKind::Frequent
+                && std::find(options.engines.begin(), options.engines.end(), entry.name) != options.engines.end()) {
+                throw std::invalid_argument(string(options.son ? "--son" : "--shards") + " 只能用于输出全部频繁项集的引擎: "
+                                            + entry.name);
+            }
+        }
+    }
+    if (options.format != OutputFormat::Count && options.format != OutputFormat::Auto && options.output == "-") {
+        throw std::invalid_argument("指定文本或二进制格式时需要 --output");
+    }
+    return options;
+}
+
+void printMineUsage(std::ostream& out, const char* program, const char* command) {
+    out << "用法: " << program << " " << command << " [参数]\n"
+        << "  -i, --input <文件>          数据文件（默认 retail.csv）\n"
+        << "  -d, --delimiter <字符>      分隔符，单个字符或 space/tab/comma（默认 space）\n"
+        << "  -e, --engine <名称[,名称]>  挖掘引擎，all 表示全部（默认 fptree）：";
+    for (const auto& entry : MinerRegistry::instance().entries()) {
+        out << " " << entry.name;
+    }
+    out << "\n"
+        << "  -s, --support <值>          小于1为相对支持度，大于等于1为绝对支持计数（默认 0.001）\n"
+        << "      --min-support <比例>    相对支持度 (0, 1]\n"
+        << "      --min-count <计数>      绝对支持计数\n"
+        << "  -t, --threads <数量>        线程数，0 为硬件并发数（默认 1）\n"
+        << "  -o, --output <文件|->       结果输出（默认 - 只统计数量）\n"
+        << "  -f, --format <格式>         text / binary / count（默认按输出文件后缀推断）\n"
+        << "  -m, --memory-budget <大小>  内存预算，如 512M、2G（默认不限制），预计超出时引擎切换到降级模式\n"
+        << "      --out-of-core           不载入数据集，流式读取文件（fptree / condfp 按投影数据库挖掘，也可与 --son / --shards 同用）\n"
+        << "      --spill-dir <目录>      降级模式写临时文件的目录（默认系统临时目录）\n"
+        << "      --son                   SON 分区挖掘：分区并行挖掘局部频繁项集，再扫描一遍统计全局支持计数\n"
+        << "      --partitions <数量>     SON 分区数（隐含 --son，默认按线程数和内存预算确定）\n"
+        << "      --shards <数量>         多进程分片挖掘：每个分片一个工作进程，协调进程汇总全局支持计数\n"
+        << "      --numa                  分片工作进程依次绑定到各 NUMA 节点的 CPU\n"
+        << "  -r, --repeat <次数>         每个引擎计时的次数（mine 默认 1，bench 默认 5）\n"
+        << "  -w, --warmup <次数>         计时前的预热次数（mine 默认 0，bench 默认 1）\n"
+        << "  -q, --quiet                 不输出加载和挖掘过程的日志\n"
+        << "      --json                  以 JSON 输出汇总到标准输出\n"
+        << "      --json-file <文件>      以 JSON 输出汇总到文件\n"
+        << "      --profile               打印各阶段计时器与热路径计数器的汇总表\n"
+        << "      --trace <文件>          导出 Chrome trace-event JSON（chrome://tracing 或 Perfetto 打开）\n"
+        << "      --perf                  按阶段统计硬件性能计数器（周期、指令、缓存 / 分支 / TLB 缺失）\n"
+        << "      --memory                按阶段统计 RSS 峰值，按数据结构统计内存占用\n";
+}
@@ -0,0 +1,105 @@
+#ifndef CLI_OPTIONS_HPP
+#define CLI_OPTIONS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * 结果输出格式
+ */
+enum class OutputFormat {
+    Auto,     // 按输出路径推断：- 为只统计，.bin 结尾为二进制，否则为文本
+    Text,     // 与 fptree_standard_results.txt 相同的文本格式
+    Binary,   // 二进制结果文件（result/result_file.hpp）
+    Count     // 只统计每个level的数量，不输出项集
+};
+
+/**
+ * 非交互式挖掘的全部参数（dig mine / dig bench 共用）
+ */
+struct MineOptions {
+    std::string input = "retail.csv";
+    char delimiter = ' ';
+    std::vector<std::string> engines = {"fptree"};
+    double support = 0.001;          // 相对支持度（0~1]，support_is_count 为 true 时为绝对支持计数
+    bool support_is_count = false;
+    int threads = 1;                 // 0 表示取硬件并发数
+    std::string output = "-";
+    OutputFormat format = OutputFormat::Auto;
+    size_t memory_budget = 0;        // 字节，0 表示不限制
+    bool out_of_core = false;        // 不载入数据集，流式读取文件并按投影数据库挖掘（仅 FP-Growth 引擎、--son 或 --shards）
+    std::string spill_dir;           // 内存预算不足时临时文件的目录，为空时使用系统临时目录
+    bool son = false;                // SON 分区挖掘：各分区用所选引擎挖掘，再统一计数候选
+    size_t partitions = 0;           // SON 分区数，0 表示按线程数和内存预算自动确定
+    size_t shards = 0;               // 多进程分片挖掘的工作进程数，0 表示在本进程内挖掘
+    bool numa = false;               // 分片工作进程依次绑定到各 NUMA 节点
+    int repeat = 1;                  // 计时次数
+    int warmup = 0;                  // 计时前的预热次数
+    bool quiet = false;              // 屏蔽加载和挖掘过程中的控制台输出
+    bool json = false;               // 以 JSON 输出汇总
+    std::string json_path;           // JSON 写入的文件，为空时写到标准输出
+    bool profile = false;            // 打印剖析汇总表（计时器与计数器）
+    std::string trace_path;          // Chrome trace-event JSON 输出文件，为空时不导出
+    bool perf = false;               // 按阶段统计 perf_event_open 性能计数器
+    bool memory = false;             // 按阶段和数据结构统计内存占用
+
+    /**
+     * 按事务总数换算最小支持计数
+     */
+    size_t minSupportCount(size_t transaction_count) const;
+
+    /**
+     * 实际使用的输出格式（解析 Auto）
+     */
+    OutputFormat resolvedFormat() const;
+
+    /**
+     * 引擎的结果输出路径：多个引擎时在扩展名前插入引擎名，如 out.bin -> out.fptree.bin
+     */
+    std::string outputPathFor(const std::string& engine) const;
+};
+
+/**
+ * 数据集参数（dig topk / sweep / support / serve 共用，取值与 dig mine 相同）
+ */
+struct InputOptions {
+    std::string input = "retail.csv";
+    char delimiter = ' ';
+    bool input_given = false;        // 是否给出了 -i/--input
+};
+
+/**
+ * 从 argv[first, argc) 中取出 -i/--input 与 -d/--delimiter（也可写作 --name=value），
+ * 其余参数按原来的顺序放入 positional
+ * @throws std::invalid_argument 缺少取值或分隔符格式错误
+ */
+InputOptions parseInputOptions(int argc, char** argv, int first, std::vector<std::string>& positional);
+
+/**
+ * 解析命令行参数 argv[first, argc)
+ * @param defaults 未给出的参数取这里的值（dig bench 的默认重复次数与 dig mine 不同）
+ * @throws std::invalid_argument 参数错误（消息说明原因）
+ */
+MineOptions parseMineOptions(int argc, char** argv, int first, const MineOptions& defaults = MineOptions());
+
+/**
+ * 打印参数说明
+ * @param command 子命令名（mine 或 bench）
+ */
+void printMineUsage(std::ostream& out, const char* program, const char* command);
+
+/**
+ * 解析字节数：支持 K/M/G 后缀（1024 进制），如 512M
+ * @throws std::invalid_argument 格式错误
+ */
+size_t parseByteSize(const std::string& text);
+
+/**
+ * 解析分隔符：单个字符，或 space / tab / comma / \t
+ * @throws std::invalid_argument 格式错误
+ */
+char parseDelimiter(const std::string& text);
+
+#endif // CLI_OPTIONS_HPP
@@ -0,0 +1,260 @@
+#include "charm.hpp"
+#include "miner/support.hpp"
+#include "miner/tidlist.hpp"
+#include "profile/profiler.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+Charm::Charm(const DataLoader& db, double min_support, int thread_count, ItemsetSink* sink)
+    : db_(db), min_support_(min_support), min_support_count_(0), thread_count_(thread_count), found_(0), sink_(sink) {
+
+    min_support_count_ = static_cast<int>(resolveSupportCount(min_support, db_.all_count));
+
+    cout << "\n========== CHARM 闭项集算法 ==========" << endl;
+    cout << "最小支持度: " << min_support_ << " (最小支持计数: " << min_support_count_ << ")" << endl;
+
+    auto begintime = std::chrono::high_resolution_clock::now();
+
+    // 频繁1项集按支持计数升序排列：支持计数小的项先处理，更容易触发合并和删除
+    const auto& inverted_index = db_.getInvertedIndex();
+    vector<Node> nodes;
+    for (size_t item = 0; item < inverted_index.size(); item++) {
+        if (inverted_index[item].size() >= static_cast<size_t>(min_support_count_)) {
+            Node node;
+            node.items.push_back(static_cast<int>(item));
+            node.tids = inverted_index[item];
+            nodes.push_back(std::move(node));
+        }
+    }
+    std::stable_sort(nodes.begin(), nodes.end(), [](const Node& a, const Node& b) {
+        return a.tids.size() < b.tids.size();
+    });
+    cout << "频繁1项集: " << nodes.size() << " 个" << endl;
+    MemoryCharge root_memory(MemoryCategory::TidLists, nodeBytes(nodes));
+
+    vector<CandidateSet> parts;
+    size_t workers = thread_count_ > 1 ? static_cast<size_t>(thread_count_) : 1;
+    if (workers == 1) {
+        parts.resize(1);
+        extendRoot(nodes, 0, nodes.size(), parts[0], false);
+    } else {
+        // 每个顶层项一个任务，块数由 parallelFor 决定，每块一个候选集合
+        size_t blocks = std::min(nodes.size(), workers * 4);
+        parts.resize(std::max<size_t>(blocks, 1));
+        size_t block_size = blocks > 0 ? (nodes.size() + blocks - 1) / blocks : 0;
+        parallelFor(parts.size(), workers, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; b++) {
+                size_t first = b * block_size;
+                size_t last = std::min(nodes.size(), first + block_size);
+                if (first < last) {
+                    extendRoot(nodes, first, last, parts[b], true);
+                }
+            }
+        });
+    }
+
+    MemoryCharge parts_memory;
+    if (MemoryTracker::enabled()) {
+        size_t bytes = 0;
+        for (const auto& part : parts) {
+            bytes += part.memoryBytes();
+        }
+        parts_memory.set(MemoryCategory::Results, bytes);
+    }
+    emitClosed(parts);
+
+    auto endtime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - begintime);
+    cout << "CHARM算法完成！共找到 " << found_ << " 个闭频繁项集，耗时: " << duration.count() << "ms" << endl;
+}
+
+void Charm::extend(vector<Node>& nodes, size_t first, size_t last, CandidateSet& out, bool shared) const {
+    vector<size_t> siblings;
+    for (size_t i = first; i < last; i++) {
+        if (nodes[i].removed) {
+            continue;
+        }
+        siblings.clear();
+        for (size_t j = i + 1; j < nodes.size(); j++) {
+            siblings.push_back(j);
+        }
+        extendNode(nodes, i, siblings, out, shared);
+    }
+}
+
+void Charm::extendRoot(vector<Node>& nodes, size_t first, size_t last, CandidateSet& out, bool shared) const {
+    ProfileScope scope("charm.extend_root");
+    // 顶层只和共现次数达标的兄弟求交
+    const auto& records = db_.getOriginalData();
+    vector<int> position(db_.getMaxValue() + 1, -1);
+    for (size_t k = 0; k < nodes.size(); k++) {
+        position[nodes[k].items[0]] = static_cast<int>(k);
+    }
+
+    vector<uint32_t> cooccur(nodes.size(), 0);
+    vector<size_t> siblings;
+    for (size_t i = first; i < last; i++) {
+        if (nodes[i].removed) {
+            continue;
+        }
+        cooccurringSiblings(records, nodes[i].tids, position, i, static_cast<size_t>(min_support_count_),
+                            cooccur, siblings);
+        extendNode(nodes, i, siblings, out, shared);
+    }
+}
+
+void Charm::extendNode(vector<Node>& nodes, size_t i, const vector<size_t>& siblings,
+                       CandidateSet& out, bool shared) const {
+    // Xi 的项集在本轮中会被扩充，复制一份；共享模式下其他任务也在读 nodes[i]
+    vector<int> xi_items = nodes[i].items;
+    const vector<int>& xi_tids = nodes[i].tids;
+
+    vector<int> tids;
+    vector<Node> children;
+    uint64_t pruned = 0;
+    for (size_t j : siblings) {
+        Node& xj = nodes[j];
+        if (xj.removed) {
+            continue;
+        }
+        if (!intersectTids(xi_tids, xj.tids, static_cast<size_t>(min_support_count_), tids)) {
+            pruned++;
+            continue;
+        }
+        bool covers_i = tids.size() == xi_tids.size();   // t(Xi) ⊆ t(Xj)
+        bool covers_j = tids.size() == xj.tids.size();   // t(Xj) ⊆ t(Xi)
+        if (covers_i) {
+            // Xj 出现在 Xi 的每条记录中：Xj 的项属于 Xi 的闭包
+            xi_items.insert(xi_items.end(), xj.items.begin(), xj.items.end());
+            if (covers_j && !shared) {
+                xj.removed = true;
+            }
+        } else {
+            if (covers_j && !shared) {
+                xj.removed = true;
+            }
+            Node child;
+            child.items = xj.items;
+            child.tids = tids;
+            Profiler::count(ProfileCounter::BytesAllocated, tids.size() * sizeof(int));
+            children.push_back(std::move(child));
+        }
+    }
+
+    Profiler::count(ProfileCounter::CandidatesGenerated, siblings.size());
+    Profiler::count(ProfileCounter::CandidatesPruned, pruned);
+
+    if (!children.empty()) {
+        // 子节点的项集 = Xi（最终扩充后的）∪ Xj
+        for (auto& child : children) {
+            child.items.insert(child.items.begin(), xi_items.begin(), xi_items.end());
+        }
+        std::stable_sort(children.begin(), children.end(), [](const Node& a, const Node& b) {
+            return a.tids.size() < b.tids.size();
+        });
+        MemoryCharge children_memory(MemoryCategory::TidLists, nodeBytes(children));
+        // 递归深度不超过最长闭项集的长度
+        extend(children, 0, children.size(), out, false);
+    }
+
+    out.add(std::move(xi_items), static_cast<uint32_t>(xi_tids.size()), tidHash(xi_tids));
+}
+
+size_t Charm::nodeBytes(const vector<Node>& nodes) {
+    if (!MemoryTracker::enabled()) {
+        return 0;
+    }
+    size_t bytes = nodes.capacity() * sizeof(Node);
+    for (const auto& node : nodes) {
+        bytes += (node.items.capacity() + node.tids.capacity()) * sizeof(int);
+    }
+    return bytes;
+}
+
+uint64_t Charm::tidHash(const vector<int>& tids) noexcept {
+    // 与顺序无关的集合哈希：每个tid先混合再求和
+    uint64_t hash = 0;
+    for (int tid : tids) {
+        uint64_t z = static_cast<uint64_t>(tid) + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        hash += z ^ (z >> 31);
+    }
+    return hash;
+}
+
+void Charm::CandidateSet::add(vector<int> itemset, uint32_t support, uint64_t tid_hash) {
+    std::sort(itemset.begin(), itemset.end());
+    itemset.erase(std::unique(itemset.begin(), itemset.end()), itemset.end());
+
+    auto& bucket = buckets[(tid_hash ^ support) & (buckets.size() - 1)];
+    for (uint32_t index : bucket) {
+        const Candidate& other = candidates[index];
+        if (other.support == support && other.tid_hash == tid_hash && other.length >= itemset.size() &&
+            std::includes(items.begin() + other.offset, items.begin() + other.offset + other.length,
+                          itemset.begin(), itemset.end())) {
+            return;
+        }
+    }
+    bucket.push_back(static_cast<uint32_t>(candidates.size()));
+    candidates.push_back(Candidate{items.size(), static_cast<uint32_t>(itemset.size()), support, tid_hash});
+    items.insert(items.end(), itemset.begin(), itemset.end());
+}
+
+void Charm::emitClosed(vector<CandidateSet>& parts) {
+    ProfileScope scope("charm.emit");
+    // 所有候选按 (支持计数, tid哈希, 长度降序) 排序，同组内只保留不被其他候选包含的项集
+    struct Ref {
+        const CandidateSet* part;
+        const Candidate* candidate;
+    };
+    vector<Ref> refs;
+    for (const auto& part : parts) {
+        for (const auto& candidate : part.candidates) {
+            refs.push_back(Ref{&part, &candidate});
+        }
+    }
+    std::sort(refs.begin(), refs.end(), [](const Ref& a, const Ref& b) {
+        if (a.candidate->support != b.candidate->support) return a.candidate->support < b.candidate->support;
+        if (a.candidate->tid_hash != b.candidate->tid_hash) return a.candidate->tid_hash < b.candidate->tid_hash;
+        return a.candidate->length > b.candidate->length;
+    });
+
+    SinkWriter writer(target());
+    vector<const Ref*> kept;
+    for (size_t begin = 0; begin < refs.size();) {
+        size_t end = begin + 1;
+        while (end < refs.size() && refs[end].candidate->support == refs[begin].candidate->support &&
+               refs[end].candidate->tid_hash == refs[begin].candidate->tid_hash) {
+            end++;
+        }
+
+        kept.clear();
+        for (size_t r = begin; r < end; r++) {
+            const int* items = refs[r].part->items.data() + refs[r].candidate->offset;
+            uint32_t length = refs[r].candidate->length;
+            bool subsumed = false;
+            for (const Ref* other : kept) {
+                const int* other_items = other->part->items.data() + other->candidate->offset;
+                if (std::includes(other_items, other_items + other->candidate->length, items, items + length)) {
+                    subsumed = true;
+                    break;
+                }
+            }
+            if (!subsumed) {
+                kept.push_back(&refs[r]);
+                writer.emit(items, length, refs[r].candidate->support);
+            }
+        }
+        begin = end;
+    }
+    writer.flush();
+    found_ += writer.emittedCount();
+}
@@ -0,0 +1,121 @@
+#ifndef CHARM_HPP
+#define CHARM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "profile/memory.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+
+/**
+ * 闭频繁项集挖掘引擎（CHARM）
+ * 直接使用 DataLoader 倒排索引中的 tid 列表做垂直求交，在项集-tid集合树上搜索：
+ *   t(Xi) == t(Xj)：Xj 并入 Xi 并从兄弟中删除
+ *   t(Xi) ⊂ t(Xj)：Xj 并入 Xi
+ *   t(Xi) ⊃ t(Xj)：Xj 从兄弟中删除，Xi ∪ Xj 作为子节点
+ *   否则：Xi ∪ Xj 作为子节点
+ * 闭包检查使用包含哈希：按 (支持计数, tid集合哈希) 分组，组内被支持计数相同的超集包含的项集不是闭的。
+ * 求交见 miner/tidlist.hpp。多线程时顶层项分块并行，各块先在本地过滤，最后全局再做一次包含检查。
+ */
+class Charm {
+public:
+    /**
+     * 构造函数：挖掘闭频繁项集
+     * @param db 数据加载器
+     * @param min_support 最小支持度（小于1为相对支持度，大于等于1为绝对支持计数）
+     * @param thread_count 挖掘线程数，小于等于1时在当前线程串行挖掘
+     * @param sink 结果接收端，为空时结果收集在内存中，可通过 getClosedItemsets 获取
+     */
+    Charm(const DataLoader& db, double min_support, int thread_count = 0, ItemsetSink* sink = nullptr);
+
+    /**
+     * 获取所有闭频繁项集（按level组织，附带支持计数），指定了外部接收端时为空
+     */
+    const ItemsetPool& getClosedItemsets() const {
+        return collected_.itemsets();
+    }
+
+private:
+    // 搜索树节点：项集及其tid集合
+    struct Node {
+        std::vector<int> items;
+        std::vector<int> tids;
+        bool removed = false;
+    };
+
+    // 闭项集候选：项集（升序）在 items 中的位置、支持计数、tid集合哈希
+    struct Candidate {
+        size_t offset;
+        uint32_t length;
+        uint32_t support;
+        uint64_t tid_hash;
+    };
+
+    // 一个任务找到的闭项集候选，带本地包含检查
+    struct CandidateSet {
+        std::vector<int> items;
+        std::vector<Candidate> candidates;
+        std::vector<std::vector<uint32_t>> buckets;   // (支持计数, tid哈希) 的哈希桶 -> 候选下标
+
+        CandidateSet() : buckets(1 << 12) {}
+
+        /**
+         * 加入候选，已被支持计数相同的超集包含时丢弃
+         */
+        void add(std::vector<int> itemset, uint32_t support, uint64_t tid_hash);
+
+        /**
+         * 占用的堆内存字节数
+         */
+        size_t memoryBytes() const noexcept {
+            return items.capacity() * sizeof(int) + candidates.capacity() * sizeof(Candidate) + nestedVectorBytes(buckets);
+        }
+    };
+
+    const DataLoader& db_;
+    double min_support_;
+    int min_support_count_;
+    int thread_count_;
+    size_t found_;
+
+    ItemsetSink* sink_;
+    CollectSink collected_;
+
+    ItemsetSink& target() {
+        return sink_ != nullptr ? *sink_ : collected_;
+    }
+
+    /**
+     * 展开 nodes[first, last) 这些节点（nodes 为同一父节点下按支持计数升序排列的兄弟）
+     * @param shared 兄弟节点被多个任务共享（并行的顶层）：不修改兄弟，冗余的候选留给全局包含检查去掉
+     */
+    void extend(std::vector<Node>& nodes, size_t first, size_t last, CandidateSet& out, bool shared) const;
+
+    /**
+     * 展开顶层节点（单个项）：先用水平数据统计共现次数，只与共现次数达标的兄弟求交
+     * （顶层两两求交的次数是频繁项数的平方级，绝大多数交集为空）
+     */
+    void extendRoot(std::vector<Node>& nodes, size_t first, size_t last, CandidateSet& out, bool shared) const;
+
+    /**
+     * 展开节点 nodes[i]：与 siblings 中的兄弟逐个求交，递归展开子节点后把 Xi 加入候选
+     */
+    void extendNode(std::vector<Node>& nodes, size_t i, const std::vector<size_t>& siblings,
+                    CandidateSet& out, bool shared) const;
+
+    /**
+     * 全局包含检查并输出闭项集
+     */
+    void emitClosed(std::vector<CandidateSet>& parts);
+
+    static uint64_t tidHash(const std::vector<int>& tids) noexcept;
+
+    /**
+     * 一组节点的项集和 tid 列表占用的字节数（未启用内存统计时返回 0，不遍历）
+     */
+    static size_t nodeBytes(const std::vector<Node>& nodes);
+};
+
+#endif // CHARM_HPP
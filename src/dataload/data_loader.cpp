@@ -1,5 +1,6 @@
 #include "data_loader.hpp"
 #include "threadsignal.hpp"
+#include "profile/profiler.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -10,6 +11,7 @@
 #include <mutex>
 #include <future>
 #include <algorithm>
+#include <chrono>
 
 using std::vector;
 using std::string;
@@ -25,13 +27,21 @@ using std::lock_guard;
 //硬件限制数量
 const int  hard_thread = std::thread::hardware_concurrency();
 
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
 DataLoader::DataLoader(const std::string& filename, char delimiter, int thread_count) 
-    : max_record_size_(0), max_num_of_record(0), record_count_(0) {
+    : record_count_(0), max_record_size_(0), max_num_of_record(0) {
     
     cout << "正在加载csv数据文件到内存: " << filename << "..." << endl;
     
     // 第一阶段：串行读取所有行到内存
+    auto phase_start = Clock::now();
     vector<string> rawLines=baseLoad(filename);
+    timings_.read_ms = elapsedMs(phase_start);
     
     cout << "文件读取完成，共 " << rawLines.size() << " 行数据" << endl;
     
@@ -39,7 +49,9 @@ DataLoader::DataLoader(const std::string& filename, char delimiter, int thread_c
     records_.resize(rawLines.size());
     
     // 第二阶段：并发解析数据
+    phase_start = Clock::now();
     parseLinesConcurrently(rawLines, delimiter, thread_count);
+    timings_.parse_ms = elapsedMs(phase_start);
     
     
     record_count_ = records_.size();
@@ -49,16 +61,51 @@ DataLoader::DataLoader(const std::string& filename, char delimiter, int thread_c
     
     // 转换为倒排索引
     cout << "正在转换为倒排索引..." << endl;
+    phase_start = Clock::now();
     convertToInvertedIndex(thread_count);
+    timings_.index_ms = elapsedMs(phase_start);
+    accountMemory();
     
     // 保留原始数据，供FP-Tree等算法使用
     cout << "倒排索引转换完成，原始数据已保留！" << endl;
 }
 
+DataLoader::DataLoader(Database records, int thread_count)
+    : records_(std::move(records)), record_count_(0), max_record_size_(0), max_num_of_record(0) {
+    
+    // 记录已在内存中，没有读取阶段；统计最大记录长度和最大元素值记为解析阶段
+    auto phase_start = Clock::now();
+    for (const auto& record : records_) {
+        if (record.size() > max_record_size_) {
+            max_record_size_ = record.size();
+        }
+        for (int num : record) {
+            if (num > max_num_of_record) {
+                max_num_of_record = num;
+            }
+        }
+    }
+    record_count_ = records_.size();
+    all_count = record_count_;
+    timings_.parse_ms = elapsedMs(phase_start);
+    
+    phase_start = Clock::now();
+    convertToInvertedIndex(thread_count);
+    timings_.index_ms = elapsedMs(phase_start);
+    accountMemory();
+}
+
 DataLoader::~DataLoader() {
     // 析构函数：自动释放所有数据
 }
 
+void DataLoader::accountMemory() {
+    if (MemoryTracker::enabled()) {
+        records_memory_.set(MemoryCategory::Records, nestedVectorBytes(records_));
+        index_memory_.set(MemoryCategory::InvertedIndex, nestedVectorBytes(inverted_index_));
+    }
+}
+
 std::vector<std::string> DataLoader::readAllLines(const std::string& filename) {
     vector<string> rawLines;
     ifstream file(filename);
@@ -78,6 +125,7 @@ std::vector<std::string> DataLoader::readAllLines(const std::string& filename) {
 }
 
 void DataLoader::parseLinesConcurrently(const vector<string>& rawLines, char delimiter, int thread_count) {
+    ProfileScope scope("load.parse");
     size_t totalLines = rawLines.size();
 
     size_t numThreads = thread_count > 0 ? thread_count: hard_thread;
@@ -202,6 +250,13 @@ void DataLoader::buildInvertedIndexConcurrently(size_t thread_count) {
         recordsPerThread = 1;
     }
     
+    // 单线程时直接在当前线程构建：可能本身就在线程池的任务中（如并行挖掘投影数据库），不能再等待线程池
+    if (numThreads == 1) {
+        mutex indexMutex;
+        buildInvertedIndexRange(0, totalRecords, indexMutex);
+        return;
+    }
+    
     // 获取线程池实例
     auto& tpool = getThreadPool(thread_count > 0 ? static_cast<size_t>(thread_count) : 0);
     
@@ -274,6 +329,7 @@ void DataLoader::sortInvertedIndex() {
 }
 
 void DataLoader::convertToInvertedIndex(int thread_count) {
+    ProfileScope scope("load.index");
     // 初始化倒排索引大小
     initializeInvertedIndex();
     
@@ -289,7 +345,11 @@ void DataLoader::convertToInvertedIndex(int thread_count) {
 }
 
 vector<string> DataLoader::baseLoad(string file_name) {
+    ProfileScope scope("load.read");
     ifstream file(file_name);
+    if (!file.is_open()) {
+        throw std::runtime_error("无法打开文件: " + file_name);
+    }
     string line;
     vector<string> lines;
     
@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <mutex>
+#include "profile/memory.hpp"
 
 /**
  * 数据加载器类
@@ -22,6 +23,13 @@ public:
     // 倒排索引类型：元素值 -> 包含该元素的记录索引列表
     using InvertedIndex = std::vector<std::vector<int>>;
 
+    // 构造过程中各阶段的耗时（毫秒）
+    struct LoadTimings {
+        double read_ms = 0;    // 读取文件所有行
+        double parse_ms = 0;   // 并发解析为记录
+        double index_ms = 0;   // 构建倒排索引
+    };
+
     size_t all_count=0;
     
     /**
@@ -32,6 +40,13 @@ public:
      */
     DataLoader(const std::string& filename, char delimiter = ' ', int thread_count = 0);
     
+    /**
+     * 构造函数：直接使用内存中的记录（如合成数据）并转换为倒排索引
+     * @param records 所有记录，元素为非负整数
+     * @param thread_count 并发转换的线程数，默认为0（使用默认线程数）
+     */
+    explicit DataLoader(Database records, int thread_count = 0);
+    
     /**
      * 析构函数
      */
@@ -55,6 +70,20 @@ public:
         return record_count_;
     }
     
+    /**
+     * 构造过程中读取、解析、建索引各阶段的耗时
+     */
+    const LoadTimings& getLoadTimings() const noexcept {
+        return timings_;
+    }
+    
+    /**
+     * 原始记录和倒排索引占用的字节数（按容量计算）
+     */
+    size_t datasetBytes() const {
+        return nestedVectorBytes(records_) + nestedVectorBytes(inverted_index_);
+    }
+    
     /**
      * 通过元素值获取包含该元素的所有记录索引
      * @param element 元素值
@@ -130,6 +159,14 @@ public:
         return records_[index];
     }
 
+    /**
+     * 解析单行数据
+     * @param line 单行字符串
+     * @param delimiter 分隔符
+     * @return 解析后的记录
+     */
+    static Record parseLine(const std::string& line, char delimiter);
+
 private:
     /**
      * 读取文件所有行到内存
@@ -159,14 +196,6 @@ private:
                         size_t startIdx, size_t endIdx, char delimiter,
                         size_t& localMaxRecordSize, int& localMaxNum);
     
-    /**
-     * 解析单行数据
-     * @param line 单行字符串
-     * @param delimiter 分隔符
-     * @return 解析后的记录
-     */
-    Record parseLine(const std::string& line, char delimiter);
-    
     /**
      * 合并线程统计信息
      * @param threadMaxRecordSizes 线程最大记录长度
@@ -205,6 +234,11 @@ private:
      */
     void sortInvertedIndex();
     
+    /**
+     * 按当前容量登记原始记录和倒排索引占用的内存
+     */
+    void accountMemory();
+    
     /**
      * 将磁盘数据转化为字符串数组
      * @param file_name 文件名
@@ -217,6 +251,9 @@ private:
     size_t record_count_;           // 记录总数（转换前保存）
     size_t max_record_size_;        // 最大记录长度（单条记录中元素最多的）
     int max_num_of_record;          // 记录中的最大数字
+    LoadTimings timings_;           // 各阶段耗时
+    MemoryCharge records_memory_;   // 原始记录的内存登记
+    MemoryCharge index_memory_;     // 倒排索引的内存登记
 };
 
 #endif // DATA_LOADER_HPP
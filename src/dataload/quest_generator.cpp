@@ -0,0 +1,204 @@
+#include "quest_generator.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// 由种子和流编号派生互不相关的随机数种子（splitmix64）
+uint64_t mixSeed(uint64_t seed, uint64_t stream) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL * (stream + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+double parseValue(const string& key, const string& text) {
+    size_t pos = 0;
+    double value = 0;
+    try {
+        value = std::stod(text, &pos);
+    } catch (const std::exception&) {
+        pos = 0;
+    }
+    if (pos == 0 || pos != text.size() || value < 0) {
+        throw std::invalid_argument("合成数据参数 " + key + " 的值无效: " + text);
+    }
+    return value;
+}
+
+} // namespace
+
+QuestParams QuestParams::parse(const string& spec) {
+    QuestParams params;
+    string normalized = spec;
+    std::replace(normalized.begin(), normalized.end(), ',', ' ');
+    std::stringstream tokens(normalized);
+    for (string token; tokens >> token;) {
+        size_t eq = token.find('=');
+        if (eq == string::npos) {
+            throw std::invalid_argument("合成数据参数应为 key=value: " + token);
+        }
+        string key = token.substr(0, eq);
+        double value = parseValue(key, token.substr(eq + 1));
+        if (key == "transactions") params.transactions = static_cast<size_t>(value);
+        else if (key == "avg-length") params.avg_length = value;
+        else if (key == "items") params.items = static_cast<int>(value);
+        else if (key == "patterns") params.patterns = static_cast<size_t>(value);
+        else if (key == "pattern-length") params.pattern_length = value;
+        else if (key == "correlation") params.correlation = value;
+        else if (key == "corruption") params.corruption = value;
+        else if (key == "seed") params.seed = static_cast<uint64_t>(value);
+        else throw std::invalid_argument("未知的合成数据参数: " + key);
+    }
+    if (params.items <= 0 || params.patterns == 0 || params.avg_length <= 0 || params.pattern_length <= 0) {
+        throw std::invalid_argument("items、patterns、avg-length、pattern-length 必须大于0");
+    }
+    if (params.corruption < 0 || params.corruption >= 1) {
+        throw std::invalid_argument("corruption 必须在 [0, 1) 之间");
+    }
+    return params;
+}
+
+QuestGenerator::QuestGenerator(const QuestParams& params) : params_(params) {
+    // 模式表很小，串行生成，只依赖种子
+    std::mt19937_64 rng(mixSeed(params_.seed, ~0ULL));
+    std::poisson_distribution<int> length_dist(std::max(params_.pattern_length - 1, 0.0));
+    std::exponential_distribution<double> correlation_dist(params_.correlation > 0 ? 1.0 / params_.correlation : 1e9);
+    std::exponential_distribution<double> weight_dist(1.0);
+    std::normal_distribution<double> corruption_dist(params_.corruption, 0.1);
+    std::uniform_int_distribution<int> item_dist(0, params_.items - 1);
+
+    patterns_.resize(params_.patterns);
+    cumulative_weight_.resize(params_.patterns);
+    corruption_.resize(params_.patterns);
+    double total_weight = 0;
+    for (size_t p = 0; p < params_.patterns; p++) {
+        // 长度 = 1 + 泊松(|I|-1)，至少为1且不超过项的总数
+        size_t length = std::min<size_t>(1 + length_dist(rng), static_cast<size_t>(params_.items));
+        vector<int>& pattern = patterns_[p];
+        if (p > 0) {
+            // 一部分项取自上一个模式，比例服从均值为 correlation 的指数分布
+            const vector<int>& previous = patterns_[p - 1];
+            double fraction = std::min(1.0, correlation_dist(rng));
+            size_t shared = std::min(previous.size(), static_cast<size_t>(fraction * length + 0.5));
+            vector<int> pool = previous;
+            std::shuffle(pool.begin(), pool.end(), rng);
+            pattern.assign(pool.begin(), pool.begin() + shared);
+        }
+        while (pattern.size() < length) {
+            int item = item_dist(rng);
+            if (std::find(pattern.begin(), pattern.end(), item) == pattern.end()) {
+                pattern.push_back(item);
+            }
+        }
+        total_weight += weight_dist(rng);
+        cumulative_weight_[p] = total_weight;
+        corruption_[p] = std::clamp(corruption_dist(rng), 0.0, 1.0);
+    }
+    for (double& weight : cumulative_weight_) {
+        weight /= total_weight;
+    }
+}
+
+void QuestGenerator::generateBlock(size_t block, DataLoader::Record* out, size_t count) const {
+    std::mt19937_64 rng(mixSeed(params_.seed, block));
+    std::poisson_distribution<int> length_dist(std::max(params_.avg_length - 1, 0.0));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    vector<int> carried;   // 上一个事务放不下、留给这个事务的模式
+    vector<int> picked;
+    for (size_t t = 0; t < count; t++) {
+        DataLoader::Record& record = out[t];
+        record.clear();
+        size_t length = 1 + length_dist(rng);
+        while (record.size() < length) {
+            if (!carried.empty()) {
+                picked.swap(carried);
+                carried.clear();
+            } else {
+                double r = uniform(rng);
+                size_t p = std::lower_bound(cumulative_weight_.begin(), cumulative_weight_.end(), r) - cumulative_weight_.begin();
+                p = std::min(p, patterns_.size() - 1);
+                // 放入事务前随机丢项：只要均匀随机数小于损坏程度就丢掉一个，至少保留一项
+                // （损坏程度可能恰好为1，全部丢光后重抽会永远抽不到非空的模式）
+                picked = patterns_[p];
+                while (picked.size() > 1 && uniform(rng) < corruption_[p]) {
+                    picked.erase(picked.begin() + static_cast<size_t>(uniform(rng) * picked.size()) % picked.size());
+                }
+            }
+            if (!record.empty() && record.size() + picked.size() > length) {
+                // 放不下：一半概率仍然放入，否则留给下一个事务
+                if (uniform(rng) < 0.5) {
+                    record.insert(record.end(), picked.begin(), picked.end());
+                } else {
+                    carried.swap(picked);
+                }
+                break;
+            }
+            record.insert(record.end(), picked.begin(), picked.end());
+        }
+        std::sort(record.begin(), record.end());
+        record.erase(std::unique(record.begin(), record.end()), record.end());
+    }
+}
+
+DataLoader::Database QuestGenerator::generate(int thread_count) const {
+    DataLoader::Database records(params_.transactions);
+    size_t blocks = (params_.transactions + kBlockSize - 1) / kBlockSize;
+    parallelFor(blocks, resolveThreadCount(thread_count), 1, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            size_t first = b * kBlockSize;
+            generateBlock(b, records.data() + first, std::min(kBlockSize, params_.transactions - first));
+        }
+    });
+    return records;
+}
+
+void QuestGenerator::writeCsv(const string& path, char delimiter, int thread_count) const {
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("无法写入文件: " + path);
+    }
+    size_t threads = resolveThreadCount(thread_count);
+    size_t blocks = (params_.transactions + kBlockSize - 1) / kBlockSize;
+    // 每批生成若干块并格式化为文本，再按块号顺序写出
+    size_t batch = threads * 4;
+    vector<string> texts(batch);
+    for (size_t base = 0; base < blocks; base += batch) {
+        size_t count = std::min(batch, blocks - base);
+        parallelFor(count, threads, 1, [&](size_t begin, size_t end) {
+            DataLoader::Database records(kBlockSize);
+            for (size_t i = begin; i < end; i++) {
+                size_t b = base + i;
+                size_t first = b * kBlockSize;
+                size_t n = std::min(kBlockSize, params_.transactions - first);
+                generateBlock(b, records.data(), n);
+                string& text = texts[i];
+                text.clear();
+                char number[16];
+                for (size_t t = 0; t < n; t++) {
+                    for (size_t k = 0; k < records[t].size(); k++) {
+                        if (k > 0) text.push_back(delimiter);
+                        int length = std::snprintf(number, sizeof(number), "%d", records[t][k]);
+                        text.append(number, static_cast<size_t>(length));
+                    }
+                    text.push_back('\n');
+                }
+            }
+        });
+        for (size_t i = 0; i < count; i++) {
+            file.write(texts[i].data(), static_cast<std::streamsize>(texts[i].size()));
+        }
+    }
+    if (!file) {
+        throw std::runtime_error("写入文件失败: " + path);
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef QUEST_GENERATOR_HPP
+#define QUEST_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "data_loader.hpp"
+
+/**
+ * 合成数据参数（IBM Quest 生成器的约定）
+ */
+struct QuestParams {
+    size_t transactions = 100000;   // 事务数 |D|
+    double avg_length = 10;         // 平均事务长度 |T|（泊松分布）
+    int items = 1000;               // 项的个数 N，项编号为 0 ~ N-1
+    size_t patterns = 2000;         // 潜在频繁模式个数 |L|
+    double pattern_length = 4;      // 模式平均长度 |I|（泊松分布）
+    double correlation = 0.5;       // 相邻模式共享项的比例的均值（指数分布）
+    double corruption = 0.5;        // 模式放入事务时丢弃项的概率的均值（正态分布，标准差0.1），取值 [0, 1)，每个模式至少保留一项
+    uint64_t seed = 1;              // 随机种子：相同参数和种子生成完全相同的数据，与线程数无关
+
+    /**
+     * 解析 key=value 列表（逗号或空格分隔），如 transactions=1000000,avg-length=10
+     * 键：transactions、avg-length、items、patterns、pattern-length、correlation、corruption、seed
+     * @throws std::invalid_argument 未知的键或无效的值
+     */
+    static QuestParams parse(const std::string& spec);
+};
+
+/**
+ * IBM Quest 风格的合成事务数据生成器（Agrawal & Srikant 1994）
+ * 先生成 |L| 个带权重的潜在频繁模式，相邻模式按 correlation 共享一部分项；
+ * 每个事务的长度服从泊松分布，按权重挑选模式（每个模式按自己的损坏程度随机丢掉一些项）填入，
+ * 放不下的模式一半概率仍然放入，否则留给下一个事务。
+ * 事务按固定大小分块，每块使用由种子和块号派生的独立随机数序列，可以并行生成且结果与线程数无关。
+ */
+class QuestGenerator {
+public:
+    explicit QuestGenerator(const QuestParams& params);
+
+    /**
+     * 生成全部事务到内存（每个事务的项升序、不重复）
+     */
+    DataLoader::Database generate(int thread_count = 0) const;
+
+    /**
+     * 生成全部事务写入 DataLoader 可读取的文本文件（每行一个事务），按批并行生成、顺序写出，内存占用与事务总数无关
+     * @throws std::runtime_error 无法写入文件
+     */
+    void writeCsv(const std::string& path, char delimiter = ' ', int thread_count = 0) const;
+
+    const QuestParams& params() const noexcept {
+        return params_;
+    }
+
+private:
+    // 每块的事务数
+    static constexpr size_t kBlockSize = 16384;
+
+    /**
+     * 生成第 block 块的事务到 out[0, count)
+     */
+    void generateBlock(size_t block, DataLoader::Record* out, size_t count) const;
+
+    QuestParams params_;
+    std::vector<std::vector<int>> patterns_;   // 潜在频繁模式
+    std::vector<double> cumulative_weight_;    // 模式权重的前缀和（归一化到1）
+    std::vector<double> corruption_;           // 每个模式的损坏程度
+};
+
+#endif // QUEST_GENERATOR_HPP
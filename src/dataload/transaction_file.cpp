@@ -0,0 +1,23 @@
+#include "transaction_file.hpp"
+#include <algorithm>
+
+TransactionFile::TransactionFile(const std::string& path, char delimiter) : path_(path), delimiter_(delimiter) {
+    std::vector<size_t> last_seen;
+    forEach([this, &last_seen](const DataLoader::Record& record) {
+        for (int item : record) {
+            if (item < 0) {
+                continue;
+            }
+            max_item_ = std::max(max_item_, item);
+            if (static_cast<size_t>(item) >= supports_.size()) {
+                supports_.resize(item + 1, 0);
+                last_seen.resize(item + 1, static_cast<size_t>(-1));
+            }
+            if (last_seen[item] != transactions_) {
+                last_seen[item] = transactions_;
+                supports_[item]++;
+            }
+        }
+        transactions_++;
+    });
+}
@@ -0,0 +1,70 @@
+#ifndef TRANSACTION_FILE_HPP
+#define TRANSACTION_FILE_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "data_loader.hpp"
+
+/**
+ * 按行流式读取的事务文件：不把数据载入内存，可以多次顺序扫描（外存挖掘使用）
+ * 格式与 DataLoader 相同，每行一条事务
+ */
+class TransactionFile {
+public:
+    /**
+     * 打开文件并扫描一遍，统计事务数、最大元素值和各项的支持计数
+     * @throws std::runtime_error 文件无法打开
+     */
+    TransactionFile(const std::string& path, char delimiter = ' ');
+
+    const std::string& path() const noexcept {
+        return path_;
+    }
+
+    char delimiter() const noexcept {
+        return delimiter_;
+    }
+
+    size_t transactionCount() const noexcept {
+        return transactions_;
+    }
+
+    int maxItem() const noexcept {
+        return max_item_;
+    }
+
+    /**
+     * 各项的支持计数（同一事务中重复的项只计一次），下标为项
+     */
+    const std::vector<size_t>& itemSupports() const noexcept {
+        return supports_;
+    }
+
+    /**
+     * 从头顺序读取每条事务，调用 fn(const DataLoader::Record&)
+     * @throws std::runtime_error 文件无法打开
+     */
+    template <typename F>
+    void forEach(F&& fn) const {
+        std::ifstream file(path_);
+        if (!file.is_open()) {
+            throw std::runtime_error("无法打开文件: " + path_);
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            fn(DataLoader::parseLine(line, delimiter_));
+        }
+    }
+
+private:
+    std::string path_;
+    char delimiter_;
+    size_t transactions_ = 0;
+    int max_item_ = 0;
+    std::vector<size_t> supports_;
+};
+
+#endif // TRANSACTION_FILE_HPP
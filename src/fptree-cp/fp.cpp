@@ -1,32 +1,35 @@
 #include "fp.hpp"
+#include "threadsignal.hpp"
+#include "miner/support.hpp"
+#include "profile/profiler.hpp"
+#include "fptree/projected_db.hpp"
+#include "sched/parallel_for.hpp"
+#include "sched/work_stealing.hpp"
 #include <cstddef>
 #include <iostream>
 #include <algorithm>
-#include <unordered_map>
-#include <unordered_set>
-#include <queue>
+#include <numeric>
 #include <utility>
 #include <vector>
+#include <chrono>
+#include <cmath>
 
 using std::cout;
 using std::endl;
 using std::vector;
 using std::pair;
-using std::unordered_map;
-using std::unordered_set;
 using std::sort;
+using std::shared_ptr;
+using std::make_shared;
 
-FPTree::FPTree(const DataLoader& db, double min_support)
-    : db_(db), min_support_(min_support), root_(nullptr), min_support_count_(0) {
-    // 计算最小支持计数（绝对数量）
-    min_support_count_ = static_cast<int>(min_support * db_.all_count);
-    if (min_support_count_ < 1) min_support_count_ = 1;
+CondFPTree::CondFPTree(const DataLoader& db, double min_support, int thread_count, ItemsetSink* sink)
+    : db_(db), min_support_(min_support), min_support_count_(0), thread_count_(thread_count), found_(0), sink_(sink) {
 
-    levels.reserve(10);
+    min_support_count_ = static_cast<int>(resolveSupportCount(min_support, db_.all_count));
 
-    cout << "\n========== FP-Tree 算法 ==========" << endl;
+    cout << "\n========== 条件FP-Tree 算法 ==========" << endl;
     cout << "最小支持度: " << min_support_ << " (最小支持计数: " << min_support_count_ << ")" << endl;
-    
+
     // 步骤1: 计算频繁1项集并排序
     cout << "\n步骤1: 计算频繁1项集并排序..." << endl;
     auto frequent_items = getFrequent1Itemsets();
@@ -36,347 +39,307 @@ FPTree::FPTree(const DataLoader& db, double min_support)
         cout << "没有频繁项集，算法结束" << endl;
         return;
     }
-    
-    // 步骤2: 构建FP-Tree（直接使用原始数据，按排序后的频繁项顺序构建）
+
+    // 步骤2: 构建全局FP-Tree
     cout << "\n步骤2: 构建FP-Tree..." << endl;
     buildTree(frequent_items);
-    
-    
-    // 步骤3: 使用索引系统挖掘频繁项集
-    cout << "\n步骤3: 挖掘频繁项集..." << endl;
-    
-    // 首先记录所有频繁1项集
-    if (levels.empty()) {
-        levels.resize(10);  // 预分配空间，避免越界
-    }
-    for(const auto& [item, count] : frequent_items){
-        levels[0].insert({item});
-    }
 
+    // 步骤3: 逐层构建条件FP-Tree挖掘频繁项集
+    cout << "\n步骤3: 挖掘频繁项集..." << endl;
     check();
 
-    // 统计总数量
-    size_t total_count = 0;
-    for (const auto& level : levels) {
-        total_count += level.size();
-    }
-    cout << "\nFP-Tree算法完成！共找到 " << total_count << " 个频繁项集" << endl;
+    cout << "\n条件FP-Tree算法完成！共找到 " << found_ << " 个频繁项集" << endl;
 }
 
-FPTree::~FPTree() {
-    if (root_) {
-        destroyTree(root_);
-    }
+CondFPTree::~CondFPTree() {
 }
 
+size_t CondFPTree::estimateMemory(const FrequentOccurrence& occurrence, int thread_count) {
+    // 全局树的节点数不超过频繁项的出现次数，另有构建时的序号序列
+    size_t tree = occurrence.occurrences * (sizeof(FPNode) + sizeof(int)) + occurrence.transactions * sizeof(uint32_t);
+    // 每个线程同时持有的条件树和条件模式基都不超过全局树的规模
+    size_t conditional = occurrence.occurrences * (sizeof(FPNode) + 3 * sizeof(int)) * resolveThreadCount(thread_count);
+    return tree + conditional;
+}
 
-vector<pair<int,const std::vector<int>* >> FPTree::getFrequent1Itemsets() {
-    
+vector<pair<int, const std::vector<int>*>> CondFPTree::getFrequent1Itemsets() {
     const auto& inverted_index = db_.getInvertedIndex();
-    
-    vector<pair<int,const std::vector<int>* >> frequent_items;
-    for(int i=0;i<inverted_index.size();i++){
-        if(inverted_index[i].size() < min_support_count_){
+
+    vector<pair<int, const std::vector<int>*>> frequent_items;
+    for(size_t i = 0; i < inverted_index.size(); i++){
+        if(inverted_index[i].size() < static_cast<size_t>(min_support_count_)){
             continue;
         }
-
-        frequent_items.emplace_back(i, &inverted_index[i]);
+        frequent_items.emplace_back(static_cast<int>(i), &inverted_index[i]);
     }
 
+    // 按支持度降序排序，支持度相同时按项值升序，保证树的形状确定
     sort(frequent_items.begin(), frequent_items.end(),
-    [](const pair<int,const std::vector<int>*>& a, const pair<int,const std::vector<int>*>& b) {
-        return a.second->size() > b.second->size();
+    [](const pair<int, const std::vector<int>*>& a, const pair<int, const std::vector<int>*>& b) {
+        if (a.second->size() != b.second->size()) {
+            return a.second->size() > b.second->size();
+        }
+        return a.first < b.first;
     });
 
     return frequent_items;
 }
 
-void FPTree::buildTree(const vector<pair<int, const std::vector<int>*>> frequent_items) {
+void CondFPTree::buildTree(const vector<pair<int, const std::vector<int>*>>& frequent_items) {
+    ProfileScope scope("condfp.build");
     auto begintime = std::chrono::high_resolution_clock::now();
 
-    // 创建根节点
-    root_ = new FPNode{-1, 0};
-
-    //原始数据
-    auto len = db_.getOriginalData().size();
-
-    //动态指针追踪
-    vector<FPNode*> nodes(len, root_);
-
-    for(const auto& item : frequent_items){
-        auto index = item.first;
-        auto& records = *item.second;
-
-        // 用于追踪已记录的节点，避免重复记录条件模式基
-        auto recorded_nodes = std::unordered_set<FPNode*>();
-
-        for(const auto& record : records){
-            auto& node = nodes[record];
-            
-            auto get = node->children.find(index);
-
-            if(get == node->children.end()){
-                auto new_node = new FPNode{index, 1};
-                node->children[index] = new_node;
-                nodes[record] = new_node;
-                
-                // 记录条件模式基：记录新创建的节点（用于后续提取从根到父节点的路径）
-                // 使用节点指针作为key来避免重复记录相同的节点
-                if(recorded_nodes.find(new_node) == recorded_nodes.end()){
-                    recorded_nodes.insert(new_node);
-                }
-                continue;
-            }
+    auto tree = make_shared<Tree>();
 
-            get->second->count++;
-            nodes[record] = get->second;
+    // 原始项 -> 频繁项序号（即全局树中的局部编号）
+    vector<int> rank(db_.getMaxValue() + 1, -1);
+    for(size_t r = 0; r < frequent_items.size(); r++){
+        rank[frequent_items[r].first] = static_cast<int>(r);
+        tree->items.push_back(frequent_items[r].first);
+        tree->supports.push_back(static_cast<int>(frequent_items[r].second->size()));
+    }
+
+    // 每条记录映射为升序的频繁项序号序列
+    vector<int> seq_items;
+    vector<uint32_t> seq_ends;
+    vector<int> seq_counts;
+    for(const auto& record : db_.getOriginalData()){
+        size_t begin = seq_items.size();
+        for(int item : record){
+            if(item >= 0 && item < static_cast<int>(rank.size()) && rank[item] >= 0){
+                seq_items.push_back(rank[item]);
+            }
+        }
+        if(seq_items.size() == begin){
+            continue;
         }
+        sort(seq_items.begin() + begin, seq_items.end());
+        seq_items.erase(std::unique(seq_items.begin() + begin, seq_items.end()), seq_items.end());
+        seq_ends.push_back(static_cast<uint32_t>(seq_items.size()));
+        seq_counts.push_back(1);
     }
 
+    MemoryCharge seq_memory(MemoryCategory::PatternBases,
+        (seq_items.capacity() + seq_counts.capacity()) * sizeof(int) + seq_ends.capacity() * sizeof(uint32_t));
+    buildFromPaths(*tree, seq_items, seq_ends, seq_counts);
+    root_tree_ = tree;
+
     auto endtime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - begintime);
-    cout << "FP-Tree构建完成，耗时: " << duration.count() << "ms" << endl;
+    cout << "FP-Tree构建完成，节点数: " << nodeCount() << "，耗时: " << duration.count() << "ms" << endl;
 }
 
+void CondFPTree::buildFromPaths(Tree& tree, const vector<int>& seq_items,
+                                const vector<uint32_t>& seq_ends,
+                                const vector<int>& seq_counts) {
+    size_t n = seq_ends.size();
+    auto seq_begin = [&seq_ends](size_t i) -> uint32_t {
+        return i == 0 ? 0 : seq_ends[i - 1];
+    };
+
+    // 路径按字典序排序：共享前缀的路径相邻，插入时只需与上一条路径比较
+    vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return std::lexicographical_compare(
+            seq_items.begin() + seq_begin(a), seq_items.begin() + seq_ends[a],
+            seq_items.begin() + seq_begin(b), seq_items.begin() + seq_ends[b]);
+    });
 
-//用于递归建树挖掘
-void FPTree::buildMiniTree(const std::vector<item_node>& nodes,FPNode* root) {
-   
-    auto array_inverted = load_inverted(nodes);
+    tree.heads.assign(tree.items.size(), -1);
+    tree.nodes.clear();
+    tree.nodes.push_back(FPNode{-1, 0, -1, -1});
+    tree.single_path = true;
+
+    vector<int> path_nodes;       // 上一条路径上的节点下标
+    const int* prev = nullptr;
+    for(uint32_t index : order){
+        const int* cur = seq_items.data() + seq_begin(index);
+        size_t len = seq_ends[index] - seq_begin(index);
+        int count = seq_counts[index];
+
+        // 与上一条路径的公共前缀
+        size_t prev_len = path_nodes.size();
+        size_t common = 0;
+        while(common < prev_len && common < len && prev[common] == cur[common]){
+            common++;
+        }
 
-    //状态追踪
-    auto status_map = unordered_map<int, FPTree::FPNode*>();
+        // 上一条路径在分叉点之后还有节点，说明该处出现了分支
+        if(common < prev_len && common < len){
+            tree.single_path = false;
+        }
 
-    //init
-    auto len = nodes.size();
-    for(size_t i=0;i<len;i++){
-        status_map[i] = root;
-    }
+        path_nodes.resize(common);
+        for(int node : path_nodes){
+            tree.nodes[node].count += count;
+        }
 
-    //tree build
-    cout << "[buildMiniTree] 开始构建树，array_inverted大小: " << array_inverted.size() << endl;
-    for(const auto& [item, path] : array_inverted){
-        for(int i : path.stack){            
-            auto parent = status_map[i];
-            
-            if(parent->children.find(item) == parent->children.end()){
-                auto new_node = new FPNode{item, path.count};
-                parent->children[item] = new_node;
-                status_map[i] = new_node;
-            }
-            else{
-                parent->children[item]->count += path.count;
-                status_map[i] = parent->children[item];
-            }
+        for(size_t k = common; k < len; k++){
+            int item = cur[k];
+            int parent = k == 0 ? 0 : path_nodes[k - 1];
+            int node = static_cast<int>(tree.nodes.size());
+            tree.nodes.push_back(FPNode{item, count, parent, tree.heads[item]});
+            tree.heads[item] = node;
+            path_nodes.push_back(node);
         }
+        prev = cur;
     }
+    Profiler::count(ProfileCounter::NodesAllocated, tree.nodes.size());
+    Profiler::count(ProfileCounter::BytesAllocated, tree.nodes.size() * sizeof(FPNode)
+        + tree.items.size() * sizeof(int) * 3);
+    tree.memory.set(MemoryCategory::FpNodes, tree.nodes.capacity() * sizeof(FPNode)
+        + (tree.items.capacity() + tree.supports.capacity() + tree.heads.capacity()) * sizeof(int));
 }
 
-void FPTree::check() {
-    auto frequent_items = getFrequent1Itemsets();
-
-    // 从主FP-Tree提取条件模式基
-    auto cpbs = std::unordered_map<int, std::vector<item_node>>();
-    auto stack = std::vector<int>();
-    get_cpb(root_, cpbs, stack);
-
-    if(cpbs.empty()) {
-        cout << "[check] cpbs为空，返回" << endl;
+void CondFPTree::check() {
+    ProfileScope scope("condfp.mine");
+    MineStack<CondFrame> root_stack(1);
+    auto& root_frame = root_stack[root_stack.push()];
+    root_frame.tree = root_tree_;
+
+    size_t workers = thread_count_ > 1 ? static_cast<size_t>(thread_count_) : 1;
+    if(workers == 1){
+        MineScratch scratch;
+        SinkWriter writer(target());
+        CondFrame frame;
+        while(root_stack.pop(frame)){
+            expandFrame(frame, root_stack, writer, scratch);
+        }
+        writer.flush();
+        found_ += writer.emittedCount();
         return;
     }
 
-    cout << "[check] 提取到 " << cpbs.size() << " 个item的条件模式基" << endl;
+    // 条件树的展开是惰性的（每个项一个栈帧），空闲线程可以在任意深度窃取
+    WorkStealingScheduler<CondFrame> scheduler(getThreadPool(workers), workers);
+    scheduler.seed(root_stack);
 
-    auto len = frequent_items.size();
+    vector<SinkWriter> writers;
+    writers.reserve(scheduler.workerCount());
+    for(size_t w = 0; w < scheduler.workerCount(); w++){
+        writers.emplace_back(target());
+    }
+    vector<MineScratch> scratches(scheduler.workerCount());
 
-    // 从支持度最低的项开始（自底向上）递归挖掘
-    for(int i = static_cast<int>(len) - 1; i >= 0; i--){
-        int item = frequent_items[i].first;
-        
-        // 检查该item是否有条件模式基
-        auto it = cpbs.find(item);
-        if(it == cpbs.end() || it->second.empty()){
-            continue;
-        }
+    scheduler.run([this, &writers, &scratches](size_t worker, CondFrame& frame, MineStack<CondFrame>& local) {
+        expandFrame(frame, local, writers[worker], scratches[worker]);
+    });
 
-        cout << "[check] 处理item: " << item << ", 条件模式基大小: " << it->second.size() << endl;
-        
-        auto stack = std::vector<int>();
-        stack.push_back(item);
-        
-        // 递归挖掘
-        dfs(it->second, stack);
+    for(auto& writer : writers){
+        writer.flush();
+        found_ += writer.emittedCount();
     }
+    cout << "挖掘线程数: " << scheduler.workerCount() << "，任务窃取次数: " << scheduler.stealCount() << endl;
 }
 
-void FPTree::dfs(std::vector<item_node>& node_cpd, std::vector<int>& stack) {
-
-    auto my_root = new FPNode{-1, 0};
+void CondFPTree::expandFrame(const CondFrame& frame, MineStack<CondFrame>& stack,
+                             SinkWriter& out, MineScratch& scratch) {
+    const Tree& tree = *frame.tree;
 
-    cout << "[dfs] 开始构建miniFP-Tree，node_cpd大小: " << node_cpd.size() << endl;
-    buildMiniTree(node_cpd, my_root);
-    cout << "[dfs] miniFP-Tree构建完成" << endl;
-
-    auto this_cpb = unordered_map<int, std::vector<item_node>>();
-    auto temp_stack = std::vector<int>();
-    get_cpb(my_root, this_cpb, temp_stack);
+    if(frame.item < 0){
+        // 单路径树直接枚举组合，不再构建条件树
+        if(tree.single_path && tree.items.size() < 63){
+            emitSinglePath(frame, out, scratch);
+            return;
+        }
 
-    // 如果条件模式基为空，销毁树并返回
-    if(this_cpb.empty()){
-        cout << "[dfs] this_cpb为空，销毁树并返回" << endl;
-        destroyTree(my_root);
+        // 每个项压入一个栈帧，条件树在弹出时才构建
+        for(size_t j = 0; j < tree.items.size(); j++){
+            auto& child = stack[stack.push()];
+            child.prefix = frame.prefix;
+            child.tree = frame.tree;
+            child.item = static_cast<int>(j);
+        }
         return;
     }
 
-    auto frequent_items = cpb_count(this_cpb);
-   
-    cout << "[dfs] 找到 " << frequent_items.size() << " 个频繁项" << endl;
-
-    // 对每个频繁项进行递归挖掘
-    for(const auto& [item, count] : frequent_items){
-
-        stack.push_back(item);
-        levels[stack.size()-1].insert(stack);
+    // 记录 prefix + item
+    auto& itemset = scratch.itemset;
+    itemset = frame.prefix;
+    itemset.push_back(tree.items[frame.item]);
+    out.emit(itemset.data(), itemset.size(), static_cast<uint32_t>(tree.supports[frame.item]));
 
-        dfs(this_cpb[item], stack);
-
-        stack.pop_back();
+    auto cond_tree = buildConditionalTree(tree, frame.item, scratch);
+    if(!cond_tree){
+        return;
     }
 
-    destroyTree(my_root);
+    auto& child = stack[stack.push()];
+    child.prefix = itemset;
+    child.tree = std::move(cond_tree);
+    child.item = -1;
 }
 
-vector<pair<int,FPTree::item_node>> FPTree::load_inverted(const std::vector<item_node>& nodes) {
-    auto inverted_index = unordered_map<int, item_node>();
-     //创建倒排索引 load
-     for(size_t i=0;i<nodes.size();i++){
-        auto& path = nodes[i].stack;
-        for(int item : path){
-            // 确保item_node被正确初始化
-            if(inverted_index.find(item) == inverted_index.end()){
-                inverted_index[item] = item_node{std::vector<int>{}, 0};
+void CondFPTree::emitSinglePath(const CondFrame& frame, SinkWriter& out, MineScratch& scratch) {
+    const Tree& tree = *frame.tree;
+    size_t m = tree.items.size();
+    auto& itemset = scratch.itemset;
+
+    // 单路径上的项按编号自上而下排列，组合的支持计数等于其中最深节点的计数
+    for(uint64_t mask = 1; mask < (uint64_t(1) << m); mask++){
+        itemset = frame.prefix;
+        int support = 0;
+        for(size_t j = 0; j < m; j++){
+            if(mask & (uint64_t(1) << j)){
+                itemset.push_back(tree.items[j]);
+                support = tree.nodes[tree.heads[j]].count;
             }
-            inverted_index[item].count += nodes[i].count;
-            inverted_index[item].stack.push_back(static_cast<int>(i));
         }
+        out.emit(itemset.data(), itemset.size(), static_cast<uint32_t>(support));
     }
-
-    auto array_inverted = vector<pair<int,item_node>>();
-
-    //transform to array 使用move避免无效拷贝
-    for(auto& [item, path] : inverted_index){
-        if(path.count >= min_support_count_){
-            array_inverted.push_back({item, path});
-        }
-    }
-
-    //sort by count
-    sort(array_inverted.begin(), array_inverted.end(),
-    [](const pair<int,item_node>& a, const pair<int,item_node>& b) {
-        return a.second.count < b.second.count;
-    });
-
-    return array_inverted;
 }
 
-vector<pair<int, int>> FPTree::cpb_count(const std::unordered_map<int, std::vector<item_node>>& cpbs) {
-
-     // 统计每个项的支持度，筛选频繁项
-    // 注意：统计的是path中的所有项，每个pattern的count都要累加
-    unordered_map<int, int> item_counts;
-    for(const auto& [item, patterns] : cpbs){
-        for(const auto& pattern : patterns){
-            // 统计路径中的所有项
-            for(int path_item : pattern.stack){
-                item_counts[path_item] += pattern.count;
-            }
+shared_ptr<const CondFPTree::Tree> CondFPTree::buildConditionalTree(const Tree& tree, int item, MineScratch& scratch) const {
+    ProfileScope scope("condfp.cond_tree");
+    auto& counts = scratch.counts;
+    auto& remap = scratch.remap;
+
+    // 祖先节点的编号一定小于 item
+    counts.assign(item, 0);
+    for(int n = tree.heads[item]; n != -1; n = tree.nodes[n].next){
+        int count = tree.nodes[n].count;
+        for(int p = tree.nodes[n].parent; p != 0; p = tree.nodes[p].parent){
+            counts[tree.nodes[p].item] += count;
         }
     }
 
-    // 筛选频繁项并按支持度降序排序
-    vector<pair<int, int>> frequent_items;
-    for(const auto& [item, count] : item_counts){
-        if(count >= min_support_count_){
-            frequent_items.push_back({item, count});
+    auto cond_tree = make_shared<Tree>();
+    remap.assign(item, -1);
+    for(int j = 0; j < item; j++){
+        if(counts[j] >= min_support_count_){
+            remap[j] = static_cast<int>(cond_tree->items.size());
+            cond_tree->items.push_back(tree.items[j]);
+            cond_tree->supports.push_back(counts[j]);
         }
     }
-
-    sort(frequent_items.begin(), frequent_items.end(),
-         [](const pair<int, int>& a, const pair<int, int>& b) {
-             return a.second > b.second;
-         });
-
-    return frequent_items;
-}
-
-void FPTree::get_cpb(FPNode* node, std::unordered_map<int, std::vector<item_node>>& cpbs, std::vector<int>& stack) {
-    if(node == nullptr) return;
-
-    for(auto& [item, child] : node->children){
-        if(stack.size()>0) cpbs[item].push_back({stack, child->count});
-        stack.push_back(item);
-        get_cpb(child, cpbs, stack);
-        stack.pop_back();
-    }
-}
-
-void FPTree::destroyTree(FPNode* node) {
-    if (node == nullptr) return;
-    
-    for (auto& [item, child] : node->children) {
-        destroyTree(child);
+    if(cond_tree->items.empty()){
+        return nullptr;
     }
-    
-    delete node;
-}
 
-void FPTree::showTree() {
-    if (root_ == nullptr) {
-        cout << "FP-Tree 为空" << endl;
-        return;
-    }
-    
-    cout << "\n========== FP-Tree 结构展示 ==========" << endl;
-    
-    std::queue<pair<FPNode*, int>> q; // (node, level)
-    q.push({root_, 0});
-    
-    int current_level = -1;
-    
-    while (!q.empty()) {
-        auto [node, level] = q.front();
-        q.pop();
-        
-        // 如果是新的一层，打印层标题
-        if (level != current_level) {
-            if (current_level != -1) {
-                cout << endl;
-            }
-            current_level = level;
-            if (level == 0) {
-                cout << "Level " << level << " (根节点): ";
-            } else {
-                cout << "Level " << level << ": ";
+    // 条件模式基：每个 item 节点到根的路径（只保留频繁项），向上遍历得到降序，翻转为升序
+    auto& seq_items = scratch.seq_items;
+    auto& seq_ends = scratch.seq_ends;
+    auto& seq_counts = scratch.seq_counts;
+    seq_items.clear();
+    seq_ends.clear();
+    seq_counts.clear();
+    for(int n = tree.heads[item]; n != -1; n = tree.nodes[n].next){
+        size_t begin = seq_items.size();
+        for(int p = tree.nodes[n].parent; p != 0; p = tree.nodes[p].parent){
+            int mapped = remap[tree.nodes[p].item];
+            if(mapped >= 0){
+                seq_items.push_back(mapped);
             }
         }
-        
-        // 打印节点信息
-        if (node->item == -1) {
-            cout << "[ROOT]";
-        } else {
-            cout << "[" << node->item << ":" << node->count << "]";
-        }
-        
-        // 将子节点加入队列
-        for (auto& [item, child] : node->children) {
-            q.push({child, level + 1});
-        }
-        
-        // 如果这一层还有节点，添加分隔符
-        if (!q.empty() && q.front().second == level) {
-            cout << "  ";
+        if(seq_items.size() == begin){
+            continue;
         }
+        std::reverse(seq_items.begin() + begin, seq_items.end());
+        seq_ends.push_back(static_cast<uint32_t>(seq_items.size()));
+        seq_counts.push_back(tree.nodes[n].count);
     }
-    
-    cout << "\n\n==========================================" << endl;
+
+    buildFromPaths(*cond_tree, seq_items, seq_ends, seq_counts);
+    return cond_tree;
 }
@@ -1,139 +1,154 @@
-#ifndef FP_HPP
-#define FP_HPP
+#ifndef COND_FP_HPP
+#define COND_FP_HPP
 
-#include <unordered_set>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
-#include <unordered_map>
-#include <algorithm>
 #include "dataload/data_loader.hpp"
-
-class FPTree {
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+#include "fptree/mine_stack.hpp"
+#include "profile/memory.hpp"
+
+struct FrequentOccurrence;
+
+/**
+ * 条件FP-Tree挖掘引擎
+ * 与 src/fptree 携带原始路径列表不同，这里每一层都构建真正的条件FP-Tree（miniFP-Tree），
+ * 公共前缀被合并，内存占用明显更小，适合内存受限的场景。
+ * 节点存放在连续数组中，只保存父节点下标和同项链表，不需要子节点哈希表。
+ */
+class CondFPTree {
 public:
-
-    struct VectorHash {
-        std::size_t operator()(const std::vector<int>& vec) const {
-            std::size_t hash = vec.size();  // 先加入size，避免不同长度的vector碰撞
-            for (int val : vec) {
-                // 使用加法组合，顺序无关（加法满足交换律）
-                hash += std::hash<int>{}(val);
-            }
-            return hash;
-        }
-    };
-
-    // 自定义相等性比较器（不依赖顺序）
-    struct VectorEqual {
-        bool operator()(const std::vector<int>& a, const std::vector<int>& b) const {
-            if (a.size() != b.size()) return false;
-            
-            // 创建副本并排序后比较
-            std::vector<int> sorted_a = a;
-            std::vector<int> sorted_b = b;
-            std::sort(sorted_a.begin(), sorted_a.end());
-            std::sort(sorted_b.begin(), sorted_b.end());
-            
-            return sorted_a == sorted_b;
-        }
-    };
-
-   
-
+    // 树节点：item 为树内的局部编号，根节点为 -1
     struct FPNode {
-        int item;                    // 项的值
-        int count;                   // 支持计数
-        std::unordered_map<int, FPNode*> children; // 子节点映射表 (item -> node)
+        int item;
+        int count;
+        int parent;   // 父节点下标
+        int next;     // 同一项的下一个节点下标（头表链），-1 表示结束
     };
-    FPTree(const DataLoader& db, double min_support);
-    ~FPTree();
-
-
-    using level = std::unordered_set<std::vector<int>, VectorHash, VectorEqual>;
 
+    // 一棵（条件）FP-Tree
+    struct Tree {
+        std::vector<int> items;      // 局部编号 -> 原始项，按全局频繁项顺序排列
+        std::vector<int> supports;   // 局部编号 -> 支持计数
+        std::vector<int> heads;      // 局部编号 -> 头表链的第一个节点
+        std::vector<FPNode> nodes;   // 节点数组，0号为根节点
+        bool single_path = true;     // 是否为单路径树
+        MemoryCharge memory;         // 节点和头表的内存登记，随树一起释放
+    };
 
-    // 频繁项集结果
-    std::vector<level> levels;
-    /**
-     * 构建FP-Tree并挖掘频繁项集
-     */
-    void buildFPTree();
-    
-    /**
-     * 获取频繁1项集（用于条件FP-Tree构建）
-     */
-    std::vector<std::pair<int, const std::vector<int>* >> getFrequent1Itemsets();
-    
     /**
-     * 显示所有频繁项集
+     * 构造函数：构建FP-Tree并挖掘频繁项集
+     * @param db 数据加载器
+     * @param min_support 最小支持度（小于1为相对支持度，大于等于1为绝对支持计数）
+     * @param thread_count 挖掘线程数，小于等于1时在当前线程串行挖掘
+     * @param sink 结果接收端，为空时结果收集在内存中，可通过 getFrequentItemsets 获取
      */
-    void displayFrequentItemsets();
-    
+    CondFPTree(const DataLoader& db, double min_support, int thread_count = 0, ItemsetSink* sink = nullptr);
+    ~CondFPTree();
+
     /**
-     * 显示FP-Tree结构（按层展示）
+     * 估算挖掘需要的字节数（全局树节点和每个线程的条件树的上界，不含数据集本身）
+     * @param occurrence 数据集中频繁项的出现情况
+     * @param thread_count 挖掘线程数，每个线程各有一组条件树
      */
-    void showTree();
-    
+    static size_t estimateMemory(const FrequentOccurrence& occurrence, int thread_count);
+
     /**
-     * 显示指定item的条件FP-Tree（miniFP-Tree）结构
-     * @param item 要展示的item编号
+     * 获取频繁1项集，按支持度降序排列（支持度相同按项值升序）
      */
-    void showMiniTree(int item);
-    
+    std::vector<std::pair<int, const std::vector<int>*>> getFrequent1Itemsets();
+
     /**
-     * 导出频繁项集结果（用于与Apriori比对）
-     * 格式：Level X (频繁Y项集): 支持计数=xxx
+     * 获取所有频繁项集（按level组织，附带支持计数），指定了外部接收端时为空
      */
-    void exportFrequentItemsets();
-    
+    const ItemsetPool& getFrequentItemsets() const {
+        return collected_.itemsets();
+    }
+
     /**
-     * 获取所有频繁项集
+     * 全局FP-Tree的节点数（不含根节点）
      */
-    const std::vector<level>& getFrequentItemsets() const {
-        return levels;
+    size_t nodeCount() const noexcept {
+        return root_tree_ ? root_tree_->nodes.size() - 1 : 0;
     }
 
 private:
     const DataLoader& db_;
     double min_support_;
     int min_support_count_;      // 最小支持计数（绝对数量）
+    int thread_count_;           // 挖掘线程数
+    size_t found_;               // 已找到的频繁项集数量
 
-    struct item_node{
-        std::vector<int> stack;
-        int count;
-    };
+    // 频繁项集结果：推送到外部接收端，未指定时收集到内存
+    ItemsetSink* sink_;
+    CollectSink collected_;
 
+    ItemsetSink& target() {
+        return sink_ != nullptr ? *sink_ : collected_;
+    }
 
-    
-    // FP-Tree结构
-    FPNode* root_;                // 根节点
-    
-    // 步骤2: 构建FP-Tree（使用原始数据，按频繁项顺序构建）
-    void buildTree(const std::vector<std::pair<int, const std::vector<int>*>> frequent_items);
+    // 全局FP-Tree
+    std::shared_ptr<const Tree> root_tree_;
 
-    /**
-     * 检查并挖掘item的频繁项集
-     * @param item 当前项
-     */
-    void check();
+    // 挖掘栈帧：item 为 -1 时展开整棵树，否则为 tree 中的项 item 构建条件树
+    struct CondFrame {
+        std::vector<int> prefix;             // 当前项集（原始项）
+        std::shared_ptr<const Tree> tree;
+        int item = -1;
 
-    void get_cpb(FPNode* node, std::unordered_map<int, std::vector<item_node>>& cpbs, std::vector<int>& stack);
+        void clear() {
+            prefix.clear();
+            tree.reset();
+            item = -1;
+        }
+    };
+
+    // 每个挖掘线程的临时空间
+    struct MineScratch {
+        std::vector<int> counts;       // 局部编号 -> 条件模式基中的支持计数
+        std::vector<int> remap;        // 局部编号 -> 条件树中的新编号，-1 表示非频繁
+        std::vector<int> seq_items;    // 条件模式基路径（扁平存放）
+        std::vector<uint32_t> seq_ends;
+        std::vector<int> seq_counts;
+        std::vector<int> itemset;      // 输出项集缓冲
+    };
 
     /**
-     * 构建miniFP-Tree
-     * @param nodes 条件模式基节点列表
-     * @param root 当前根节点
-     * @return miniFP-Tree的追踪节点
+     * 构建全局FP-Tree：把每条记录映射为频繁项序号序列后排序插入
      */
-    void buildMiniTree(const std::vector<item_node>& nodes,FPNode* root);
+    void buildTree(const std::vector<std::pair<int, const std::vector<int>*>>& frequent_items);
 
-    void destroyTree(FPNode* node);
+    /**
+     * 由按序排列的路径集合构建FP-Tree（路径先按字典序排序，插入时与上一条路径共享前缀）
+     */
+    static void buildFromPaths(Tree& tree, const std::vector<int>& seq_items,
+                               const std::vector<uint32_t>& seq_ends,
+                               const std::vector<int>& seq_counts);
 
-    void dfs(std::vector<item_node>& node_cpd, std::vector<int>& stack);
+    /**
+     * 挖掘频繁项集，多线程时交给工作窃取调度器
+     */
+    void check();
 
-    std::vector<std::pair<int, int>> cpb_count(const std::unordered_map<int, std::vector<item_node>>& cpbs);
+    /**
+     * 展开一个栈帧
+     */
+    void expandFrame(const CondFrame& frame, MineStack<CondFrame>& stack,
+                     SinkWriter& out, MineScratch& scratch);
 
-    std::vector<std::pair<int,item_node>> load_inverted(const std::vector<item_node>& nodes);
-    
+    /**
+     * 单路径树：直接枚举路径上所有项的组合
+     */
+    void emitSinglePath(const CondFrame& frame, SinkWriter& out, MineScratch& scratch);
 
+    /**
+     * 为 tree 中的项 item 构建条件FP-Tree
+     * @return 条件树，没有频繁项时返回空指针
+     */
+    std::shared_ptr<const Tree> buildConditionalTree(const Tree& tree, int item, MineScratch& scratch) const;
 };
 
-#endif // FP_HPP
+#endif // COND_FP_HPP
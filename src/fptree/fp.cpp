@@ -1,9 +1,14 @@
 #include "fp.hpp"
+#include "threadsignal.hpp"
+#include "miner/support.hpp"
+#include "profile/profiler.hpp"
+#include "fptree/projected_db.hpp"
+#include "sched/parallel_for.hpp"
+#include "sched/work_stealing.hpp"
 #include <cstddef>
 #include <iostream>
 #include <algorithm>
 #include <unordered_map>
-#include <unordered_set>
 #include <queue>
 #include <utility>
 #include <vector>
@@ -15,17 +20,12 @@ using std::endl;
 using std::vector;
 using std::pair;
 using std::unordered_map;
-using std::unordered_set;
 using std::sort;
 
-FPTree::FPTree(const DataLoader& db, double min_support)
-    : db_(db), min_support_(min_support), root_(nullptr), min_support_count_(0) {
+FPTree::FPTree(const DataLoader& db, double min_support, int thread_count, ItemsetSink* sink)
+    : db_(db), min_support_(min_support), min_support_count_(0), thread_count_(thread_count), found_(0), sink_(sink), root_(nullptr) {
   
-    double support_count = min_support * db_.all_count;
-    min_support_count_ = static_cast<int>(std::ceil(support_count));
-    if (min_support_count_ < 1) min_support_count_ = 1;
-
-    levels.reserve(10);
+    min_support_count_ = static_cast<int>(resolveSupportCount(min_support, db_.all_count));
 
     cout << "\n========== FP-Tree 算法 ==========" << endl;
     cout << "最小支持度: " << min_support_ << " (最小支持计数: " << min_support_count_ << ")" << endl;
@@ -47,21 +47,18 @@ FPTree::FPTree(const DataLoader& db, double min_support)
     // 步骤3: 挖掘频繁项集
     cout << "\n步骤3: 挖掘频繁项集..." << endl;
     
-    // 初始化levels，记录频繁1项集
-    levels.resize(10);  // 预分配空间
+    // 记录频繁1项集
+    SinkWriter writer(target());
     for(const auto& item : frequent_items){
-        levels[0].insert({item.first});
+        writer.emit(&item.first, 1, static_cast<uint32_t>(item.second->size()));
     }
+    writer.flush();
+    found_ += writer.emittedCount();
 
     // 从支持度最低的项开始，递归挖掘频繁项集
     check(frequent_items);
 
-    // 统计总数量
-    size_t total_count = 0;
-    for (const auto& level : levels) {
-        total_count += level.size();
-    }
-    cout << "\nFP-Tree算法完成！共找到 " << total_count << " 个频繁项集" << endl;
+    cout << "\nFP-Tree算法完成！共找到 " << found_ << " 个频繁项集" << endl;
 }
 
 FPTree::~FPTree() {
@@ -70,6 +67,17 @@ FPTree::~FPTree() {
     }
 }
 
+size_t FPTree::estimateMemory(const FrequentOccurrence& occurrence, int thread_count) {
+    // 节点数不超过频繁项的出现次数，每个节点另占父节点子表中的一个哈希节点和桶（同 buildTree 中的估算）
+    size_t child_entry = sizeof(std::pair<const int, FPNode*>) + 3 * sizeof(void*);
+    size_t nodes = occurrence.occurrences * (sizeof(FPNode) + child_entry);
+    // 每个新节点保存一条从根到父节点的路径：路径总长不超过各事务中频繁项前缀长度之和
+    size_t bases = occurrence.prefix_items * sizeof(int) + occurrence.occurrences * sizeof(std::pair<vector<int>, FPNode*>);
+    // 每个线程的栈帧：一个项的条件模式基不超过整棵树（项、结束位置、计数）
+    size_t frames = occurrence.occurrences * 3 * sizeof(int) * resolveThreadCount(thread_count);
+    return nodes + bases + frames;
+}
+
 vector<pair<int, const std::vector<int>*>> FPTree::getFrequent1Itemsets() {
     const auto& inverted_index = db_.getInvertedIndex();
     
@@ -91,6 +99,7 @@ vector<pair<int, const std::vector<int>*>> FPTree::getFrequent1Itemsets() {
 }
 
 void FPTree::buildTree(const vector<pair<int, const std::vector<int>*>> frequent_items) {
+    ProfileScope scope("fptree.build");
    
     auto begintime = std::chrono::high_resolution_clock::now();
 
@@ -104,6 +113,7 @@ void FPTree::buildTree(const vector<pair<int, const std::vector<int>*>> frequent
     vector<FPNode*> nodes(len, root_);
 
     vector<vector<int>> paths(len);
+    uint64_t allocated = 1;
 
     for(const auto& item : frequent_items){
         auto index = item.first;
@@ -116,6 +126,7 @@ void FPTree::buildTree(const vector<pair<int, const std::vector<int>*>> frequent
 
             if(get == node->children.end()){
                 auto new_node = new FPNode{index, 1};
+                allocated++;
                 node->children[index] = new_node;
                 nodes[record] = new_node;
                 
@@ -134,113 +145,181 @@ void FPTree::buildTree(const vector<pair<int, const std::vector<int>*>> frequent
             }
         }
     }
+    Profiler::count(ProfileCounter::NodesAllocated, allocated);
+    Profiler::count(ProfileCounter::BytesAllocated, allocated * sizeof(FPNode));
+    if(MemoryTracker::enabled()){
+        // 估算：每个非根节点还占父节点子表中的一个哈希节点（键值对 + next 指针 + 缓存的哈希）和一个桶
+        size_t child_entry = sizeof(std::pair<const int, FPNode*>) + 2 * sizeof(void*) + sizeof(void*);
+        nodes_memory_.set(MemoryCategory::FpNodes, allocated * sizeof(FPNode) + (allocated - 1) * child_entry);
+        size_t base_bytes = 0;
+        for(const auto& [item, patterns] : conditional_pattern_bases_){
+            base_bytes += patterns.capacity() * sizeof(patterns[0]);
+            for(const auto& pattern : patterns){
+                base_bytes += pattern.first.capacity() * sizeof(int);
+            }
+        }
+        pattern_bases_memory_.set(MemoryCategory::PatternBases, base_bytes);
+    }
     auto endtime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - begintime);
     cout << "FP-Tree构建完成，耗时: " << duration.count() << "ms" << endl;
 }
 
 void FPTree::check(const vector<pair<int, const std::vector<int>*>>& frequent_items) {
-   auto item_map =unordered_map<int, vector<item_node>>();
-   for(const auto& [item, patterns] : conditional_pattern_bases_){
+    ProfileScope scope("fptree.mine");
+    // 每个项的条件模式基作为一个初始栈帧
+    MineStack<MineFrame> root_stack(conditional_pattern_bases_.size());
+    for(const auto& [item, patterns] : conditional_pattern_bases_){
+        auto& frame = root_stack[root_stack.push()];
+        frame.prefix.push_back(item);
         for(const auto& [path, node] : patterns){
-            item_map[item].push_back({path, node->count});
-        }
-   }
-
-   for(const auto& [item, patterns] : item_map){
-       auto temp_stack = vector<int>();
-       
-       temp_stack.push_back(item);
-       
-       dfs(temp_stack,patterns);
-    
-   }
-}
-
-void FPTree::dfs(vector<int>& stack, const vector<item_node>& conditional_patterns) {
-    
-    // 统计条件模式基中每个项的支持度
-    // 注意：统计的是path中的所有项，每个pattern的count都要累加
-    unordered_map<int, int> item_counts;
-    for(const auto& pattern : conditional_patterns){
-        for(int item : pattern.stack){
-            item_counts[item] += pattern.count;
+            frame.items.insert(frame.items.end(), path.begin(), path.end());
+            frame.ends.push_back(static_cast<uint32_t>(frame.items.size()));
+            frame.counts.push_back(node->count);
         }
     }
-    
-    // 筛选频繁项
-    vector<pair<int, int>> frequent_items;
-    for(const auto& [item, count] : item_counts){
-        if(count >= min_support_count_){
-            frequent_items.push_back({item, count});
+    // 初始栈帧是条件模式基的扁平副本，按挖掘开始时的大小登记到挖掘结束
+    MemoryCharge frames_memory;
+    if(MemoryTracker::enabled()){
+        size_t frame_bytes = 0;
+        for(size_t f = 0; f < root_stack.size(); f++){
+            const auto& frame = root_stack[f];
+            frame_bytes += (frame.prefix.capacity() + frame.items.capacity() + frame.counts.capacity()) * sizeof(int)
+                + frame.ends.capacity() * sizeof(uint32_t);
         }
+        frames_memory.set(MemoryCategory::PatternBases, frame_bytes);
     }
-    
-    if(frequent_items.empty()){
+
+    size_t workers = thread_count_ > 1 ? static_cast<size_t>(thread_count_) : 1;
+    if(workers == 1 || root_stack.size() < 2){
+        SinkWriter writer(target());
+        mine(root_stack, writer);
+        writer.flush();
+        found_ += writer.emittedCount();
         return;
     }
-    
-    // 按支持度降序排序
-    sort(frequent_items.begin(), frequent_items.end(),
-         [](const pair<int, int>& a, const pair<int, int>& b) {
-             return a.second > b.second;
-         });
-    
-    // 对每个频繁项，生成新的频繁项集并递归挖掘
-    for(const auto& [item, count] : frequent_items){
-        // 添加当前项到栈中
-        stack.push_back(item);
-        
 
-        // 确保levels有足够的空间
-        size_t level_index = stack.size() - 1;
-        if(level_index >= levels.size()){
-            levels.resize(level_index + 1);
-        }
-        
-        // 记录频繁项集
-        levels[level_index].insert(stack);
-        
-        // 生成新的条件模式基
-        vector<item_node> new_patterns = generateNewPatterns(conditional_patterns, item);
-        
-        // 递归挖掘
-        dfs(stack, new_patterns);
-        
-        stack.pop_back();
+    // 工作窃取调度：任意深度的大条件子树都可以被空闲线程拆走，避免单个线程拖尾
+    WorkStealingScheduler<MineFrame> scheduler(getThreadPool(workers), workers);
+    scheduler.seed(root_stack);
+
+    vector<SinkWriter> writers;
+    writers.reserve(scheduler.workerCount());
+    for(size_t w = 0; w < scheduler.workerCount(); w++){
+        writers.emplace_back(target());
+    }
+    vector<MineScratch> scratches(scheduler.workerCount());
+    for(auto& scratch : scratches){
+        initScratch(scratch);
+    }
+
+    scheduler.run([this, &writers, &scratches](size_t worker, MineFrame& frame, MineStack<MineFrame>& local) {
+        expandFrame(frame, local, writers[worker], scratches[worker]);
+    });
+
+    for(auto& writer : writers){
+        writer.flush();
+        found_ += writer.emittedCount();
     }
+    cout << "挖掘线程数: " << scheduler.workerCount() << "，任务窃取次数: " << scheduler.stealCount() << endl;
 }
 
-vector<FPTree::item_node> FPTree::generateNewPatterns(
-    const vector<item_node>& patterns, 
-    int target_item) {
-    vector<item_node> new_patterns;
-    
-    for(const auto& pattern : patterns){
-        // 找到target_item在path中的位置
-        auto& path = pattern.stack;
-        auto pos = std::find(path.begin(), path.end(), target_item);
-        if(pos != path.end()){
-            // 提取target_item之前的前缀路径，保留原来的count值
-            vector<int> prefix(path.begin(), pos);
-            // 即使prefix为空，也要保留（用于后续处理）
-            new_patterns.push_back({prefix, pattern.count});
-        }
+void FPTree::initScratch(MineScratch& scratch) const {
+    scratch.item_counts.assign(db_.getMaxValue() + 1, 0);
+    scratch.child_slot.assign(db_.getMaxValue() + 1, -1);
+}
+
+void FPTree::mine(MineStack<MineFrame>& stack, SinkWriter& out) {
+    MineScratch scratch;
+    initScratch(scratch);
+
+    MineFrame frame;
+    while(stack.pop(frame)){
+        expandFrame(frame, stack, out, scratch);
     }
-    
-    return new_patterns;
 }
 
+void FPTree::expandFrame(const MineFrame& frame, MineStack<MineFrame>& stack,
+                         SinkWriter& out, MineScratch& scratch) {
+    ProfileScope scope("fptree.frame");
+    auto& item_counts = scratch.item_counts;
+    auto& child_slot = scratch.child_slot;
+    auto& touched = scratch.touched;
+
+    // 统计条件模式基中每个项的支持度（每条路径的count都要累加）
+    uint32_t begin = 0;
+    for(size_t p = 0; p < frame.ends.size(); p++){
+        for(uint32_t k = begin; k < frame.ends[p]; k++){
+            int item = frame.items[k];
+            if(item_counts[item] == 0){
+                touched.push_back(item);
+            }
+            item_counts[item] += frame.counts[p];
+        }
+        begin = frame.ends[p];
+    }
+
+    // 记录频繁项集，并为每个频繁项压入一个子栈帧
+    for(int item : touched){
+        int count = item_counts[item];
+        if(count < min_support_count_){
+            continue;
+        }
+
+        size_t slot = stack.push();
+        auto& child = stack[slot];
+        child.prefix = frame.prefix;
+        child.prefix.push_back(item);
+        out.emit(child.prefix.data(), child.prefix.size(), static_cast<uint32_t>(count));
+        child_slot[item] = static_cast<int>(slot);
+    }
+
+    // 一次遍历生成所有子条件模式基：路径中每个频繁项之前的前缀就是该项的一条条件路径
+    // 非频繁项在子条件模式基中也不可能频繁，直接从前缀中过滤掉
+    auto& path = scratch.path;
+    begin = 0;
+    for(size_t p = 0; p < frame.ends.size(); p++){
+        path.clear();
+        for(uint32_t k = begin; k < frame.ends[p]; k++){
+            int item = frame.items[k];
+            int slot = child_slot[item];
+            if(slot < 0){
+                continue;
+            }
+            if(!path.empty()){
+                auto& child = stack[slot];
+                child.items.insert(child.items.end(), path.begin(), path.end());
+                child.ends.push_back(static_cast<uint32_t>(child.items.size()));
+                child.counts.push_back(frame.counts[p]);
+            }
+            path.push_back(item);
+        }
+        begin = frame.ends[p];
+    }
 
+    // 复位临时空间
+    for(int item : touched){
+        item_counts[item] = 0;
+        child_slot[item] = -1;
+    }
+    touched.clear();
+}
 
 void FPTree::destroyTree(FPNode* node) {
-    if (node == nullptr) return;
-    
-    for (auto& [item, child] : node->children) {
-        destroyTree(child);
+    // 显式栈代替递归，避免深树导致栈溢出
+    vector<FPNode*> pending;
+    if (node != nullptr) {
+        pending.push_back(node);
     }
     
-    delete node;
+    while (!pending.empty()) {
+        FPNode* current = pending.back();
+        pending.pop_back();
+        for (auto& [item, child] : current->children) {
+            pending.push_back(child);
+        }
+        delete current;
+    }
 }
 
 void FPTree::showTree() {
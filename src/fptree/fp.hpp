@@ -1,55 +1,43 @@
 #ifndef FP_HPP
 #define FP_HPP
 
-#include <unordered_set>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
 #include "dataload/data_loader.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+#include "fptree/mine_stack.hpp"
+#include "profile/memory.hpp"
+
+struct FrequentOccurrence;
 
 class FPTree {
 public:
 
-    struct VectorHash {
-        std::size_t operator()(const std::vector<int>& vec) const {
-            std::size_t hash = vec.size();  // 先加入size，避免不同长度的vector碰撞
-            for (int val : vec) {
-                // 使用加法组合，顺序无关（加法满足交换律）
-                hash += std::hash<int>{}(val);
-            }
-            return hash;
-        }
-    };
-
-    // 自定义相等性比较器（不依赖顺序）
-    struct VectorEqual {
-        bool operator()(const std::vector<int>& a, const std::vector<int>& b) const {
-            if (a.size() != b.size()) return false;
-            
-            // 创建副本并排序后比较
-            std::vector<int> sorted_a = a;
-            std::vector<int> sorted_b = b;
-            std::sort(sorted_a.begin(), sorted_a.end());
-            std::sort(sorted_b.begin(), sorted_b.end());
-            
-            return sorted_a == sorted_b;
-        }
-    };
-
     struct FPNode {
         int item;                    // 项的值，-1表示根节点
         int count;                   // 支持计数
         std::unordered_map<int, FPNode*> children; // 子节点映射表 (item -> node)
     };
     
-    FPTree(const DataLoader& db, double min_support);
+    /**
+     * 构造函数：构建FP-Tree并挖掘频繁项集
+     * @param db 数据加载器
+     * @param min_support 最小支持度（小于1为相对支持度，大于等于1为绝对支持计数）
+     * @param thread_count 挖掘线程数，小于等于1时在当前线程串行挖掘
+     * @param sink 结果接收端，为空时结果收集在内存中，可通过 getFrequentItemsets 获取
+     */
+    FPTree(const DataLoader& db, double min_support, int thread_count = 0, ItemsetSink* sink = nullptr);
     ~FPTree();
 
-    using level = std::unordered_set<std::vector<int>, VectorHash, VectorEqual>;
+    /**
+     * 估算挖掘需要的字节数（FP树节点、条件模式基和挖掘栈帧的上界，不含数据集本身）
+     * @param occurrence 数据集中频繁项的出现情况
+     * @param thread_count 挖掘线程数，每个线程各有一组栈帧
+     */
+    static size_t estimateMemory(const FrequentOccurrence& occurrence, int thread_count);
 
-    // 频繁项集结果
-    std::vector<level> levels;
-    
     /**
      * 获取频繁1项集（用于条件FP-Tree构建）
      */
@@ -61,20 +49,48 @@ public:
     void showTree();
     
     /**
-     * 获取所有频繁项集
+     * 获取所有频繁项集（按level组织，附带支持计数），指定了外部接收端时为空
      */
-    const std::vector<level>& getFrequentItemsets() const {
-        return levels;
+    const ItemsetPool& getFrequentItemsets() const {
+        return collected_.itemsets();
     }
 
 private:
     const DataLoader& db_;
     double min_support_;
     int min_support_count_;      // 最小支持计数（绝对数量）
+    int thread_count_;           // 挖掘线程数
+    size_t found_;               // 已找到的频繁项集数量
 
-    struct item_node{
-        std::vector<int> stack;   // 路径
-        int count;               // 支持计数
+    // 频繁项集结果：推送到外部接收端，未指定时收集到内存
+    ItemsetSink* sink_;
+    CollectSink collected_;
+
+    ItemsetSink& target() {
+        return sink_ != nullptr ? *sink_ : collected_;
+    }
+
+    // 挖掘栈帧：一个条件挖掘状态，条件模式基的路径扁平存放
+    struct MineFrame {
+        std::vector<int> prefix;      // 当前项集
+        std::vector<int> items;       // 所有路径的项（按全局频繁项顺序）
+        std::vector<uint32_t> ends;   // 每条路径在 items 中的结束位置
+        std::vector<int> counts;      // 每条路径的计数
+
+        void clear() {
+            prefix.clear();
+            items.clear();
+            ends.clear();
+            counts.clear();
+        }
+    };
+
+    // 每个挖掘线程的临时空间，按项值直接索引，避免哈希表
+    struct MineScratch {
+        std::vector<int> item_counts;   // 项 -> 条件模式基中的支持计数
+        std::vector<int> child_slot;    // 项 -> 子栈帧下标，-1表示非频繁
+        std::vector<int> touched;       // 本次统计涉及的项
+        std::vector<int> path;          // 过滤后的前缀路径
     };
 
     // FP-Tree结构
@@ -83,6 +99,10 @@ private:
     // 条件模式基：{item: [(path, node), ...]}
     // path是从根到父节点的路径，node是新创建的节点（用于获取动态更新的count）
     std::unordered_map<int, std::vector<std::pair<std::vector<int>, FPNode*>>> conditional_pattern_bases_;
+
+    // 树节点和条件模式基的内存登记
+    MemoryCharge nodes_memory_;
+    MemoryCharge pattern_bases_memory_;
     
     /**
      * 构建FP-Tree（使用原始数据，按频繁项顺序构建）
@@ -90,27 +110,30 @@ private:
     void buildTree(const std::vector<std::pair<int, const std::vector<int>*>> frequent_items);
     
     /**
-     * 挖掘频繁项集（从支持度最低的项开始，自底向上递归）
+     * 挖掘频繁项集：每个项的条件模式基作为初始栈帧，多线程时交给工作窃取调度器
      */
     void check(const std::vector<std::pair<int, const std::vector<int>*>>& frequent_items);
     
     /**
-     * 递归挖掘频繁项集
-     * @param stack 当前项集栈
-     * @param conditional_patterns 条件模式基
+     * 按最大项值初始化线程临时空间
      */
-    void dfs(std::vector<int>& stack, const std::vector<item_node>& conditional_patterns);
-    
+    void initScratch(MineScratch& scratch) const;
+
     /**
-     * 从条件模式基中生成新的条件模式基（提取包含target_item的前缀路径）
+     * 不断弹出栈帧并展开，直到工作栈为空
+     * @param stack 工作栈
+     * @param out 结果写入的线程本地缓冲
      */
-    std::vector<item_node> generateNewPatterns(
-        const std::vector<item_node>& patterns, 
-        int target_item);
+    void mine(MineStack<MineFrame>& stack, SinkWriter& out);
     
+    /**
+     * 展开一个栈帧：记录其中的频繁项集，并为每个频繁项压入新的条件栈帧
+     */
+    void expandFrame(const MineFrame& frame, MineStack<MineFrame>& stack,
+                     SinkWriter& out, MineScratch& scratch);
 
     /**
-     * 销毁FP-Tree
+     * 销毁FP-Tree（显式栈遍历，不递归）
      */
     void destroyTree(FPNode* node);
 };
@@ -0,0 +1,106 @@
+#ifndef MINE_STACK_HPP
+#define MINE_STACK_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * FP-Growth 显式工作栈
+ * 用堆上预分配的栈帧代替递归调用，每个栈帧保存一个条件挖掘状态。
+ * 弹出的栈帧与调用方交换缓冲区，栈顶以上的槽位保留已分配的内存供下次压栈复用，
+ * 稳定运行后压栈/弹栈不再产生堆分配。
+ * Frame 需要提供 clear() 方法（清空内容但保留容量）。
+ */
+template <typename Frame>
+class MineStack {
+public:
+    explicit MineStack(size_t reserve_frames = 64) : size_(0) {
+        frames_.reserve(reserve_frames);
+    }
+
+    /**
+     * 压入一个空栈帧（复用栈顶以上槽位的内存）
+     * @return 新栈帧的下标（下标在后续压栈后依然有效，引用则不一定）
+     */
+    size_t push() {
+        if (size_ < frames_.size()) {
+            frames_[size_].clear();
+        } else {
+            frames_.emplace_back();
+        }
+        return size_++;
+    }
+
+    /**
+     * 弹出栈顶帧：与 out 交换内容，out 原有的缓冲区留在槽位中复用
+     * @return 栈为空时返回false
+     */
+    bool pop(Frame& out) {
+        if (size_ == 0) {
+            return false;
+        }
+        size_--;
+        std::swap(out, frames_[size_]);
+        return true;
+    }
+
+    Frame& operator[](size_t index) {
+        return frames_[index];
+    }
+
+    const Frame& operator[](size_t index) const {
+        return frames_[index];
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * 从栈底切走一半栈帧到 out（栈底的帧离根最近，通常对应最大的子问题），
+     * 用于在线程间拆分工作量
+     * @return 切走的栈帧数量
+     */
+    size_t splitHalf(MineStack& out) {
+        size_t count = size_ / 2;
+        if (count == 0) {
+            return 0;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t index = out.push();
+            std::swap(out.frames_[index], frames_[i]);
+        }
+        // 剩余栈帧整体下移
+        for (size_t i = count; i < size_; i++) {
+            std::swap(frames_[i - count], frames_[i]);
+        }
+        size_ -= count;
+        return count;
+    }
+
+    /**
+     * 将所有栈帧轮流分配到 parts 中（用于初始的静态划分）
+     */
+    void scatter(std::vector<MineStack>& parts) {
+        if (parts.empty()) {
+            return;
+        }
+        for (size_t i = 0; i < size_; i++) {
+            auto& part = parts[i % parts.size()];
+            size_t index = part.push();
+            std::swap(part.frames_[index], frames_[i]);
+        }
+        size_ = 0;
+    }
+
+private:
+    std::vector<Frame> frames_;   // 栈帧槽位，[0, size_) 为有效栈帧
+    size_t size_;                 // 有效栈帧数量
+};
+
+#endif // MINE_STACK_HPP
@@ -0,0 +1,461 @@
+#include "projected_db.hpp"
+#include "result/varint.hpp"
+#include "sched/parallel_for.hpp"
+#include "threadsignal.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// 同一进程内多次降级时的临时目录序号
+std::atomic<size_t> next_directory{0};
+
+/**
+ * 把项映射回原始项并加上前缀后转发给目标接收端
+ * consume 可能被引擎的多个线程同时调用，转换用的缓冲都是局部的
+ */
+class PrefixSink : public ItemsetSink {
+public:
+    PrefixSink(ItemsetSink& target, const vector<int>& prefix, const vector<int>& mapping)
+        : target_(target), prefix_(prefix), mapping_(mapping) {}
+
+    void consume(const ItemsetPool& batch) override {
+        SinkWriter writer(target_);
+        vector<int> items = prefix_;
+        batch.forEach([&](const ItemsetPool::ItemsetView& itemset) {
+            items.resize(prefix_.size());
+            for (int item : itemset) {
+                items.push_back(mapping_[item]);
+            }
+            writer.emit(items.data(), items.size(), itemset.support);
+        });
+        writer.flush();
+    }
+
+private:
+    ItemsetSink& target_;
+    const vector<int>& prefix_;
+    const vector<int>& mapping_;
+};
+
+/**
+ * 各项的支持计数（同一事务中重复的项只计一次），下标为项，负数项忽略
+ */
+template <typename Scan>
+vector<size_t> itemCounts(const Scan& scan) {
+    vector<size_t> counts;
+    vector<size_t> last_seen;
+    size_t tid = 0;
+    scan([&](const int* items, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            int item = items[i];
+            if (item < 0) {
+                continue;
+            }
+            if (static_cast<size_t>(item) >= counts.size()) {
+                counts.resize(item + 1, 0);
+                last_seen.resize(item + 1, static_cast<size_t>(-1));
+            }
+            if (last_seen[item] != tid) {
+                last_seen[item] = tid;
+                counts[item]++;
+            }
+        }
+        tid++;
+    });
+    return counts;
+}
+
+/**
+ * 按已知的支持计数统计频繁项的出现情况
+ */
+template <typename Scan>
+FrequentOccurrence occurrenceOf(const Scan& scan, const vector<size_t>& counts, size_t min_count) {
+    FrequentOccurrence result;
+    vector<size_t> last_seen(counts.size(), static_cast<size_t>(-1));
+    size_t tid = 0;
+    scan([&](const int* items, size_t length) {
+        size_t frequent = 0;
+        for (size_t i = 0; i < length; i++) {
+            int item = items[i];
+            if (item >= 0 && counts[item] >= min_count && last_seen[item] != tid) {
+                last_seen[item] = tid;
+                frequent++;
+            }
+        }
+        result.transactions += frequent > 0 ? 1 : 0;
+        result.occurrences += frequent;
+        result.prefix_items += frequent > 0 ? frequent * (frequent - 1) / 2 : 0;
+        result.record_bytes += sizeof(DataLoader::Record) + length * sizeof(int);
+        tid++;
+    });
+    return result;
+}
+
+// 内存中记录的扫描
+auto scanRecords(const DataLoader::Database& records) {
+    return [&records](const auto& visit) {
+        for (const auto& record : records) {
+            visit(record.data(), record.size());
+        }
+    };
+}
+
+// 投影数据库文件的流式扫描
+auto scanProjection(const string& path) {
+    return [path](const auto& visit) {
+        ProjectionReader reader(path);
+        vector<int> items;
+        while (reader.next(items)) {
+            visit(items.data(), items.size());
+        }
+    };
+}
+
+} // namespace
+
+FrequentOccurrence FrequentOccurrence::of(const DataLoader::Database& records, size_t min_count) {
+    auto scan = scanRecords(records);
+    return occurrenceOf(scan, itemCounts(scan), min_count);
+}
+
+ProjectionWriter::ProjectionWriter(const string& path) : path_(path), file_(path, std::ios::binary | std::ios::trunc) {
+    if (!file_) {
+        throw std::runtime_error("无法创建投影数据库文件: " + path);
+    }
+}
+
+void ProjectionWriter::write(const int* items, size_t length) {
+    body_.clear();
+    int previous = -1;
+    for (size_t i = 0; i < length; i++) {
+        appendVarint(body_, static_cast<uint64_t>(items[i] - previous - 1));
+        previous = items[i];
+    }
+    header_.clear();
+    appendVarint(header_, body_.size());
+    file_.write(header_.data(), static_cast<std::streamsize>(header_.size()));
+    file_.write(body_.data(), static_cast<std::streamsize>(body_.size()));
+    bytes_ += header_.size() + body_.size();
+}
+
+size_t ProjectionWriter::close() {
+    file_.close();
+    if (file_.fail()) {
+        throw std::runtime_error("写入投影数据库文件失败: " + path_);
+    }
+    return bytes_;
+}
+
+ProjectionReader::ProjectionReader(const string& path) : path_(path), file_(path, std::ios::binary) {
+    if (!file_) {
+        throw std::runtime_error("无法读取投影数据库文件: " + path);
+    }
+}
+
+void ProjectionReader::fill(size_t bytes) {
+    if (buffer_.size() - pos_ >= bytes || !file_) {
+        return;
+    }
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+    size_t size = buffer_.size();
+    size_t want = std::max(bytes - size, kChunkBytes);
+    buffer_.resize(size + want);
+    file_.read(&buffer_[size], static_cast<std::streamsize>(want));
+    buffer_.resize(size + static_cast<size_t>(file_.gcount()));
+}
+
+bool ProjectionReader::next(vector<int>& items) {
+    // varint 最多 10 个字节
+    fill(10);
+    if (pos_ == buffer_.size()) {
+        return false;
+    }
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(buffer_.data()) + pos_;
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(buffer_.data()) + buffer_.size();
+    const unsigned char* start = cursor;
+    size_t length = static_cast<size_t>(readVarint(cursor, end));
+    pos_ += static_cast<size_t>(cursor - start);
+    fill(length);
+    if (buffer_.size() - pos_ < length) {
+        throw std::runtime_error("投影数据库文件损坏: " + path_);
+    }
+
+    items.clear();
+    cursor = reinterpret_cast<const unsigned char*>(buffer_.data()) + pos_;
+    end = cursor + length;
+    int previous = -1;
+    while (cursor < end) {
+        previous += 1 + static_cast<int>(readVarint(cursor, end));
+        items.push_back(previous);
+    }
+    pos_ += length;
+    return true;
+}
+
+DataLoader::Database readProjection(const string& path) {
+    DataLoader::Database records;
+    ProjectionReader reader(path);
+    DataLoader::Record record;
+    while (reader.next(record)) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+ProjectedMining::ProjectedMining(Engine engine, Estimator estimate, size_t budget, const string& spill_dir, int thread_count)
+    : engine_(std::move(engine)), estimate_(std::move(estimate)), budget_(budget), worker_budget_(budget),
+      thread_count_(thread_count) {
+    namespace fs = std::filesystem;
+    fs::path base = spill_dir.empty() ? fs::temp_directory_path() : fs::path(spill_dir);
+    std::error_code error;
+    fs::create_directories(base, error);
+    fs::path directory = base / ("dig-projected-" + std::to_string(getpid()) + "-" + std::to_string(next_directory++));
+    if (!fs::create_directories(directory, error) && !fs::is_directory(directory)) {
+        throw std::runtime_error("无法创建临时目录: " + directory.string());
+    }
+    directory_ = directory.string();
+}
+
+ProjectedMining::~ProjectedMining() {
+    std::error_code error;
+    std::filesystem::remove_all(directory_, error);
+}
+
+ProjectedMining::Stats ProjectedMining::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+string ProjectedMining::nextPath() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directory_ + "/p" + std::to_string(next_file_++) + ".bin";
+}
+
+void ProjectedMining::mine(const DataLoader::Database& records, size_t min_count, ItemsetSink& sink) {
+    auto scan = scanRecords(records);
+    mineSource(scan, itemCounts(scan), min_count, sink);
+}
+
+void ProjectedMining::mine(const TransactionFile& file, size_t min_count, ItemsetSink& sink) {
+    mineSource([&file](const Visitor& visit) {
+        file.forEach([&visit](const DataLoader::Record& record) {
+            visit(record.data(), record.size());
+        });
+    }, file.itemSupports(), min_count, sink);
+}
+
+void ProjectedMining::mineSource(const Scan& scan, const vector<size_t>& counts, size_t min_count, ItemsetSink& sink) {
+    stats_ = Stats();
+    // 各线程同时挖掘一个投影，预算平分
+    size_t workers = resolveThreadCount(thread_count_);
+    if (workers > 1) {
+        workers = std::max<size_t>(1, std::min(workers, getThreadPool(workers).get_thread_count()));
+    }
+    stats_.workers = workers;
+    worker_budget_ = budget_ == 0 ? 0 : std::max<size_t>(budget_ / workers, 1);
+
+    vector<int> identity(counts.size());
+    for (size_t i = 0; i < identity.size(); i++) {
+        identity[i] = static_cast<int>(i);
+    }
+    mineLevel(scan, counts, std::max<size_t>(min_count, 1), vector<int>(), identity, sink, 0, workers > 1);
+}
+
+void ProjectedMining::mineLevel(const Scan& scan, const vector<size_t>& counts, size_t min_count, const vector<int>& prefix,
+                                const vector<int>& mapping, ItemsetSink& sink, size_t depth, bool parallel) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.max_depth = std::max(stats_.max_depth, depth + 1);
+    }
+
+    // 频繁项按支持计数降序（相同时按项升序）编号
+    vector<int> frequent;
+    for (size_t item = 0; item < counts.size(); item++) {
+        if (counts[item] >= min_count) {
+            frequent.push_back(static_cast<int>(item));
+        }
+    }
+    std::sort(frequent.begin(), frequent.end(), [&counts](int a, int b) {
+        return counts[a] != counts[b] ? counts[a] > counts[b] : a < b;
+    });
+    vector<int> rank(counts.size(), -1);
+    for (size_t r = 0; r < frequent.size(); r++) {
+        rank[frequent[r]] = static_cast<int>(r);
+    }
+
+    // 前缀加上每个频繁项
+    {
+        SinkWriter writer(sink);
+        vector<int> items = prefix;
+        for (int item : frequent) {
+            items.push_back(mapping[item]);
+            writer.emit(items.data(), items.size(), static_cast<uint32_t>(counts[item]));
+            items.pop_back();
+        }
+        writer.flush();
+    }
+    if (frequent.size() < 2) {
+        return;
+    }
+
+    // 投影 r 的编号为当前层频繁项序号 0 ~ r-1，映射回原始项
+    vector<int> ranked_mapping(frequent.size());
+    for (size_t r = 0; r < frequent.size(); r++) {
+        ranked_mapping[r] = mapping[frequent[r]];
+    }
+    vector<Projection> projections = partition(scan, rank, frequent.size());
+    auto mineOne = [&](const Projection& projection) {
+        vector<int> child_prefix = prefix;
+        child_prefix.push_back(ranked_mapping[projection.rank]);
+        vector<int> child_mapping(ranked_mapping.begin(), ranked_mapping.begin() + projection.rank);
+        mineProjection(projection, min_count, child_prefix, child_mapping, sink, depth + 1);
+    };
+
+    if (!parallel || projections.size() < 2) {
+        for (const auto& projection : projections) {
+            mineOne(projection);
+        }
+        return;
+    }
+
+    // 大的投影先挖，各线程从共享的下标领取，避免单个线程拖尾
+    std::sort(projections.begin(), projections.end(), [](const Projection& a, const Projection& b) {
+        return a.bytes > b.bytes;
+    });
+    auto& pool = getThreadPool(stats_.workers);
+    std::atomic<size_t> next{0};
+    vector<std::future<void>> futures;
+    size_t workers = std::min(stats_.workers, projections.size());
+    for (size_t w = 0; w < workers; w++) {
+        futures.push_back(pool.submit_task([&]() {
+            for (size_t i = next++; i < projections.size(); i = next++) {
+                mineOne(projections[i]);
+            }
+        }));
+    }
+    // 先等所有任务结束再重新抛出异常，任务引用着这里的局部变量
+    for (auto& future : futures) {
+        future.wait();
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+vector<ProjectedMining::Projection> ProjectedMining::partition(const Scan& scan, const vector<int>& rank, size_t frequent_count) {
+    // 把一条事务转换为升序的频繁项序号
+    vector<int> ranks;
+    auto scanRanked = [&](const Visitor& visit) {
+        scan([&](const int* items, size_t length) {
+            ranks.clear();
+            for (size_t i = 0; i < length; i++) {
+                int item = items[i];
+                if (item >= 0 && static_cast<size_t>(item) < rank.size() && rank[item] >= 0) {
+                    ranks.push_back(rank[item]);
+                }
+            }
+            std::sort(ranks.begin(), ranks.end());
+            ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+            if (ranks.size() > 1) {
+                visit(ranks.data(), ranks.size());
+            }
+        });
+    };
+
+    // 需要扫描多遍时先把数据源压缩为一个序号文件，之后各遍读它（比重新解析数据源快，也只含频繁项）
+    Scan source = scanRanked;
+    string ranked_path;
+    if (frequent_count - 1 > kMaxOpenFiles) {
+        ranked_path = nextPath();
+        ProjectionWriter ranked(ranked_path);
+        scanRanked([&ranked](const int* items, size_t length) {
+            ranked.write(items, length);
+        });
+        size_t bytes = ranked.close();
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.spilled_bytes += bytes;
+        source = scanProjection(ranked_path);
+    }
+
+    // 序号 r 的投影为事务中序号小于 r 的频繁项，每遍扫描最多同时写 kMaxOpenFiles 个投影
+    vector<Projection> projections;
+    for (size_t low = 1; low < frequent_count; low += kMaxOpenFiles) {
+        size_t high = std::min(frequent_count, low + kMaxOpenFiles);
+        vector<std::unique_ptr<ProjectionWriter>> writers;
+        size_t first = projections.size();
+        for (size_t r = low; r < high; r++) {
+            projections.push_back(Projection{r, nextPath(), 0});
+            writers.emplace_back(new ProjectionWriter(projections.back().path));
+        }
+        source([&](const int* items, size_t length) {
+            for (size_t p = 1; p < length; p++) {
+                size_t r = static_cast<size_t>(items[p]);
+                if (r >= low && r < high) {
+                    writers[r - low]->write(items, p);
+                }
+            }
+        });
+        size_t bytes = 0;
+        for (size_t w = 0; w < writers.size(); w++) {
+            projections[first + w].bytes = writers[w]->close();
+            bytes += projections[first + w].bytes;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.projections += writers.size();
+        stats_.spilled_bytes += bytes;
+    }
+    if (!ranked_path.empty()) {
+        std::remove(ranked_path.c_str());
+    }
+
+    // 空投影只贡献已经输出的单项
+    projections.erase(std::remove_if(projections.begin(), projections.end(), [](const Projection& projection) {
+        if (projection.bytes == 0) {
+            std::remove(projection.path.c_str());
+            return true;
+        }
+        return false;
+    }), projections.end());
+    return projections;
+}
+
+void ProjectedMining::mineProjection(const Projection& projection, size_t min_count, const vector<int>& prefix,
+                                     const vector<int>& mapping, ItemsetSink& sink, size_t depth) {
+    auto scan = scanProjection(projection.path);
+    bool fit = true;
+    vector<size_t> counts;
+    if (worker_budget_ > 0) {
+        // 投影本身（记录 + 大小相当的倒排索引）加上常规引擎的估算
+        counts = itemCounts(scan);
+        FrequentOccurrence occurrence = occurrenceOf(scan, counts, min_count);
+        fit = occurrence.record_bytes * 2 + estimate_(occurrence) <= worker_budget_;
+    }
+    if (!fit && depth < kMaxDepth) {
+        mineLevel(scan, counts, min_count, prefix, mapping, sink, depth, false);
+        std::remove(projection.path.c_str());
+        return;
+    }
+
+    DataLoader::Database records = readProjection(projection.path);
+    std::remove(projection.path.c_str());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.in_memory++;
+        stats_.over_budget += fit ? 0 : 1;
+    }
+    DataLoader db(std::move(records), 1);
+    PrefixSink prefix_sink(sink, prefix, mapping);
+    engine_(db, min_count, prefix_sink);
+}
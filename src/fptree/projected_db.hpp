@@ -0,0 +1,223 @@
+#ifndef PROJECTED_DB_HPP
+#define PROJECTED_DB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "dataload/transaction_file.hpp"
+#include "result/sink.hpp"
+
+/**
+ * 数据集中频繁项的出现情况，用于估算 FP-Growth 的内存
+ */
+struct FrequentOccurrence {
+    size_t transactions = 0;   // 至少包含一个频繁项的事务数
+    size_t occurrences = 0;    // 频繁项出现的总次数（FP树节点数的上界）
+    size_t prefix_items = 0;   // 每条事务中每个频繁项之前的频繁项数之和（路径列表条件模式基的上界）
+    size_t record_bytes = 0;   // 全部事务载入内存后占用的字节数
+
+    /**
+     * 统计记录中支持计数不低于 min_count 的项（同一事务中重复的项只计一次）
+     */
+    static FrequentOccurrence of(const DataLoader::Database& records, size_t min_count);
+};
+
+/**
+ * 投影数据库文件：每条事务为 varint 字节数 + 升序项的 varint 差值
+ */
+class ProjectionWriter {
+public:
+    /**
+     * @throws std::runtime_error 文件无法创建
+     */
+    explicit ProjectionWriter(const std::string& path);
+
+    /**
+     * 追加一条事务（items 须为升序且不重复）
+     */
+    void write(const int* items, size_t length);
+
+    /**
+     * 写出缓冲并关闭文件
+     * @return 文件字节数
+     * @throws std::runtime_error 写入失败
+     */
+    size_t close();
+
+private:
+    std::string path_;
+    std::ofstream file_;
+    std::string body_;
+    std::string header_;
+    size_t bytes_ = 0;
+};
+
+/**
+ * 顺序读取投影数据库文件，只缓冲一小块，不把整个文件读入内存
+ */
+class ProjectionReader {
+public:
+    /**
+     * @throws std::runtime_error 文件无法打开
+     */
+    explicit ProjectionReader(const std::string& path);
+
+    /**
+     * 读取下一条事务
+     * @return 文件已读完时为 false
+     * @throws std::runtime_error 数据损坏
+     */
+    bool next(std::vector<int>& items);
+
+private:
+    // 读缓冲的大小
+    static constexpr size_t kChunkBytes = 1 << 16;
+
+    /**
+     * 保证缓冲中从 pos_ 起至少有 bytes 个字节（文件不够时读到结尾为止）
+     */
+    void fill(size_t bytes);
+
+    std::string path_;
+    std::ifstream file_;
+    std::string buffer_;
+    size_t pos_ = 0;
+};
+
+/**
+ * 把整个投影数据库读入内存
+ * @throws std::runtime_error 文件无法读取或数据损坏
+ */
+DataLoader::Database readProjection(const std::string& path);
+
+/**
+ * 投影数据库模式的 FP-Growth（外存挖掘）：
+ * 数据库按频繁项划分为每个项的投影数据库写到磁盘，再逐个读回，在放得进预算的投影上运行常规引擎；
+ * 项 i 的投影由包含 i 的事务中比 i 更频繁的项组成，以 i 为最不频繁项的频繁项集 = {i} ∪ 投影中的频繁项集。
+ * 投影之间相互独立，在线程池上并行挖掘（每个投影单线程运行引擎），投影仍然放不下时在同一线程内递归划分。
+ * 投影中的项重新编号为频繁项序号，结果输出时映射回原始项。
+ * 数据源可以是内存中的记录，也可以是流式读取的事务文件，后者全程不需要把数据集载入内存。
+ */
+class ProjectedMining {
+public:
+    // 在一个（投影）数据集上单线程运行常规引擎，结果推送到 sink（不调用 finish）
+    using Engine = std::function<void(const DataLoader& db, size_t min_count, ItemsetSink& sink)>;
+    // 估算常规引擎单线程挖掘需要的字节数（不含数据集本身）
+    using Estimator = std::function<size_t(const FrequentOccurrence& occurrence)>;
+
+    // 最多划分的层数，超过后直接在内存中挖掘
+    static constexpr size_t kMaxDepth = 8;
+    // 一遍扫描中同时打开的投影文件数上限
+    static constexpr size_t kMaxOpenFiles = 256;
+
+    struct Stats {
+        size_t projections = 0;     // 写出的投影数据库数
+        size_t spilled_bytes = 0;   // 写到磁盘的字节数（含中间文件）
+        size_t in_memory = 0;       // 在内存中挖掘的投影数
+        size_t max_depth = 0;       // 最多划分了几层（1 表示没有递归划分）
+        size_t over_budget = 0;     // 达到最大深度仍超出预算、只能直接挖掘的投影数
+        size_t workers = 1;         // 并行挖掘投影的线程数
+    };
+
+    /**
+     * @param engine 常规引擎
+     * @param estimate 常规引擎的内存估算
+     * @param budget 可用字节数，0 表示不限制（每个投影都直接在内存中挖掘）；并行时每个线程各占一份
+     * @param spill_dir 临时目录的父目录，为空时使用系统临时目录
+     * @param thread_count 并行挖掘投影的线程数，0 为硬件并发数
+     */
+    ProjectedMining(Engine engine, Estimator estimate, size_t budget, const std::string& spill_dir, int thread_count);
+
+    /**
+     * 删除临时目录
+     */
+    ~ProjectedMining();
+
+    ProjectedMining(const ProjectedMining&) = delete;
+    ProjectedMining& operator=(const ProjectedMining&) = delete;
+
+    /**
+     * 挖掘内存中的记录的全部频繁项集，推送到 sink（不调用 finish）
+     * @throws std::runtime_error 临时文件无法读写
+     */
+    void mine(const DataLoader::Database& records, size_t min_count, ItemsetSink& sink);
+
+    /**
+     * 流式挖掘事务文件（文件会被顺序扫描若干遍）
+     * @throws std::runtime_error 数据文件或临时文件无法读写
+     */
+    void mine(const TransactionFile& file, size_t min_count, ItemsetSink& sink);
+
+    Stats stats() const;
+
+    /**
+     * 临时文件所在的目录
+     */
+    const std::string& directory() const noexcept {
+        return directory_;
+    }
+
+private:
+    // 数据源：每次调用从头扫描一遍，对每条事务调用 visit(items, length)
+    using Visitor = std::function<void(const int* items, size_t length)>;
+    using Scan = std::function<void(const Visitor& visit)>;
+
+    // 写到磁盘的一个投影
+    struct Projection {
+        size_t rank;        // 投影对应的项在当前层的频繁项序号
+        std::string path;
+        size_t bytes;
+    };
+
+    /**
+     * 挖掘一个数据源，按需要并行挖掘各投影
+     * @param counts 各项的支持计数，下标为项
+     */
+    void mineSource(const Scan& scan, const std::vector<size_t>& counts, size_t min_count, ItemsetSink& sink);
+
+    /**
+     * 挖掘一个（投影）数据集
+     * @param scan 数据源，项为当前层的编号
+     * @param counts 当前层各项的支持计数
+     * @param prefix 已确定的前缀（原始项）
+     * @param mapping 当前层编号 -> 原始项
+     * @param parallel 是否在线程池上并行挖掘各投影（只用于最外层，线程池任务内部不能再等待线程池）
+     */
+    void mineLevel(const Scan& scan, const std::vector<size_t>& counts, size_t min_count, const std::vector<int>& prefix,
+                   const std::vector<int>& mapping, ItemsetSink& sink, size_t depth, bool parallel);
+
+    /**
+     * 按频繁项序号把数据源写成各项的投影（序号 0 的投影为空，不写出）
+     * @param rank 当前层编号 -> 频繁项序号，非频繁项为 -1
+     */
+    std::vector<Projection> partition(const Scan& scan, const std::vector<int>& rank, size_t frequent_count);
+
+    /**
+     * 挖掘一个投影：放得进预算时读入内存运行引擎，否则继续划分
+     */
+    void mineProjection(const Projection& projection, size_t min_count, const std::vector<int>& prefix,
+                        const std::vector<int>& mapping, ItemsetSink& sink, size_t depth);
+
+    /**
+     * 分配一个新的临时文件路径
+     */
+    std::string nextPath();
+
+    Engine engine_;
+    Estimator estimate_;
+    size_t budget_;
+    size_t worker_budget_;
+    int thread_count_;
+    std::string directory_;
+
+    mutable std::mutex mutex_;   // 保护 next_file_ 和 stats_
+    size_t next_file_ = 0;
+    Stats stats_;
+};
+
+#endif // PROJECTED_DB_HPP
@@ -1,14 +1,460 @@
+#include "cli/bench.hpp"
+#include "cli/console_silencer.hpp"
+#include "cli/mine_command.hpp"
+#include "cli/options.hpp"
 #include "dataload/data_loader.hpp"
-#include "apriori/apr.hpp"
-#include "fptree/fp.hpp"
+#include "dataload/quest_generator.hpp"
+#include "miner/miner.hpp"
+#include "miner/result_cache.hpp"
+#include "query/support_query.hpp"
+#include "result/file_sink.hpp"
+#include "result/result_file.hpp"
+#include "result/verify.hpp"
+#include "rules/association.hpp"
+#include "server/daemon.hpp"
+#include "shard/sharded.hpp"
+#include "topk/topk.hpp"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using std::cout;
 using std::cin;
 using std::endl;
 
-int main() {
+// 按level打印项集数量（ItemsetPool 或 CountingSink）
+template <typename Levels>
+static void printLevels(const Levels& itemsets) {
+    for(size_t lc = 0; lc < itemsets.levelCount(); lc++){
+        if(itemsets.levelSize(lc) == 0) break;
+
+        cout << "level: " << lc << " " << itemsets.levelSize(lc) << endl;
+    }
+}
+
+// dig convert <结果.bin> <输出.txt>：把二进制结果文件转换为文本格式
+static int convertCommand(const std::string& input, const std::string& output) {
+    ResultFile results(input);
+    std::ofstream out(output, std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!out.is_open()){
+        std::cerr << "无法打开输出文件: " << output << endl;
+        return 1;
+    }
+    writeTextReport(results, out);
+    cout << "已转换 " << results.size() << " 个频繁项集: " << input << " -> " << output << endl;
+    return 0;
+}
+
+// dig verify <标准结果> <结果文件> [线程数]：校验结果文件，一致时返回0
+static int verifyCommand(const std::string& reference, const std::string& result, int threads) {
+    auto start = std::chrono::high_resolution_clock::now();
+    ItemsetPool expected, actual;
+    loadResultFile(reference, expected, threads);
+    loadResultFile(result, actual, threads);
+    VerifyReport report = verifyResults(expected, actual, threads);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    printVerifyReport(report, cout);
+    cout << "校验耗时: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return report.ok() ? 0 : 1;
+}
+
+// dig rules <结果文件> <最小置信度> [规则输出文件|-] [事务总数]：由频繁项集生成关联规则
+// 二进制结果文件自带事务总数，文本结果文件需要给出（否则提升度和杠杆率为0）
+static int rulesCommand(const std::string& input, double min_confidence, const std::string& output, size_t transactions) {
+    ItemsetPool itemsets;
+    loadResultFile(input, itemsets);
+    if(transactions == 0 && isResultFile(input)){
+        transactions = ResultFile(input).transactionCount();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    CountingRuleSink counter;
+    std::unique_ptr<TextRuleSink> file_sink;
+    if(output != "-"){
+        file_sink = std::make_unique<TextRuleSink>(output);
+    }
+    struct TeeRuleSink : public RuleSink {
+        RuleSink* first;
+        RuleSink* second;
+        void consume(const RuleBatch& batch) override {
+            first->consume(batch);
+            if (second) second->consume(batch);
+        }
+        void finish() override {
+            first->finish();
+            if (second) second->finish();
+        }
+    } sink;
+    sink.first = &counter;
+    sink.second = file_sink.get();
+
+    RuleGenerator generator(itemsets, transactions, min_confidence);
+    generator.generate(sink);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    cout << "频繁项集: " << itemsets.size() << "，最小置信度: " << min_confidence
+         << "，生成规则: " << counter.size() << " 条" << endl;
+    if(file_sink){
+        cout << "规则已写入: " << output << endl;
+    }
+    cout << "规则生成耗时: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return 0;
+}
+
+// dig topk <K> [最大长度] [线程数] [输出文件|-] [-i 数据文件] [-d 分隔符]：不设最小支持度，直接取支持计数最高的K个项集
+// 最大长度大于0时 1~最大长度 项集各取K个
+static int topkCommand(const InputOptions& data, size_t k, size_t max_length, int threads, const std::string& output) {
+    DataLoader loader(data.input, data.delimiter, threads);
+    auto start = std::chrono::high_resolution_clock::now();
+    TopK topk(loader, k, max_length, threads);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    const auto& itemsets = topk.getTopItemsets();
+    printLevels(itemsets);
+    if(output != "-"){
+        TextFileSink file(output);
+        file.consume(itemsets);
+        file.finish();
+        cout << "结果已写入: " << output << endl;
+    } else {
+        // 按支持计数降序列出前几个
+        std::vector<ItemsetPool::ItemsetView> views;
+        itemsets.forEach([&views](const ItemsetPool::ItemsetView& view) { views.push_back(view); });
+        std::stable_sort(views.begin(), views.end(), [](const ItemsetPool::ItemsetView& a, const ItemsetPool::ItemsetView& b) {
+            return a.support > b.support;
+        });
+        for(size_t i = 0; i < views.size() && i < 20; i++){
+            cout << "  [";
+            for(uint32_t j = 0; j < views[i].length; j++){
+                cout << (j > 0 ? ", " : "") << views[i].items[j];
+            }
+            cout << "]: 支持计数=" << views[i].support << "\n";
+        }
+    }
+    cout << "最终支持计数阈值: " << topk.finalThreshold() << "，挖掘耗时: "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return 0;
+}
+
+// dig sweep <引擎> <支持度列表> [线程数] [缓存目录] [-i 数据文件] [-d 分隔符]：同一数据集上扫描多个支持度阈值
+// 先以最低阈值挖掘一次，其余阈值从缓存中过滤得到；指定缓存目录时结果跨进程复用
+static int sweepCommand(const InputOptions& input, const std::string& engine_name, const std::string& supports, int threads,
+                        const std::string& directory) {
+    auto& registry = MinerRegistry::instance();
+    const MinerRegistry::Entry* engine = nullptr;
+    for(const auto& entry : registry.entries()){
+        if(entry.name == engine_name) engine = &entry;
+    }
+    if(engine == nullptr){
+        std::cerr << "未知的挖掘引擎: " << engine_name << endl;
+        return 1;
+    }
+
+    std::vector<double> thresholds;
+    std::stringstream list(supports);
+    for(std::string token; std::getline(list, token, ',');){
+        if(!token.empty()) thresholds.push_back(std::stod(token));
+    }
+    if(thresholds.empty()){
+        std::cerr << "支持度列表为空" << endl;
+        return 1;
+    }
+
+    DataLoader loader(input.input, input.delimiter, threads);
+    DatasetView data(loader);
+    uint64_t fingerprint = datasetFingerprint(data, threads);
+    ResultCache cache(directory);
+    auto miner = registry.create(engine->name, threads);
+
+    // 最低阈值先挖：之后的阈值都能由它过滤得到
+    size_t lowest = 0;
+    for(size_t i = 1; i < thresholds.size(); i++){
+        if(SupportThreshold{thresholds[i]}.resolve(data.transactionCount()) <
+           SupportThreshold{thresholds[lowest]}.resolve(data.transactionCount())) lowest = i;
+    }
+    std::vector<size_t> order{lowest};
+    for(size_t i = 0; i < thresholds.size(); i++){
+        if(i != lowest) order.push_back(i);
+    }
+
+    std::vector<std::string> lines(thresholds.size());
+    auto start = std::chrono::high_resolution_clock::now();
+    for(size_t i : order){
+        SupportThreshold threshold{thresholds[i]};
+        CountingSink counter;
+        auto step_start = std::chrono::high_resolution_clock::now();
+        bool hit = cache.mine(*miner, *engine, data, fingerprint, threshold, counter);
+        auto step_end = std::chrono::high_resolution_clock::now();
+        std::ostringstream line;
+        line << "  " << thresholds[i] << " (支持计数 " << threshold.resolve(data.transactionCount()) << "): "
+             << counter.size() << " 个项集, " << (hit ? "缓存" : "挖掘") << " "
+             << std::chrono::duration_cast<std::chrono::milliseconds>(step_end - step_start).count() << " ms";
+        lines[i] = line.str();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    cout << "\n========== 支持度扫描 (" << engine->name << ") ==========" << endl;
+    for(const auto& line : lines){
+        cout << line << "\n";
+    }
+    cout << "缓存命中 " << cache.hits() << " 次，未命中 " << cache.misses() << " 次，总耗时: "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return 0;
+}
+
+// dig serve <套接字> [请求线程数] [挖掘线程数] [名称=文件 ...] [-i 数据文件] [-d 分隔符]：常驻服务，数据集只加载一次
+// -i 的数据集以文件名（去掉目录和扩展名）为名称；未指定任何数据集时加载 retail=retail.csv；分隔符对全部数据集生效
+static int serveCommand(const InputOptions& input, const std::vector<std::string>& args) {
+    std::string socket_path = args[0];
+    int request_threads = 0;
+    int mine_threads = 1;
+    std::vector<std::pair<std::string, std::string>> datasets;
+    int numbers = 0;
+    for(size_t i = 1; i < args.size(); i++){
+        const std::string& arg = args[i];
+        size_t eq = arg.find('=');
+        if(eq != std::string::npos){
+            datasets.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+        } else if(numbers++ == 0){
+            request_threads = std::stoi(arg);
+        } else {
+            mine_threads = std::stoi(arg);
+        }
+    }
+    if(input.input_given || datasets.empty()){
+        std::string name = input.input.substr(input.input.find_last_of('/') + 1);
+        datasets.emplace_back(name.substr(0, name.find_last_of('.')), input.input);
+    }
+
+    MiningDaemon daemon(socket_path, request_threads, mine_threads);
+    for(const auto& dataset : datasets){
+        daemon.addDataset(dataset.first, dataset.second, input.delimiter);
+    }
+    daemon.run();
+    return 0;
+}
+
+// dig support <查询文件> [线程数] [-i 数据文件] [-d 分隔符]：查询文件每行一个项集（项以空格分隔），输出每个项集的支持计数
+static int supportCommand(const InputOptions& data, const std::string& input, int threads) {
+    std::ifstream in(input);
+    if(!in.is_open()){
+        std::cerr << "无法打开查询文件: " << input << endl;
+        return 1;
+    }
+    std::vector<std::vector<int>> itemsets;
+    for(std::string line; std::getline(in, line);){
+        std::istringstream fields(line);
+        itemsets.emplace_back();
+        for(int item; fields >> item;){
+            itemsets.back().push_back(item);
+        }
+    }
+
+    DataLoader loader(data.input, data.delimiter, threads);
+    SupportQuery query(loader);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<uint32_t> supports = query.supportBatch(itemsets, threads);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    for(size_t i = 0; i < itemsets.size(); i++){
+        cout << "  [";
+        for(size_t j = 0; j < itemsets[i].size(); j++){
+            cout << (j > 0 ? ", " : "") << itemsets[i][j];
+        }
+        cout << "]: 支持计数=" << supports[i] << "\n";
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    cout << "查询 " << itemsets.size() << " 个项集，耗时: " << us << " us" << endl;
+    return 0;
+}
+
+// dig generate <输出文件> <参数列表> [线程数]：生成 IBM Quest 风格的合成事务数据
+static int generateCommand(const std::string& output, const std::string& spec, int threads) {
+    QuestParams params = QuestParams::parse(spec);
+    auto start = std::chrono::high_resolution_clock::now();
+    QuestGenerator generator(params);
+    generator.writeCsv(output, ' ', threads);
+    auto end = std::chrono::high_resolution_clock::now();
+    cout << "已生成 " << params.transactions << " 个事务（平均长度 " << params.avg_length << "，项数 " << params.items
+         << "，模式数 " << params.patterns << "，种子 " << params.seed << "）: " << output << "，耗时 "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms" << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    // 多进程分片挖掘的工作进程，由 dig mine --shards 启动，不直接使用
+    if(argc == 3 && std::string(argv[1]) == "shard-worker"){
+        // 标准输出与协调进程共用，引擎的进度输出会混进汇总
+        ConsoleSilencer mute(true);
+        return runShardWorker(std::stoi(argv[2]));
+    }
+    if(argc >= 2 && std::string(argv[1]) == "convert"){
+        if(argc != 4){
+            std::cerr << "用法: " << argv[0] << " convert <结果.bin> <输出.txt>" << endl;
+            return 1;
+        }
+        try {
+            return convertCommand(argv[2], argv[3]);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "rules"){
+        if(argc < 4 || argc > 6){
+            std::cerr << "用法: " << argv[0] << " rules <结果文件> <最小置信度> [规则输出文件|-] [事务总数]" << endl;
+            return 1;
+        }
+        try {
+            return rulesCommand(argv[2], std::stod(argv[3]), argc >= 5 ? argv[4] : "-",
+                                argc == 6 ? std::stoul(argv[5]) : 0);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "topk"){
+        try {
+            std::vector<std::string> args;
+            InputOptions data = parseInputOptions(argc, argv, 2, args);
+            if(args.empty() || args.size() > 4){
+                std::cerr << "用法: " << argv[0] << " topk <K> [最大长度] [线程数] [输出文件|-] [-i 数据文件] [-d 分隔符]" << endl;
+                return 1;
+            }
+            return topkCommand(data, std::stoul(args[0]), args.size() >= 2 ? std::stoul(args[1]) : 0,
+                               args.size() >= 3 ? std::stoi(args[2]) : 1, args.size() >= 4 ? args[3] : "-");
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "sweep"){
+        try {
+            std::vector<std::string> args;
+            InputOptions data = parseInputOptions(argc, argv, 2, args);
+            if(args.size() < 2 || args.size() > 4){
+                std::cerr << "用法: " << argv[0] << " sweep <引擎> <支持度1,支持度2,...> [线程数] [缓存目录] [-i 数据文件] [-d 分隔符]" << endl;
+                return 1;
+            }
+            return sweepCommand(data, args[0], args[1], args.size() >= 3 ? std::stoi(args[2]) : 1,
+                                args.size() == 4 ? args[3] : "");
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "serve"){
+        try {
+            std::vector<std::string> args;
+            InputOptions data = parseInputOptions(argc, argv, 2, args);
+            if(args.empty()){
+                std::cerr << "用法: " << argv[0] << " serve <套接字路径> [请求线程数] [挖掘线程数] [名称=文件 ...] [-i 数据文件] [-d 分隔符]" << endl;
+                return 1;
+            }
+            return serveCommand(data, args);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "query"){
+        if(argc < 4){
+            std::cerr << "用法: " << argv[0] << " query <套接字路径> <请求...>（如 SUPPORT retail 39 48）" << endl;
+            return 1;
+        }
+        std::string request;
+        for(int i = 3; i < argc; i++){
+            request += (i > 3 ? " " : "") + std::string(argv[i]);
+        }
+        try {
+            return queryDaemon(argv[2], request, cout);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 2;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "support"){
+        try {
+            std::vector<std::string> args;
+            InputOptions data = parseInputOptions(argc, argv, 2, args);
+            if(args.empty() || args.size() > 2){
+                std::cerr << "用法: " << argv[0] << " support <查询文件> [线程数] [-i 数据文件] [-d 分隔符]" << endl;
+                return 1;
+            }
+            return supportCommand(data, args[0], args.size() == 2 ? std::stoi(args[1]) : 1);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "generate"){
+        if(argc != 4 && argc != 5){
+            std::cerr << "用法: " << argv[0] << " generate <输出文件> <参数列表> [线程数]" << endl;
+            std::cerr << "  参数列表如 transactions=1000000,avg-length=10,items=1000,patterns=2000,pattern-length=4,"
+                      << "correlation=0.5,corruption=0.5,seed=1" << endl;
+            return 1;
+        }
+        try {
+            return generateCommand(argv[2], argv[3], argc == 5 ? std::stoi(argv[4]) : 0);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "mine"){
+        if(argc == 3 && (std::string(argv[2]) == "-h" || std::string(argv[2]) == "--help")){
+            printMineUsage(cout, argv[0], "mine");
+            return 0;
+        }
+        try {
+            return runMineCommand(parseMineOptions(argc, argv, 2));
+        } catch(const std::invalid_argument& e) {
+            std::cerr << e.what() << endl;
+            printMineUsage(std::cerr, argv[0], "mine");
+            return 1;
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "bench"){
+        if(argc == 3 && (std::string(argv[2]) == "-h" || std::string(argv[2]) == "--help")){
+            printMineUsage(cout, argv[0], "bench");
+            return 0;
+        }
+        MineOptions defaults;
+        defaults.warmup = 1;
+        defaults.repeat = 5;
+        try {
+            return runBenchCommand(parseMineOptions(argc, argv, 2, defaults));
+        } catch(const std::invalid_argument& e) {
+            std::cerr << e.what() << endl;
+            printMineUsage(std::cerr, argv[0], "bench");
+            return 1;
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 1;
+        }
+    }
+    if(argc >= 2 && std::string(argv[1]) == "verify"){
+        if(argc != 4 && argc != 5){
+            std::cerr << "用法: " << argv[0] << " verify <标准结果> <结果文件> [线程数]" << endl;
+            return 2;
+        }
+        try {
+            return verifyCommand(argv[2], argv[3], argc == 5 ? std::stoi(argv[4]) : 0);
+        } catch(const std::exception& e) {
+            std::cerr << e.what() << endl;
+            return 2;
+        }
+    }
+
     // 总开始时间
     auto total_start = std::chrono::high_resolution_clock::now();
 
@@ -21,10 +467,21 @@ int main() {
     double confidence;
     cin >> confidence;
 
-    cout<<"检验哪种算法： 1.Apriori 2.FPTree ";
-    int choose;
+    // 可选引擎来自注册表，最后一项为全部引擎对比
+    auto& registry = MinerRegistry::instance();
+    const auto& engines = registry.entries();
+    cout<<"检验哪种算法：";
+    for(size_t i = 0; i < engines.size(); i++){
+        cout << " " << i + 1 << "." << engines[i].name;
+    }
+    cout << " " << engines.size() + 1 << ".全部对比 ";
+    size_t choose;
     cin>>choose;
 
+    cout << "结果输出文件（- 表示只统计数量，以 .bin 结尾为二进制格式）: ";
+    std::string output;
+    cin >> output;
+
     
 
     // 数据加载和转换计时
@@ -45,60 +502,87 @@ int main() {
     cout << "  - 最大元素值: " << loader.getMaxValue() << endl;
     cout << "  - 耗时: " << data_load_duration.count() << " ms" << endl;
 
+    DatasetView data(loader);
+    SupportThreshold threshold{confidence};
+    cout << "\n使用最小支持度: " << confidence
+         << " (最小支持计数: " << threshold.resolve(data.transactionCount()) << ")" << endl;
 
-    if (choose == 1) {
-    // Apriori 算法
-    cout << "\n使用置信度: " << confidence << endl;
+    if (choose >= 1 && choose <= engines.size()) {
+        const auto& engine = engines[choose - 1];
+        auto miner = registry.create(engine.name, co);
 
-    // Apriori 算法计时
-    auto apriori_start = std::chrono::high_resolution_clock::now();
-    
-    // 创建 Apriori 实例并执行算法
-    Apriori apriori(loader, confidence, co);
-    
-    auto apriori_end = std::chrono::high_resolution_clock::now();
-    auto apriori_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        apriori_end - apriori_start
-    );
+        // 挖掘计时
+        auto mine_start = std::chrono::high_resolution_clock::now();
+
+        // 结果边挖掘边推送：计数接收端不保存项集，文件接收端成批写出
+        CountingSink counter;
+        std::unique_ptr<ItemsetSink> file_sink;
+        if (output != "-") {
+            bool binary = output.size() > 4 && output.compare(output.size() - 4, 4, ".bin") == 0;
+            if (binary) {
+                file_sink = std::make_unique<BinaryFileSink>(output, data.transactionCount(),
+                    threshold.resolve(data.transactionCount()), confidence);
+            } else {
+                file_sink = std::make_unique<TextFileSink>(output);
+            }
+        }
 
+        TeeSink sink(counter, file_sink.get());
 
-    // 输出结果
-    cout << "\n========== 性能统计 ==========" << endl;
-    cout << "数据加载和转换时间: " << data_load_duration.count() << " ms" << endl;
-    cout << "Apriori 算法时间: " << apriori_duration.count() << " ms" << endl;
-    cout<<"total time: "<<data_load_duration.count()+apriori_duration.count()<<" ms"<<endl;
-    cout << "================================" << endl;
-    
-    // 显示所有level的结果
-    apriori.displayAllLevels(); 
-    } else if (choose == 2) {
-        // FP-Tree 算法
-        cout << "\n使用最小支持度: " << confidence << endl;
-        
-        // FP-Tree 算法计时
-        auto fptree_start = std::chrono::high_resolution_clock::now();
-        
-        FPTree fptree(loader, confidence);
-        
-        auto fptree_end = std::chrono::high_resolution_clock::now();
-        auto fptree_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-            fptree_end - fptree_start
-        );
+        miner->mine(data, threshold, sink);
 
-        auto& frequent_itemsets = fptree.levels;
-        int lc = 0;
-        for(const auto& level : frequent_itemsets){
-            if(level.empty()) break;
+        auto mine_end = std::chrono::high_resolution_clock::now();
+        auto mine_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+            mine_end - mine_start
+        );
 
-            cout << "level: " << lc << " " << level.size() << endl;
-            lc++;
+        printLevels(counter);
+        if (file_sink) {
+            cout << "结果已写入: " << output << endl;
         }
-        
+
         // 输出结果
         cout << "\n========== 性能统计 ==========" << endl;
         cout << "数据加载和转换时间: " << data_load_duration.count() << " ms" << endl;
-        cout << "FP-Tree 算法时间: " << fptree_duration.count() << " ms" << endl;
-        cout << "total time: " << data_load_duration.count() + fptree_duration.count() << " ms" << endl;
+        cout << engine.name << " 算法时间: " << mine_duration.count() << " ms" << endl;
+        cout << "total time: " << data_load_duration.count() + mine_duration.count() << " ms" << endl;
+        cout << "================================" << endl;
+    } else if (choose == engines.size() + 1) {
+        // 所有引擎在同一份数据上对比，每个引擎以同种类（全部/闭/最大项集）的第一个引擎为基准
+        struct Run {
+            std::string name;
+            ItemsetKind kind;
+            long long ms;
+            CollectSink sink;
+        };
+        std::vector<std::unique_ptr<Run>> runs;
+        for (const auto& engine : engines) {
+            auto run = std::make_unique<Run>();
+            run->name = engine.name;
+            run->kind = engine.kind;
+            auto miner = registry.create(engine.name, co);
+            auto mine_start = std::chrono::high_resolution_clock::now();
+            miner->mine(data, threshold, run->sink);
+            auto mine_end = std::chrono::high_resolution_clock::now();
+            run->ms = std::chrono::duration_cast<std::chrono::milliseconds>(mine_end - mine_start).count();
+            runs.push_back(std::move(run));
+        }
+
+        cout << "\n========== 引擎对比 ==========" << endl;
+        for (const auto& run : runs) {
+            const Run* baseline = nullptr;
+            for (const auto& other : runs) {
+                if (other->kind == run->kind) {
+                    baseline = other.get();
+                    break;
+                }
+            }
+            const auto& itemsets = run->sink.itemsets();
+            cout << run->name << " (" << itemsetKindName(run->kind) << "): " << run->ms << " ms, " << itemsets.size()
+                 << " 个项集, 结果内存 " << itemsets.memoryBytes() / 1024 << " KB"
+                 << ", 与 " << baseline->name << " 一致: "
+                 << (verifyResults(baseline->sink.itemsets(), itemsets, co).ok() ? "是" : "否") << endl;
+        }
         cout << "================================" << endl;
     }
     return 0;
@@ -0,0 +1,274 @@
+#include "mafia.hpp"
+#include "miner/support.hpp"
+#include "miner/tidlist.hpp"
+#include "profile/profiler.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+Mafia::Mafia(const DataLoader& db, double min_support, int thread_count, ItemsetSink* sink)
+    : db_(db), min_support_(min_support), min_support_count_(0), thread_count_(thread_count), found_(0), sink_(sink) {
+
+    min_support_count_ = static_cast<int>(resolveSupportCount(min_support, db_.all_count));
+
+    cout << "\n========== MAFIA 最大项集算法 ==========" << endl;
+    cout << "最小支持度: " << min_support_ << " (最小支持计数: " << min_support_count_ << ")" << endl;
+
+    auto begintime = std::chrono::high_resolution_clock::now();
+
+    const auto& inverted_index = db_.getInvertedIndex();
+    vector<TailItem> items;
+    for (size_t item = 0; item < inverted_index.size(); item++) {
+        if (inverted_index[item].size() >= static_cast<size_t>(min_support_count_)) {
+            items.push_back(TailItem{static_cast<int>(item), inverted_index[item]});
+        }
+    }
+    // 按支持计数升序：支持计数小的项先分支，子树更小，后面的分支更容易被 HUTMFI 剪掉
+    std::stable_sort(items.begin(), items.end(), [](const TailItem& a, const TailItem& b) {
+        return a.tids.size() < b.tids.size();
+    });
+    cout << "频繁1项集: " << items.size() << " 个" << endl;
+    MemoryCharge root_memory(MemoryCategory::TidLists, tidListBytes(items));
+
+    size_t item_range = static_cast<size_t>(db_.getMaxValue()) + 1;
+    vector<MaximalSet> parts;
+    size_t workers = thread_count_ > 1 ? static_cast<size_t>(thread_count_) : 1;
+    if (workers == 1) {
+        parts.emplace_back(item_range);
+        mineRoot(items, 0, items.size(), parts[0]);
+    } else {
+        // 顶层项分块，每块一个候选集合
+        size_t blocks = std::max<size_t>(1, std::min(items.size(), workers * 4));
+        size_t block_size = (items.size() + blocks - 1) / blocks;
+        for (size_t b = 0; b < blocks; b++) {
+            parts.emplace_back(item_range);
+        }
+        parallelFor(blocks, workers, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; b++) {
+                size_t first = b * block_size;
+                size_t last = std::min(items.size(), first + block_size);
+                if (first < last) {
+                    mineRoot(items, first, last, parts[b]);
+                }
+            }
+        });
+    }
+
+    MemoryCharge parts_memory;
+    if (MemoryTracker::enabled()) {
+        size_t bytes = 0;
+        for (const auto& part : parts) {
+            bytes += part.memoryBytes();
+        }
+        parts_memory.set(MemoryCategory::Results, bytes);
+    }
+    emitMaximal(parts);
+
+    auto endtime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - begintime);
+    cout << "MAFIA算法完成！共找到 " << found_ << " 个最大频繁项集，耗时: " << duration.count() << "ms" << endl;
+}
+
+void Mafia::mineRoot(const vector<TailItem>& items, size_t first, size_t last, MaximalSet& out) const {
+    ProfileScope scope("mafia.mine_root");
+    size_t need = static_cast<size_t>(min_support_count_);
+    const auto& records = db_.getOriginalData();
+    vector<int> position(db_.getMaxValue() + 1, -1);
+    for (size_t k = 0; k < items.size(); k++) {
+        position[items[k].item] = static_cast<int>(k);
+    }
+
+    vector<uint32_t> cooccur(items.size(), 0);
+    vector<size_t> siblings;
+    vector<int> head;
+    vector<int> hut;
+    for (size_t i = first; i < last; i++) {
+        // 顶层只和共现次数达标的兄弟求交
+        cooccurringSiblings(records, items[i].tids, position, i, need, cooccur, siblings);
+
+        // 求交之前先做 HUTMFI：{i} ∪ 所有候选兄弟 已被包含则整个分支跳过
+        hut.assign(1, items[i].item);
+        for (size_t j : siblings) {
+            hut.push_back(items[j].item);
+        }
+        std::sort(hut.begin(), hut.end());
+        if (out.subsumed(hut)) {
+            continue;
+        }
+
+        head.assign(1, items[i].item);
+        vector<TailItem> tail;
+        vector<int> tids;
+        uint64_t pruned = 0;
+        for (size_t j : siblings) {
+            if (!intersectTids(items[i].tids, items[j].tids, need, tids)) {
+                pruned++;
+                continue;
+            }
+            if (tids.size() == items[i].tids.size()) {
+                head.push_back(items[j].item);   // PEP
+            } else {
+                Profiler::count(ProfileCounter::BytesAllocated, tids.size() * sizeof(int));
+                tail.push_back(TailItem{items[j].item, tids});
+            }
+        }
+        Profiler::count(ProfileCounter::CandidatesGenerated, siblings.size());
+        Profiler::count(ProfileCounter::CandidatesPruned, pruned);
+        std::stable_sort(tail.begin(), tail.end(), [](const TailItem& a, const TailItem& b) {
+            return a.tids.size() < b.tids.size();
+        });
+        MemoryCharge tail_memory(MemoryCategory::TidLists, tidListBytes(tail));
+        mine(head, items[i].tids, tail, out);
+    }
+}
+
+void Mafia::mine(vector<int>& head, const vector<int>& head_tids, vector<TailItem>& tail, MaximalSet& out) const {
+    size_t need = static_cast<size_t>(min_support_count_);
+
+    // 叶子：没有频繁扩展，head 是最大项集候选
+    vector<int> hut = head;
+    if (tail.empty()) {
+        std::sort(hut.begin(), hut.end());
+        if (!out.subsumed(hut)) {
+            out.add(hut, static_cast<uint32_t>(head_tids.size()));
+        }
+        return;
+    }
+
+    // HUTMFI：H ∪ T 已被包含，子树中不会再有新的最大项集
+    for (const auto& t : tail) {
+        hut.push_back(t.item);
+    }
+    std::sort(hut.begin(), hut.end());
+    if (out.subsumed(hut)) {
+        return;
+    }
+
+    // FHUT：前瞻求交 t(H ∪ T)，频繁则 H ∪ T 就是这棵子树唯一的最大项集
+    {
+        vector<int> running = tail[0].tids;
+        vector<int> next;
+        bool frequent = true;
+        for (size_t k = 1; k < tail.size() && frequent; k++) {
+            frequent = intersectTids(running, tail[k].tids, need, next);
+            running.swap(next);
+        }
+        if (frequent) {
+            out.add(hut, static_cast<uint32_t>(running.size()));
+            return;
+        }
+    }
+
+    // 逐个分支：递归深度不超过最长最大项集的长度
+    vector<int> tids;
+    for (size_t i = 0; i < tail.size(); i++) {
+        size_t head_size = head.size();
+        head.push_back(tail[i].item);
+
+        vector<TailItem> next_tail;
+        uint64_t pruned = 0;
+        for (size_t j = i + 1; j < tail.size(); j++) {
+            if (!intersectTids(tail[i].tids, tail[j].tids, need, tids)) {
+                pruned++;
+                continue;
+            }
+            if (tids.size() == tail[i].tids.size()) {
+                head.push_back(tail[j].item);   // PEP
+            } else {
+                Profiler::count(ProfileCounter::BytesAllocated, tids.size() * sizeof(int));
+                next_tail.push_back(TailItem{tail[j].item, tids});
+            }
+        }
+        Profiler::count(ProfileCounter::CandidatesGenerated, tail.size() - i - 1);
+        Profiler::count(ProfileCounter::CandidatesPruned, pruned);
+        std::stable_sort(next_tail.begin(), next_tail.end(), [](const TailItem& a, const TailItem& b) {
+            return a.tids.size() < b.tids.size();
+        });
+        MemoryCharge tail_memory(MemoryCategory::TidLists, tidListBytes(next_tail));
+        mine(head, tail[i].tids, next_tail, out);
+        head.resize(head_size);
+    }
+}
+
+size_t Mafia::tidListBytes(const vector<TailItem>& tail) {
+    if (!MemoryTracker::enabled()) {
+        return 0;
+    }
+    size_t bytes = tail.capacity() * sizeof(TailItem);
+    for (const auto& t : tail) {
+        bytes += t.tids.capacity() * sizeof(int);
+    }
+    return bytes;
+}
+
+bool Mafia::MaximalSet::subsumed(const vector<int>& sorted_items) const {
+    if (sorted_items.empty()) {
+        return !supports_.empty();
+    }
+    // 从包含项集最少的那个项的倒排表开始检查
+    const vector<uint32_t>* shortest = nullptr;
+    for (int item : sorted_items) {
+        const auto& posting = postings_[item];
+        if (posting.empty()) {
+            return false;
+        }
+        if (shortest == nullptr || posting.size() < shortest->size()) {
+            shortest = &posting;
+        }
+    }
+    for (uint32_t index : *shortest) {
+        if (length(index) >= sorted_items.size() &&
+            std::includes(items(index), items(index) + length(index), sorted_items.begin(), sorted_items.end())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Mafia::MaximalSet::add(const vector<int>& sorted_items, uint32_t support) {
+    uint32_t index = static_cast<uint32_t>(supports_.size());
+    items_.insert(items_.end(), sorted_items.begin(), sorted_items.end());
+    offsets_.push_back(items_.size());
+    supports_.push_back(support);
+    for (int item : sorted_items) {
+        postings_[item].push_back(index);
+    }
+}
+
+void Mafia::emitMaximal(const vector<MaximalSet>& parts) {
+    ProfileScope scope("mafia.emit");
+    // 候选按长度降序加入全局集合：长的先加入，被包含的短候选就会被过滤掉
+    struct Ref {
+        const MaximalSet* part;
+        size_t index;
+    };
+    vector<Ref> refs;
+    for (const auto& part : parts) {
+        for (size_t i = 0; i < part.size(); i++) {
+            refs.push_back(Ref{&part, i});
+        }
+    }
+    std::stable_sort(refs.begin(), refs.end(), [](const Ref& a, const Ref& b) {
+        return a.part->length(a.index) > b.part->length(b.index);
+    });
+
+    MaximalSet global(static_cast<size_t>(db_.getMaxValue()) + 1);
+    SinkWriter writer(target());
+    vector<int> itemset;
+    for (const auto& ref : refs) {
+        const int* items = ref.part->items(ref.index);
+        itemset.assign(items, items + ref.part->length(ref.index));
+        if (global.subsumed(itemset)) {
+            continue;
+        }
+        global.add(itemset, ref.part->support(ref.index));
+        writer.emit(itemset.data(), itemset.size(), ref.part->support(ref.index));
+    }
+    writer.flush();
+    found_ += writer.emittedCount();
+}
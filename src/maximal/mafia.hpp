@@ -0,0 +1,129 @@
+#ifndef MAFIA_HPP
+#define MAFIA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "profile/memory.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+
+/**
+ * 最大频繁项集挖掘引擎（MAFIA 风格，tid列表垂直求交）
+ * 深度优先搜索 头部 H / 尾部 T，配合三种剪枝：
+ *   PEP：t(H) ⊆ t(H ∪ {x}) 时 x 直接并入头部，不单独分支
+ *   HUTMFI：H ∪ T 已被某个最大项集包含时整棵子树剪掉
+ *   FHUT：H ∪ T 本身频繁时（前瞻求交）直接得到最大项集，不再展开
+ * 候选的最大性用按项建立的倒排表检查；多线程时顶层项分块并行，最后全局再去掉被包含的候选。
+ */
+class Mafia {
+public:
+    /**
+     * 构造函数：挖掘最大频繁项集
+     * @param db 数据加载器
+     * @param min_support 最小支持度（小于1为相对支持度，大于等于1为绝对支持计数）
+     * @param thread_count 挖掘线程数，小于等于1时在当前线程串行挖掘
+     * @param sink 结果接收端，为空时结果收集在内存中，可通过 getMaximalItemsets 获取
+     */
+    Mafia(const DataLoader& db, double min_support, int thread_count = 0, ItemsetSink* sink = nullptr);
+
+    /**
+     * 获取所有最大频繁项集（按level组织，附带支持计数），指定了外部接收端时为空
+     */
+    const ItemsetPool& getMaximalItemsets() const {
+        return collected_.itemsets();
+    }
+
+private:
+    // 尾部中的一个项：item 为原始项，tids 为 t(H ∪ {item})
+    struct TailItem {
+        int item;
+        std::vector<int> tids;
+    };
+
+    // 已找到的最大项集（候选），按项建立倒排表用于包含检查
+    class MaximalSet {
+    public:
+        explicit MaximalSet(size_t item_range) : postings_(item_range) {}
+
+        /**
+         * 升序项集是否被已有的某个项集包含
+         */
+        bool subsumed(const std::vector<int>& sorted_items) const;
+
+        /**
+         * 加入升序项集（调用方保证没有被已有项集包含）
+         */
+        void add(const std::vector<int>& sorted_items, uint32_t support);
+
+        size_t size() const noexcept {
+            return supports_.size();
+        }
+
+        const int* items(size_t index) const noexcept {
+            return items_.data() + offsets_[index];
+        }
+
+        uint32_t length(size_t index) const noexcept {
+            return static_cast<uint32_t>(offsets_[index + 1] - offsets_[index]);
+        }
+
+        uint32_t support(size_t index) const noexcept {
+            return supports_[index];
+        }
+
+        /**
+         * 占用的堆内存字节数
+         */
+        size_t memoryBytes() const noexcept {
+            return items_.capacity() * sizeof(int) + offsets_.capacity() * sizeof(size_t)
+                + supports_.capacity() * sizeof(uint32_t) + nestedVectorBytes(postings_);
+        }
+
+    private:
+        std::vector<int> items_;
+        std::vector<size_t> offsets_ = {0};
+        std::vector<uint32_t> supports_;
+        std::vector<std::vector<uint32_t>> postings_;   // 项 -> 包含该项的项集下标
+    };
+
+    const DataLoader& db_;
+    double min_support_;
+    int min_support_count_;
+    int thread_count_;
+    size_t found_;
+
+    ItemsetSink* sink_;
+    CollectSink collected_;
+
+    ItemsetSink& target() {
+        return sink_ != nullptr ? *sink_ : collected_;
+    }
+
+    /**
+     * 展开顶层项 items[first, last)（单个项，按支持计数升序）
+     */
+    void mineRoot(const std::vector<TailItem>& items, size_t first, size_t last, MaximalSet& out) const;
+
+    /**
+     * 深度优先搜索
+     * @param head 头部项集
+     * @param head_tids t(head)
+     * @param tail 尾部（按支持计数升序），tids 为 t(head ∪ {item})
+     */
+    void mine(std::vector<int>& head, const std::vector<int>& head_tids,
+              std::vector<TailItem>& tail, MaximalSet& out) const;
+
+    /**
+     * 全局去掉被包含的候选并输出
+     */
+    void emitMaximal(const std::vector<MaximalSet>& parts);
+
+    /**
+     * 一组尾项的 tid 列表占用的字节数（未启用内存统计时返回 0，不遍历）
+     */
+    static size_t tidListBytes(const std::vector<TailItem>& tail);
+};
+
+#endif // MAFIA_HPP
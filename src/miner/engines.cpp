@@ -0,0 +1,140 @@
+#include "miner.hpp"
+#include "apriori/apr.hpp"
+#include "fptree/fp.hpp"
+#include "fptree-cp/fp.hpp"
+#include "closed/charm.hpp"
+#include "maximal/mafia.hpp"
+#include "fptree/projected_db.hpp"
+#include <algorithm>
+#include <cstdio>
+
+using std::string;
+using std::unique_ptr;
+
+namespace {
+
+// Apriori 引擎适配器
+class AprioriMiner : public Miner {
+public:
+    explicit AprioriMiner(int thread_count) : thread_count_(thread_count) {}
+
+    string name() const override {
+        return "apriori";
+    }
+
+    void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) override {
+        // 预算扣除数据集后至少留 1 字节，避免 0 被当作不限制
+        size_t budget = budget_.limited() ? std::max<size_t>(budget_.availableFor(data.loader()), 1) : 0;
+        Apriori apriori(data.loader(), static_cast<double>(threshold.resolve(data.transactionCount())), thread_count_, &sink, budget);
+        fallback_ = apriori.fallback();
+        sink.finish();
+    }
+
+private:
+    int thread_count_;
+};
+
+// 构造函数形如 (db, min_support, thread_count, sink) 的引擎适配器（FPTree、CondFPTree、Charm、Mafia）
+template <typename Engine>
+class EngineMiner : public Miner {
+public:
+    EngineMiner(const string& name, int thread_count) : name_(name), thread_count_(thread_count) {}
+
+    string name() const override {
+        return name_;
+    }
+
+    void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) override {
+        Engine engine(data.loader(), static_cast<double>(threshold.resolve(data.transactionCount())), thread_count_, &sink);
+        sink.finish();
+    }
+
+protected:
+    string name_;
+    int thread_count_;
+};
+
+// 字节数显示为 MB
+string megabytes(size_t bytes) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    return buffer;
+}
+
+// FP-Growth 引擎适配器（FPTree、CondFPTree）：设置了内存预算且预计超出时改用投影数据库模式，也支持外存挖掘
+template <typename Engine>
+class FpGrowthMiner : public EngineMiner<Engine> {
+public:
+    using EngineMiner<Engine>::EngineMiner;
+
+    void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) override {
+        this->fallback_.clear();
+        if (!this->budget_.limited()) {
+            EngineMiner<Engine>::mine(data, threshold, sink);
+            return;
+        }
+        size_t min_count = threshold.resolve(data.transactionCount());
+        size_t available = std::max<size_t>(this->budget_.availableFor(data.loader()), 1);
+        size_t expected = Engine::estimateMemory(FrequentOccurrence::of(data.records(), min_count), this->thread_count_);
+        if (expected <= available) {
+            EngineMiner<Engine>::mine(data, threshold, sink);
+            return;
+        }
+
+        ProjectedMining projected(engine(), estimator(), available, this->budget_.spill_dir, this->thread_count_);
+        projected.mine(data.records(), min_count, sink);
+        this->fallback_ = "投影数据库（预计需要 " + megabytes(expected) + "，可用 " + megabytes(available) + "；"
+            + describe(projected.stats()) + "）";
+        sink.finish();
+    }
+
+    void mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink) override {
+        ProjectedMining projected(engine(), estimator(), this->budget_.bytes, this->budget_.spill_dir, this->thread_count_);
+        projected.mine(file, threshold.resolve(file.transactionCount()), sink);
+        this->fallback_ = "外存投影数据库（" + describe(projected.stats()) + "）";
+        sink.finish();
+    }
+
+private:
+    // 每个投影单线程挖掘，投影之间并行
+    static ProjectedMining::Engine engine() {
+        return [](const DataLoader& db, size_t min_count, ItemsetSink& target) {
+            Engine engine(db, static_cast<double>(min_count), 1, &target);
+        };
+    }
+
+    static ProjectedMining::Estimator estimator() {
+        return [](const FrequentOccurrence& occurrence) {
+            return Engine::estimateMemory(occurrence, 1);
+        };
+    }
+
+    static string describe(const ProjectedMining::Stats& stats) {
+        string text = std::to_string(stats.projections) + " 个投影共 " + megabytes(stats.spilled_bytes) + " 写入磁盘，"
+            + std::to_string(stats.workers) + " 个线程并行挖掘，划分 " + std::to_string(stats.max_depth) + " 层";
+        if (stats.over_budget > 0) {
+            text += "，" + std::to_string(stats.over_budget) + " 个投影划分到最大层数仍超出预算";
+        }
+        return text;
+    }
+};
+
+} // namespace
+
+void registerBuiltinMiners(MinerRegistry& registry) {
+    registry.add("apriori", "Apriori 候选生成-测试（倒排索引求交）", [](int thread_count) -> unique_ptr<Miner> {
+        return unique_ptr<Miner>(new AprioriMiner(thread_count));
+    });
+    registry.add("fptree", "FP-Growth（路径列表条件模式基）", [](int thread_count) -> unique_ptr<Miner> {
+        return unique_ptr<Miner>(new FpGrowthMiner<FPTree>("fptree", thread_count));
+    });
+    registry.add("condfp", "FP-Growth（逐层构建条件FP-Tree，内存更省）", [](int thread_count) -> unique_ptr<Miner> {
+        return unique_ptr<Miner>(new FpGrowthMiner<CondFPTree>("condfp", thread_count));
+    });
+    registry.add("charm", "CHARM 闭项集（tid列表垂直求交，包含哈希检查闭包）", [](int thread_count) -> unique_ptr<Miner> {
+        return unique_ptr<Miner>(new EngineMiner<Charm>("charm", thread_count));
+    }, ItemsetKind::Closed);
+    registry.add("mafia", "MAFIA 最大项集（tid列表垂直求交，PEP/HUTMFI/FHUT 剪枝）", [](int thread_count) -> unique_ptr<Miner> {
+        return unique_ptr<Miner>(new EngineMiner<Mafia>("mafia", thread_count));
+    }, ItemsetKind::Maximal);
+}
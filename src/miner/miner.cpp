@@ -0,0 +1,58 @@
+#include "miner.hpp"
+#include <stdexcept>
+
+using std::string;
+using std::unique_ptr;
+
+MinerRegistry& MinerRegistry::instance() {
+    static MinerRegistry* registry = []() {
+        auto created = new MinerRegistry();
+        registerBuiltinMiners(*created);
+        return created;
+    }();
+    return *registry;
+}
+
+void Miner::mineFile(const TransactionFile&, const SupportThreshold&, ItemsetSink&) {
+    throw std::runtime_error("引擎 " + name() + " 不支持外存挖掘");
+}
+
+const char* itemsetKindName(ItemsetKind kind) {
+    switch (kind) {
+        case ItemsetKind::Frequent: return "频繁项集";
+        case ItemsetKind::Closed: return "闭项集";
+        case ItemsetKind::Maximal: return "最大项集";
+        case ItemsetKind::TopK: return "Top-K";
+    }
+    return "";
+}
+
+void MinerRegistry::add(const string& name, const string& description, Factory factory, ItemsetKind kind) {
+    for (auto& entry : entries_) {
+        if (entry.name == name) {
+            entry.description = description;
+            entry.factory = std::move(factory);
+            entry.kind = kind;
+            return;
+        }
+    }
+    entries_.push_back(Entry{name, description, std::move(factory), kind});
+}
+
+unique_ptr<Miner> MinerRegistry::create(const string& name, int thread_count) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            return entry.factory(thread_count);
+        }
+    }
+    throw std::runtime_error("未知的挖掘引擎: " + name);
+}
+
+bool MinerRegistry::contains(const string& name) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
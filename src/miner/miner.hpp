@@ -0,0 +1,196 @@
+#ifndef MINER_HPP
+#define MINER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "dataload/transaction_file.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+#include "miner/support.hpp"
+
+/**
+ * 数据集视图：引擎只通过它读取数据，不关心数据来源
+ */
+class DatasetView {
+public:
+    explicit DatasetView(const DataLoader& loader) : loader_(loader) {}
+
+    const DataLoader& loader() const noexcept {
+        return loader_;
+    }
+
+    size_t transactionCount() const noexcept {
+        return loader_.all_count;
+    }
+
+    const DataLoader::Database& records() const noexcept {
+        return loader_.getOriginalData();
+    }
+
+    const DataLoader::InvertedIndex& invertedIndex() const noexcept {
+        return loader_.getInvertedIndex();
+    }
+
+    int maxItem() const noexcept {
+        return loader_.getMaxValue();
+    }
+
+private:
+    const DataLoader& loader_;
+};
+
+/**
+ * 支持度阈值：小于1为相对支持度，大于等于1为绝对支持计数
+ */
+struct SupportThreshold {
+    double value;
+
+    size_t resolve(size_t transaction_count) const {
+        return resolveSupportCount(value, transaction_count);
+    }
+};
+
+/**
+ * 内存预算：引擎预计超出时切换到省内存的降级模式
+ * 预算包括已加载的数据集（原始记录和倒排索引），引擎可用的部分为两者之差
+ */
+struct MemoryBudget {
+    size_t bytes = 0;          // 0 表示不限制
+    std::string spill_dir;     // 降级模式写临时文件的目录，为空时使用系统临时目录
+
+    bool limited() const noexcept {
+        return bytes > 0;
+    }
+
+    /**
+     * 扣除数据集后引擎可用的字节数
+     */
+    size_t availableFor(const DataLoader& loader) const {
+        size_t dataset = loader.datasetBytes();
+        return bytes > dataset ? bytes - dataset : 0;
+    }
+};
+
+/**
+ * 引擎输出的项集种类：同种类引擎的结果才可以互相比较
+ */
+enum class ItemsetKind {
+    Frequent,   // 全部频繁项集
+    Closed,     // 闭频繁项集（没有支持计数相同的超集）
+    Maximal,    // 最大频繁项集（没有频繁的超集）
+    TopK        // 支持计数最高的K个项集
+};
+
+/**
+ * 种类的显示名称
+ */
+const char* itemsetKindName(ItemsetKind kind);
+
+/**
+ * 频繁项集挖掘引擎的统一接口
+ */
+class Miner {
+public:
+    virtual ~Miner() = default;
+
+    /**
+     * 引擎名称（与注册表中的名称一致）
+     */
+    virtual std::string name() const = 0;
+
+    /**
+     * 挖掘频繁项集
+     * @param data 数据集视图
+     * @param threshold 最小支持度阈值
+     * @param sink 结果接收端，结束时会调用 sink.finish()
+     */
+    virtual void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) = 0;
+
+    /**
+     * 外存挖掘：不把数据集载入内存，流式扫描事务文件（只有 FP-Growth 引擎和 SON 分区挖掘支持）
+     * @param file 事务文件
+     * @param threshold 最小支持度阈值
+     * @param sink 结果接收端，结束时会调用 sink.finish()
+     * @throws std::runtime_error 引擎不支持外存挖掘
+     */
+    virtual void mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink);
+
+    /**
+     * 设置内存预算（不支持预算的引擎忽略）
+     */
+    void setMemoryBudget(const MemoryBudget& budget) {
+        budget_ = budget;
+    }
+
+    /**
+     * 上一次 mine 使用的非常规运行模式（内存预算降级、外存或分区挖掘），为空表示按常规模式运行
+     */
+    const std::string& fallback() const noexcept {
+        return fallback_;
+    }
+
+protected:
+    MemoryBudget budget_;
+    std::string fallback_;
+};
+
+/**
+ * 引擎注册表：按名称创建引擎
+ */
+class MinerRegistry {
+public:
+    // 引擎工厂：参数为线程数
+    using Factory = std::function<std::unique_ptr<Miner>(int thread_count)>;
+
+    struct Entry {
+        std::string name;
+        std::string description;
+        Factory factory;
+        ItemsetKind kind;
+    };
+
+    /**
+     * 获取全局注册表（首次访问时注册内置引擎）
+     */
+    static MinerRegistry& instance();
+
+    /**
+     * 注册引擎，同名引擎会被覆盖
+     */
+    void add(const std::string& name, const std::string& description, Factory factory,
+             ItemsetKind kind = ItemsetKind::Frequent);
+
+    /**
+     * 按名称创建引擎
+     * @throws std::runtime_error 引擎不存在
+     */
+    std::unique_ptr<Miner> create(const std::string& name, int thread_count) const;
+
+    /**
+     * 引擎是否已注册
+     */
+    bool contains(const std::string& name) const;
+
+    /**
+     * 所有已注册引擎（按注册顺序）
+     */
+    const std::vector<Entry>& entries() const noexcept {
+        return entries_;
+    }
+
+private:
+    MinerRegistry() = default;
+
+    std::vector<Entry> entries_;
+};
+
+/**
+ * 注册内置引擎（apriori、fptree、condfp、charm、mafia）
+ */
+void registerBuiltinMiners(MinerRegistry& registry);
+
+#endif // MINER_HPP
@@ -0,0 +1,158 @@
+#include "result_cache.hpp"
+#include "result/result_file.hpp"
+#include "sched/parallel_for.hpp"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+
+using std::shared_ptr;
+using std::string;
+
+uint64_t datasetFingerprint(const DatasetView& data, int threads) {
+    const auto& records = data.records();
+    std::atomic<uint64_t> sum(0);
+    parallelFor(records.size(), resolveThreadCount(threads), 4096, [&](size_t begin, size_t end) {
+        uint64_t local = 0;
+        for (size_t i = begin; i < end; i++) {
+            // 记录哈希再与位置混合，求和与分块无关
+            uint64_t hash = ItemsetPool::canonicalHash(records[i].data(), records[i].size());
+            local += hash ^ (static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL);
+        }
+        sum.fetch_add(local, std::memory_order_relaxed);
+    });
+    uint64_t summary[2] = {sum.load(), static_cast<uint64_t>(records.size())};
+    return ItemsetPool::canonicalHash(reinterpret_cast<const int*>(summary), 2 * sizeof(uint64_t) / sizeof(int));
+}
+
+namespace {
+
+// 挖掘时同时收集结果的接收端：结果写入缓存，同时转发给调用方
+class CollectingTee : public ItemsetSink {
+public:
+    explicit CollectingTee(ItemsetSink& next) : next_(next), itemsets_(std::make_shared<ItemsetPool>()) {}
+
+    void consume(const ItemsetPool& batch) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            itemsets_->merge(batch);
+        }
+        next_.consume(batch);
+    }
+
+    void finish() override {
+        next_.finish();
+    }
+
+    shared_ptr<const ItemsetPool> itemsets() const {
+        return itemsets_;
+    }
+
+private:
+    ItemsetSink& next_;
+    std::mutex mutex_;
+    shared_ptr<ItemsetPool> itemsets_;
+};
+
+// 把支持计数达标的项集输出到接收端
+void emitFiltered(const ItemsetPool& itemsets, size_t min_support_count, ItemsetSink& sink) {
+    SinkWriter writer(sink);
+    itemsets.forEach([&writer, min_support_count](const ItemsetPool::ItemsetView& view) {
+        if (view.support >= min_support_count) {
+            writer.emit(view.items, view.length, view.support);
+        }
+    });
+    writer.flush();
+    sink.finish();
+}
+
+} // namespace
+
+ResultCache::ResultCache(const string& directory) : directory_(directory), hits_(0), misses_(0) {
+    if (!directory_.empty()) {
+        std::filesystem::create_directories(directory_);
+    }
+}
+
+string ResultCache::filePath(const Key& key) const {
+    char fingerprint[17];
+    std::snprintf(fingerprint, sizeof(fingerprint), "%016llx", static_cast<unsigned long long>(key.first));
+    return directory_ + "/" + fingerprint + "-" + key.second + ".bin";
+}
+
+const ResultCache::Entry* ResultCache::find(const Key& key) {
+    auto found = entries_.find(key);
+    if (found != entries_.end()) {
+        return &found->second;
+    }
+    if (directory_.empty() || !isResultFile(filePath(key))) {
+        return nullptr;
+    }
+    // 其他进程保存的结果
+    ResultFile file(filePath(key));
+    auto itemsets = std::make_shared<ItemsetPool>();
+    file.load(*itemsets);
+    Entry entry{static_cast<size_t>(file.transactionCount()), static_cast<size_t>(file.minSupportCount()), itemsets};
+    return &entries_.emplace(key, std::move(entry)).first->second;
+}
+
+bool ResultCache::lookup(uint64_t fingerprint, const string& engine, size_t min_support_count, ItemsetSink& sink) {
+    shared_ptr<const ItemsetPool> itemsets;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry* entry = find(Key(fingerprint, engine));
+        if (entry == nullptr || entry->min_support_count > min_support_count) {
+            misses_++;
+            return false;
+        }
+        hits_++;
+        itemsets = entry->itemsets;
+    }
+    // 过滤在锁外进行，缓存条目被替换时旧结果由 shared_ptr 保持有效
+    emitFiltered(*itemsets, min_support_count, sink);
+    return true;
+}
+
+void ResultCache::store(uint64_t fingerprint, const string& engine, size_t transaction_count,
+                        size_t min_support_count, double min_support, shared_ptr<const ItemsetPool> itemsets) {
+    Key key(fingerprint, engine);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Entry* existing = find(key);
+        if (existing != nullptr && existing->min_support_count <= min_support_count) {
+            return;
+        }
+        entries_[key] = Entry{transaction_count, min_support_count, itemsets};
+    }
+    if (!directory_.empty()) {
+        // 先写临时文件再改名，其他进程不会读到写了一半的文件
+        string path = filePath(key);
+        string temp = path + ".tmp";
+        BinaryFileSink file(temp, transaction_count, min_support_count, min_support);
+        file.consume(*itemsets);
+        file.finish();
+        std::rename(temp.c_str(), path.c_str());
+    }
+}
+
+size_t ResultCache::cachedSupportCount(uint64_t fingerprint, const string& engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = find(Key(fingerprint, engine));
+    return entry != nullptr ? entry->min_support_count : 0;
+}
+
+bool ResultCache::mine(Miner& miner, const MinerRegistry::Entry& engine, const DatasetView& data, uint64_t fingerprint,
+                       const SupportThreshold& threshold, ItemsetSink& sink) {
+    size_t min_support_count = threshold.resolve(data.transactionCount());
+    if (!cacheable(engine.kind)) {
+        miner.mine(data, threshold, sink);
+        return false;
+    }
+    if (lookup(fingerprint, engine.name, min_support_count, sink)) {
+        return true;
+    }
+
+    CollectingTee tee(sink);
+    miner.mine(data, threshold, tee);
+    store(fingerprint, engine.name, data.transactionCount(), min_support_count, threshold.value, tee.itemsets());
+    return false;
+}
@@ -0,0 +1,97 @@
+#ifndef RESULT_CACHE_HPP
+#define RESULT_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include "miner/miner.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+
+/**
+ * 数据集指纹：对每条记录的内容和位置做64位哈希后求和，
+ * 结果与分块方式、线程数无关，数据集内容或记录顺序变化时指纹随之变化
+ * @param threads 计算线程数，小于等于1时串行
+ */
+uint64_t datasetFingerprint(const DatasetView& data, int threads = 0);
+
+/**
+ * 支持度阈值结果缓存：按 (数据集指纹, 引擎) 保存目前挖过的最低阈值的结果。
+ * 频繁项集和闭项集对支持度单调（阈值提高后的结果就是原结果中支持计数达标的部分），
+ * 更高阈值的请求直接过滤缓存的支持计数得到，不再重新挖掘；
+ * 最大项集、Top-K 的结果会随阈值变化，不经过缓存。
+ * 指定目录时结果同时以二进制结果文件保存，其他进程可以复用。可被多个线程并发使用。
+ */
+class ResultCache {
+public:
+    /**
+     * @param directory 持久化目录（不存在时创建），为空时只缓存在内存中
+     */
+    explicit ResultCache(const std::string& directory = "");
+
+    /**
+     * 该种类的结果能否通过过滤支持计数回答更高的阈值
+     */
+    static bool cacheable(ItemsetKind kind) noexcept {
+        return kind == ItemsetKind::Frequent || kind == ItemsetKind::Closed;
+    }
+
+    /**
+     * 经过缓存挖掘：缓存中有不高于请求阈值的结果时过滤输出，否则用 miner 挖掘并写入缓存
+     * 两种情况结束时都会调用 sink.finish()
+     * @param engine 引擎在注册表中的条目（名称和种类）
+     * @param fingerprint 数据集指纹（datasetFingerprint）
+     * @return 是否命中缓存
+     */
+    bool mine(Miner& miner, const MinerRegistry::Entry& engine, const DatasetView& data, uint64_t fingerprint,
+              const SupportThreshold& threshold, ItemsetSink& sink);
+
+    /**
+     * 直接查询：缓存中有不高于 min_support_count 的结果时过滤输出到 sink（会调用 sink.finish()）
+     * @return 是否命中
+     */
+    bool lookup(uint64_t fingerprint, const std::string& engine, size_t min_support_count, ItemsetSink& sink);
+
+    /**
+     * 保存挖掘结果；已有更低阈值的结果时忽略
+     */
+    void store(uint64_t fingerprint, const std::string& engine, size_t transaction_count,
+               size_t min_support_count, double min_support, std::shared_ptr<const ItemsetPool> itemsets);
+
+    /**
+     * 缓存中 (指纹, 引擎) 的最低支持计数，没有时返回0
+     */
+    size_t cachedSupportCount(uint64_t fingerprint, const std::string& engine);
+
+    size_t hits() const noexcept { return hits_; }
+    size_t misses() const noexcept { return misses_; }
+
+private:
+    struct Entry {
+        size_t transaction_count;
+        size_t min_support_count;
+        std::shared_ptr<const ItemsetPool> itemsets;
+    };
+
+    using Key = std::pair<uint64_t, std::string>;
+
+    /**
+     * 查找内存中的条目，没有时尝试从持久化目录加载（调用方持有锁）
+     */
+    const Entry* find(const Key& key);
+
+    std::string filePath(const Key& key) const;
+
+    std::mutex mutex_;
+    std::string directory_;
+    std::map<Key, Entry> entries_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+};
+
+#endif // RESULT_CACHE_HPP
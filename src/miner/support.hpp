@@ -0,0 +1,35 @@
+#ifndef SUPPORT_HPP
+#define SUPPORT_HPP
+
+#include <cmath>
+#include <cstddef>
+
+/**
+ * 相对支持度换算为最小支持计数：ceil(fraction * transaction_count)，至少为1
+ * 乘积先减去一个很小的量再向上取整，避免 0.07 * 100 = 7.000000000000001 这类浮点误差多取整一位
+ * @param fraction 相对支持度
+ * @param transaction_count 事务总数
+ * @return 最小支持计数，至少为1
+ */
+inline size_t relativeSupportCount(double fraction, size_t transaction_count) {
+    long double count = std::ceil(static_cast<long double>(fraction) * static_cast<long double>(transaction_count) - 1e-9L);
+    if (count < 1.0L) {
+        return 1;
+    }
+    return static_cast<size_t>(count);
+}
+
+/**
+ * 将用户输入的最小支持度换算为最小支持计数（所有引擎统一使用）
+ * @param min_support 小于1时为相对支持度（向上取整），大于等于1时为绝对支持计数
+ * @param transaction_count 事务总数
+ * @return 最小支持计数，至少为1
+ */
+inline size_t resolveSupportCount(double min_support, size_t transaction_count) {
+    if (min_support < 1.0) {
+        return relativeSupportCount(min_support, transaction_count);
+    }
+    return static_cast<size_t>(std::ceil(min_support));
+}
+
+#endif // SUPPORT_HPP
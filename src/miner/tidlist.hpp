@@ -0,0 +1,120 @@
+#ifndef TIDLIST_HPP
+#define TIDLIST_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "profile/profiler.hpp"
+
+/**
+ * 垂直挖掘（tid列表）引擎共用的工具
+ */
+
+/**
+ * 倍增查找：从 from 开始按 1, 2, 4, ... 的步长跳到不小于 target 的区间，再在区间内二分
+ * 目标离 from 越近越快，适合按升序依次查找一串目标
+ * @return list 中第一个不小于 target 的下标（不存在时为 list.size()）
+ */
+inline size_t gallopLowerBound(const std::vector<int>& list, size_t from, int target) {
+    if (from >= list.size() || list[from] >= target) {
+        return from;
+    }
+    size_t low = from;
+    size_t step = 1;
+    size_t high = from;
+    while (high < list.size() && list[high] < target) {
+        low = high + 1;
+        high += step;
+        step <<= 1;
+    }
+    high = std::min(high, list.size());
+    return static_cast<size_t>(std::lower_bound(list.begin() + low, list.begin() + high, target) - list.begin());
+}
+
+/**
+ * 求两个升序tid列表的交集，确定达不到 need 时提前结束
+ * 长度相差悬殊时（频繁项的tid列表长度跨几个数量级）短表逐个在长表中倍增查找
+ * @return 交集大小是否达到 need
+ */
+inline bool intersectTids(const std::vector<int>& a, const std::vector<int>& b, size_t need, std::vector<int>& out) {
+    Profiler::count(ProfileCounter::Intersections);
+    out.clear();
+    if (a.size() < need || b.size() < need) {
+        return false;
+    }
+
+    const std::vector<int>& small = a.size() <= b.size() ? a : b;
+    const std::vector<int>& large = a.size() <= b.size() ? b : a;
+    if (small.size() * 16 < large.size()) {
+        size_t cursor = 0;
+        for (size_t i = 0; i < small.size(); i++) {
+            if (out.size() + (small.size() - i) < need) {
+                return false;
+            }
+            cursor = gallopLowerBound(large, cursor, small[i]);
+            if (cursor == large.size()) {
+                break;
+            }
+            if (large[cursor] == small[i]) {
+                out.push_back(small[i]);
+                ++cursor;
+            }
+        }
+        return out.size() >= need;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        // 剩下的元素全部命中也达不到 need
+        if (out.size() + std::min(a.size() - i, b.size() - j) < need) {
+            return false;
+        }
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            out.push_back(a[i]);
+            i++;
+            j++;
+        }
+    }
+    return out.size() >= need;
+}
+
+/**
+ * 顶层兄弟两两求交的次数是频繁项数的平方级，绝大多数交集为空：
+ * 沿 tids 中每条记录（水平数据）统计与其他项的共现次数，找出共现次数达到 need 的兄弟
+ * @param records 原始记录
+ * @param tids 当前项的tid列表
+ * @param position 原始项 -> 兄弟下标，非频繁项为 -1
+ * @param after 只统计下标大于 after 的兄弟
+ * @param counts 临时计数数组（长度为兄弟数，调用前后全为0）
+ * @param out 满足条件的兄弟下标（升序）
+ */
+inline void cooccurringSiblings(const DataLoader::Database& records, const std::vector<int>& tids,
+                                const std::vector<int>& position, size_t after, size_t need,
+                                std::vector<uint32_t>& counts, std::vector<size_t>& out) {
+    out.clear();
+    std::vector<size_t> touched;
+    for (int tid : tids) {
+        for (int item : records[tid]) {
+            if (item < 0 || item >= static_cast<int>(position.size())) continue;
+            int k = position[item];
+            if (k > static_cast<int>(after)) {
+                if (counts[k]++ == 0) touched.push_back(static_cast<size_t>(k));
+            }
+        }
+    }
+    for (size_t k : touched) {
+        if (counts[k] >= need) {
+            out.push_back(k);
+        }
+        counts[k] = 0;
+    }
+    std::sort(out.begin(), out.end());
+}
+
+#endif // TIDLIST_HPP
@@ -0,0 +1,157 @@
+#include "candidate_counter.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <mutex>
+
+using std::vector;
+
+namespace {
+
+// 每个计数块至少包含的事务数（块内使用局部计数数组，块太小时合并的代价比计数还大）
+constexpr size_t kMinBlock = 4096;
+
+} // namespace
+
+CandidateCounter::CandidateCounter(const ItemsetPool& candidates) {
+    vector<ItemsetPool::ItemsetView> sorted;
+    sorted.reserve(candidates.size());
+    int max_item = -1;
+    candidates.forEach([&](const ItemsetPool::ItemsetView& itemset) {
+        sorted.push_back(itemset);
+        max_item = std::max(max_item, itemset[itemset.size() - 1]);
+    });
+    std::sort(sorted.begin(), sorted.end(), [](const ItemsetPool::ItemsetView& a, const ItemsetPool::ItemsetView& b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+    });
+
+    relevant_.assign(static_cast<size_t>(max_item + 1), 0);
+    for (const auto& itemset : sorted) {
+        for (int item : itemset) {
+            relevant_[item] = 1;
+        }
+    }
+    nodes_.push_back(Node{-1, 0, 0, -1});
+    build(0, sorted, 0, sorted.size(), 0);
+}
+
+void CandidateCounter::build(uint32_t node, const vector<ItemsetPool::ItemsetView>& sorted, size_t begin, size_t end,
+                             size_t depth) {
+    // 字典序下恰好等于路径的候选排在最前面（重复的候选也在这里跳过）
+    while (begin < end && sorted[begin].size() == depth) {
+        if (nodes_[node].candidate < 0) {
+            nodes_[node].candidate = static_cast<int32_t>(candidate_count_++);
+        }
+        begin++;
+    }
+    if (begin == end) {
+        return;
+    }
+
+    // 先连续分配全部子节点，再逐个递归，保证同一节点的子节点相邻
+    uint32_t first_child = static_cast<uint32_t>(nodes_.size());
+    vector<size_t> bounds;
+    for (size_t i = begin; i < end; i++) {
+        if (i == begin || sorted[i][depth] != sorted[i - 1][depth]) {
+            bounds.push_back(i);
+            nodes_.push_back(Node{sorted[i][depth], 0, 0, -1});
+        }
+    }
+    bounds.push_back(end);
+    nodes_[node].first_child = first_child;
+    nodes_[node].child_count = static_cast<uint32_t>(bounds.size() - 1);
+    for (size_t child = 0; child + 1 < bounds.size(); child++) {
+        build(first_child + static_cast<uint32_t>(child), sorted, bounds[child], bounds[child + 1], depth + 1);
+    }
+}
+
+int64_t CandidateCounter::find(const int* items, size_t length) const {
+    uint32_t node = 0;
+    for (size_t i = 0; i < length; i++) {
+        const Node* child = nodes_.data() + nodes_[node].first_child;
+        const Node* last = child + nodes_[node].child_count;
+        child = std::lower_bound(child, last, items[i], [](const Node& n, int item) {
+            return n.item < item;
+        });
+        if (child == last || child->item != items[i]) {
+            return -1;
+        }
+        node = static_cast<uint32_t>(child - nodes_.data());
+    }
+    return length > 0 ? nodes_[node].candidate : -1;
+}
+
+void CandidateCounter::add(const int* items, size_t length, Counts& counts, vector<int>& buffer) const {
+    buffer.clear();
+    for (size_t i = 0; i < length; i++) {
+        int item = items[i];
+        if (item >= 0 && static_cast<size_t>(item) < relevant_.size() && relevant_[item]) {
+            buffer.push_back(item);
+        }
+    }
+    if (buffer.empty()) {
+        return;
+    }
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+    visit(0, buffer.data(), buffer.size(), counts.data());
+}
+
+void CandidateCounter::visit(uint32_t node, const int* items, size_t length, uint32_t* counts) const {
+    const Node* child = nodes_.data() + nodes_[node].first_child;
+    const Node* last = child + nodes_[node].child_count;
+    for (size_t i = 0; i < length && child != last; i++) {
+        child = std::lower_bound(child, last, items[i], [](const Node& n, int item) {
+            return n.item < item;
+        });
+        if (child == last || child->item != items[i]) {
+            continue;
+        }
+        if (child->candidate >= 0) {
+            counts[child->candidate]++;
+        }
+        if (child->child_count > 0 && i + 1 < length) {
+            visit(static_cast<uint32_t>(child - nodes_.data()), items + i + 1, length - i - 1, counts);
+        }
+        child++;
+    }
+}
+
+void CandidateCounter::addRecords(const DataLoader::Database& records, int thread_count, Counts& counts) const {
+    std::mutex mutex;
+    parallelFor(records.size(), static_cast<size_t>(std::max(thread_count, 1)), kMinBlock, [&](size_t begin, size_t end) {
+        bool whole = begin == 0 && end == records.size();
+        Counts local = whole ? Counts() : emptyCounts();
+        Counts& target = whole ? counts : local;
+        vector<int> buffer;
+        for (size_t i = begin; i < end; i++) {
+            add(records[i].data(), records[i].size(), target, buffer);
+        }
+        if (!whole) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t c = 0; c < candidate_count_; c++) {
+                counts[c] += local[c];
+            }
+        }
+    });
+}
+
+size_t CandidateCounter::emit(const Counts& counts, size_t min_count, ItemsetSink& sink) const {
+    SinkWriter writer(sink);
+    vector<int> path;
+    emitNode(0, path, counts, min_count, writer);
+    writer.flush();
+    return writer.emittedCount();
+}
+
+void CandidateCounter::emitNode(uint32_t node, vector<int>& path, const Counts& counts, size_t min_count,
+                                SinkWriter& writer) const {
+    const Node& current = nodes_[node];
+    if (current.candidate >= 0 && counts[current.candidate] >= min_count) {
+        writer.emit(path.data(), path.size(), counts[current.candidate]);
+    }
+    for (uint32_t child = current.first_child; child < current.first_child + current.child_count; child++) {
+        path.push_back(nodes_[child].item);
+        emitNode(child, path, counts, min_count, writer);
+        path.pop_back();
+    }
+}
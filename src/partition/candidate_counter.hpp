@@ -0,0 +1,93 @@
+#ifndef CANDIDATE_COUNTER_HPP
+#define CANDIDATE_COUNTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+
+/**
+ * 候选项集的全局计数（SON 第二遍扫描）
+ * 候选按升序前缀组织成字典树，同一节点的子节点连续存放并按项升序排列。
+ * 每条事务排序去重、滤掉不出现在任何候选中的项后，从根开始逐项在子节点中二分查找，
+ * 一次遍历数完事务包含的全部候选，不需要倒排索引，可以直接在流式读取的事务上计数。
+ */
+class CandidateCounter {
+public:
+    // 每个候选的计数，下标为候选编号
+    using Counts = std::vector<uint32_t>;
+
+    /**
+     * 由候选集构建字典树（候选原有的支持计数被忽略，重复的候选只计一个）
+     */
+    explicit CandidateCounter(const ItemsetPool& candidates);
+
+    /**
+     * 候选数量
+     */
+    size_t candidateCount() const noexcept {
+        return candidate_count_;
+    }
+
+    /**
+     * 全部为 0 的计数数组
+     */
+    Counts emptyCounts() const {
+        return Counts(candidate_count_, 0);
+    }
+
+    /**
+     * 候选的编号（即计数数组的下标），items 须为升序，不是候选时返回 -1
+     */
+    int64_t find(const int* items, size_t length) const;
+
+    /**
+     * 把一条事务（项的顺序任意，可以重复）包含的候选计数加一
+     * @param buffer 排序用的缓冲，多线程计数时每个线程各用一个
+     */
+    void add(const int* items, size_t length, Counts& counts, std::vector<int>& buffer) const;
+
+    /**
+     * 统计一批事务，结果累加到 counts
+     * @param thread_count 线程数，小于等于1时在当前线程执行；按事务块并行，每块使用局部计数最后合并
+     */
+    void addRecords(const DataLoader::Database& records, int thread_count, Counts& counts) const;
+
+    /**
+     * 把计数不低于 min_count 的候选（以计数为支持计数）推送到 sink（不调用 finish）
+     * @return 推送的项集数
+     */
+    size_t emit(const Counts& counts, size_t min_count, ItemsetSink& sink) const;
+
+private:
+    // 字典树节点：节点对应的项集为从根到它路径上的项
+    struct Node {
+        int item;
+        uint32_t first_child;   // 子节点在 nodes_ 中的起始下标
+        uint32_t child_count;
+        int32_t candidate;      // 候选编号，-1 表示该节点只是前缀
+    };
+
+    /**
+     * 由按字典序排序的候选 sorted[begin, end)（都以 node 的路径为前缀，长度不小于 depth）构建 node 的子树
+     */
+    void build(uint32_t node, const std::vector<ItemsetPool::ItemsetView>& sorted, size_t begin, size_t end, size_t depth);
+
+    /**
+     * 在 node 的子树中统计升序事务 items[0, length) 包含的候选
+     */
+    void visit(uint32_t node, const int* items, size_t length, uint32_t* counts) const;
+
+    /**
+     * 推送 node 子树中计数达到阈值的候选，path 为 node 的路径
+     */
+    void emitNode(uint32_t node, std::vector<int>& path, const Counts& counts, size_t min_count, SinkWriter& writer) const;
+
+    std::vector<Node> nodes_;           // nodes_[0] 为根
+    std::vector<char> relevant_;        // 项是否出现在某个候选中，下标为项
+    size_t candidate_count_ = 0;
+};
+
+#endif // CANDIDATE_COUNTER_HPP
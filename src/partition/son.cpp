@@ -0,0 +1,241 @@
+#include "son.hpp"
+#include "candidate_counter.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// 挖掘一个分区时引擎自身的结构（FP 树、tid 列表、候选）估计为分区数据的这么多倍
+constexpr size_t kEngineOverhead = 2;
+
+/**
+ * 收集各分区的局部频繁项集，重复的项集只保留一份
+ */
+class CandidateSink : public ItemsetSink {
+public:
+    void consume(const ItemsetPool& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        candidates_.merge(batch);
+    }
+
+    const ItemsetPool& candidates() const noexcept {
+        return candidates_;
+    }
+
+private:
+    std::mutex mutex_;
+    ItemsetPool candidates_{true};
+};
+
+/**
+ * 并行挖掘分区：只有一个线程时直接在当前线程执行；
+ * 同时在途的分区不超过线程数，流式读取时未挖掘的分区不会在内存中堆积
+ * 使用独立的线程池而不是全局线程池，分区内的引擎（如 Apriori）还要等待全局线程池
+ */
+class ChunkRunner {
+public:
+    explicit ChunkRunner(size_t workers) : workers_(workers) {
+        if (workers > 1) {
+            pool_ = std::make_unique<BS::thread_pool<>>(workers);
+        }
+    }
+
+    void submit(std::function<void()> task) {
+        if (!pool_) {
+            task();
+            return;
+        }
+        if (pending_.size() >= workers_) {
+            pending_.front().get();
+            pending_.pop_front();
+        }
+        pending_.push_back(pool_->submit_task(std::move(task)));
+    }
+
+    /**
+     * 等待全部分区挖掘完成
+     * @throws 分区挖掘中抛出的异常
+     */
+    void wait() {
+        while (!pending_.empty()) {
+            std::future<void> next = std::move(pending_.front());
+            pending_.pop_front();
+            next.get();
+        }
+    }
+
+private:
+    size_t workers_;
+    std::unique_ptr<BS::thread_pool<>> pool_;
+    std::deque<std::future<void>> pending_;
+};
+
+} // namespace
+
+void requireFrequentEngine(const string& engine) {
+    const auto& entries = MinerRegistry::instance().entries();
+    auto entry = std::find_if(entries.begin(), entries.end(), [&](const MinerRegistry::Entry& e) {
+        return e.name == engine;
+    });
+    if (entry == entries.end()) {
+        throw std::invalid_argument("未知的挖掘引擎: " + engine);
+    }
+    if (entry->kind != ItemsetKind::Frequent) {
+        throw std::invalid_argument("分区挖掘需要输出全部频繁项集的引擎，" + engine + " 输出的是"
+                                    + itemsetKindName(entry->kind));
+    }
+}
+
+SonMiner::SonMiner(const string& engine, int thread_count, size_t partitions)
+    : engine_(engine), thread_count_(thread_count), partitions_(partitions) {
+    requireFrequentEngine(engine);
+}
+
+size_t SonMiner::localThreshold(size_t min_count, size_t chunk, size_t total) {
+    if (total == 0) {
+        return 1;
+    }
+    // 项集在每个分区都低于该阈值时，全局计数 < Σ min_count * chunk / total = min_count
+    size_t local = (min_count * chunk + total - 1) / total;
+    return std::max<size_t>(local, 1);
+}
+
+size_t SonMiner::partitionCount(size_t data_bytes, size_t available) const {
+    if (partitions_ > 0) {
+        return partitions_;
+    }
+    size_t workers = resolveThreadCount(thread_count_);
+    size_t count = workers;
+    if (available > 0) {
+        // 同时挖掘 workers 个分区，每个占分区数据的 1 + kEngineOverhead 倍
+        size_t needed = workers * (1 + kEngineOverhead) * data_bytes;
+        count = std::max(count, (needed + available - 1) / available);
+    }
+    return count;
+}
+
+void SonMiner::mineChunk(DataLoader::Database chunk, size_t min_count, size_t total, int engine_threads,
+                         ItemsetSink& candidates) const {
+    if (chunk.empty()) {
+        return;
+    }
+    size_t local = localThreshold(min_count, chunk.size(), total);
+    DataLoader db(std::move(chunk), 1);
+    auto miner = MinerRegistry::instance().create(engine_, engine_threads);
+    miner->mine(DatasetView(db), SupportThreshold{static_cast<double>(local)}, candidates);
+}
+
+void SonMiner::mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) {
+    const DataLoader::Database& records = data.records();
+    size_t total = records.size();
+    size_t min_count = std::max<size_t>(threshold.resolve(data.transactionCount()), 1);
+    size_t available = budget_.limited() ? std::max<size_t>(budget_.availableFor(data.loader()), 1) : 0;
+    size_t threads = resolveThreadCount(thread_count_);
+
+    Stats stats;
+    stats.partitions = std::max<size_t>(1, std::min(partitionCount(data.loader().datasetBytes(), available), total));
+    stats.workers = std::min(threads, stats.partitions);
+    int engine_threads = static_cast<int>(std::max<size_t>(1, threads / stats.workers));
+    getThreadPool(threads);
+
+    // 第一遍：各分区独立挖掘，局部频繁项集的并集为候选
+    CandidateSink candidates;
+    {
+        ChunkRunner runner(stats.workers);
+        for (size_t p = 0; p < stats.partitions; p++) {
+            size_t begin = total * p / stats.partitions;
+            size_t end = total * (p + 1) / stats.partitions;
+            runner.submit([&, begin, end]() {
+                DataLoader::Database chunk(records.begin() + begin, records.begin() + end);
+                mineChunk(std::move(chunk), min_count, total, engine_threads, candidates);
+            });
+        }
+        runner.wait();
+    }
+
+    // 第二遍：统计候选的全局支持计数
+    CandidateCounter counter(candidates.candidates());
+    CandidateCounter::Counts counts = counter.emptyCounts();
+    counter.addRecords(records, static_cast<int>(threads), counts);
+    stats.candidates = counter.candidateCount();
+    stats.frequent = counter.emit(counts, min_count, sink);
+    finishStats(stats, "SON 分区挖掘");
+    sink.finish();
+}
+
+void SonMiner::mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink) {
+    size_t total = file.transactionCount();
+    size_t min_count = std::max<size_t>(threshold.resolve(total), 1);
+    size_t threads = resolveThreadCount(thread_count_);
+
+    // 打开文件时已扫描过一遍（事务总数、各项的支持计数），这里的两遍是文件的第二、三次读取；
+    // 各项支持计数的和就是去重后的项总数
+    size_t occurrences = 0;
+    for (size_t support : file.itemSupports()) {
+        occurrences += support;
+    }
+    size_t record_bytes = total * sizeof(DataLoader::Record) + occurrences * sizeof(int);
+    size_t partitions = std::max<size_t>(1, std::min(partitionCount(2 * record_bytes, budget_.bytes), total));
+    size_t chunk_size = std::max<size_t>(1, (total + partitions - 1) / partitions);
+
+    Stats stats;
+    stats.workers = std::min(threads, partitions);
+    int engine_threads = static_cast<int>(std::max<size_t>(1, threads / stats.workers));
+    getThreadPool(threads);
+
+    // 第一遍：顺序读取，每攒够一个分区就提交挖掘
+    CandidateSink candidates;
+    {
+        ChunkRunner runner(stats.workers);
+        DataLoader::Database chunk;
+        auto submit = [&]() {
+            runner.submit([&, chunk = std::move(chunk)]() mutable {
+                mineChunk(std::move(chunk), min_count, total, engine_threads, candidates);
+            });
+            chunk = DataLoader::Database();
+            stats.partitions++;
+        };
+        file.forEach([&](const DataLoader::Record& record) {
+            chunk.push_back(record);
+            if (chunk.size() == chunk_size) {
+                submit();
+            }
+        });
+        if (!chunk.empty()) {
+            submit();
+        }
+        runner.wait();
+    }
+
+    // 第二遍：按块读入并计数
+    CandidateCounter counter(candidates.candidates());
+    CandidateCounter::Counts counts = counter.emptyCounts();
+    DataLoader::Database block;
+    file.forEach([&](const DataLoader::Record& record) {
+        block.push_back(record);
+        if (block.size() == kCountBlock) {
+            counter.addRecords(block, static_cast<int>(threads), counts);
+            block.clear();
+        }
+    });
+    counter.addRecords(block, static_cast<int>(threads), counts);
+    stats.candidates = counter.candidateCount();
+    stats.frequent = counter.emit(counts, min_count, sink);
+    finishStats(stats, "流式 SON 分区挖掘");
+    sink.finish();
+}
+
+void SonMiner::finishStats(const Stats& stats, const string& mode) {
+    stats_ = stats;
+    fallback_ = mode + "（" + std::to_string(stats.partitions) + " 个分区，" + std::to_string(stats.workers)
+        + " 个线程并行；候选 " + std::to_string(stats.candidates) + " 个，全局频繁 " + std::to_string(stats.frequent) + " 个）";
+}
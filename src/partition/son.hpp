@@ -0,0 +1,96 @@
+#ifndef SON_HPP
+#define SON_HPP
+
+#include <cstddef>
+#include <string>
+#include "dataload/data_loader.hpp"
+#include "miner/miner.hpp"
+
+/**
+ * 检查引擎存在且输出全部频繁项集（分区、分片挖掘的前提）：
+ * 闭项集、最大项集在分区中局部成立不代表全局成立，候选的并集不完整
+ * @throws std::invalid_argument 引擎不存在或不输出全部频繁项集
+ */
+void requireFrequentEngine(const std::string& engine);
+
+/**
+ * SON 分区挖掘（Savasere-Omiecinski-Navathe）：
+ * 第一遍把事务切成若干分区，每个分区用任意频繁项集引擎按分区大小等比例缩小的阈值独立挖掘；
+ * 全局频繁的项集至少在一个分区中局部频繁，所以各分区结果的并集包含全部频繁项集。
+ * 第二遍扫描全部事务统计候选的全局支持计数，只保留达到阈值的候选，结果与直接挖掘完全相同。
+ * 分区之间互不依赖，在线程之间并行挖掘；第二遍按事务块并行计数。
+ */
+class SonMiner : public Miner {
+public:
+    struct Stats {
+        size_t partitions = 0;   // 分区数
+        size_t workers = 0;      // 并行挖掘分区的线程数
+        size_t candidates = 0;   // 各分区局部频繁项集的并集大小
+        size_t frequent = 0;     // 其中全局频繁的项集数
+    };
+
+    /**
+     * @param engine 挖掘分区的引擎名称（须输出全部频繁项集）
+     * @param thread_count 线程数，0 为硬件并发数
+     * @param partitions 分区数，0 表示按线程数和内存预算自动确定
+     * @throws std::invalid_argument 引擎不存在或不输出全部频繁项集
+     */
+    SonMiner(const std::string& engine, int thread_count, size_t partitions);
+
+    /**
+     * 与分区引擎同名，结果可以直接和该引擎比较
+     */
+    std::string name() const override {
+        return engine_;
+    }
+
+    void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) override;
+
+    /**
+     * 流式读取事务文件：第一遍每攒够一个分区就交给空闲线程挖掘，第二遍边读边计数，
+     * 同时在内存中的最多是正在挖掘的各分区。
+     * 加上 TransactionFile 打开时的统计扫描（事务总数用于换算阈值和切分区），文件共读取三遍
+     */
+    void mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink) override;
+
+    /**
+     * 上一次挖掘的统计
+     */
+    const Stats& stats() const noexcept {
+        return stats_;
+    }
+
+    /**
+     * 分区的局部支持计数阈值：ceil(min_count * chunk / total)，至少为 1
+     */
+    static size_t localThreshold(size_t min_count, size_t chunk, size_t total);
+
+private:
+    // 计数阶段每次读入的事务数（流式读取时）
+    static constexpr size_t kCountBlock = 1 << 16;
+
+    /**
+     * 分区数：未指定时取线程数；设置了内存预算时保证同时挖掘的分区（连同引擎的开销）放得进预算
+     * @param data_bytes 全部事务连同倒排索引载入内存后占用的字节数
+     * @param available 可用的字节数
+     */
+    size_t partitionCount(size_t data_bytes, size_t available) const;
+
+    /**
+     * 在一个分区上运行引擎，局部频繁项集推送到 candidates
+     */
+    void mineChunk(DataLoader::Database chunk, size_t min_count, size_t total, int engine_threads,
+                   ItemsetSink& candidates) const;
+
+    /**
+     * 记录本次的统计并生成运行模式说明
+     */
+    void finishStats(const Stats& stats, const std::string& mode);
+
+    std::string engine_;
+    int thread_count_;
+    size_t partitions_;
+    Stats stats_;
+};
+
+#endif // SON_HPP
@@ -0,0 +1,196 @@
+#include "memory.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+using std::string;
+
+std::atomic<bool> MemoryTracker::enabled_{false};
+std::atomic<uint64_t> MemoryTracker::generation_{0};
+
+const char* memoryCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::Records: return "records";
+        case MemoryCategory::InvertedIndex: return "inverted_index";
+        case MemoryCategory::TidLists: return "tid_lists";
+        case MemoryCategory::FpNodes: return "fp_nodes";
+        case MemoryCategory::PatternBases: return "pattern_bases";
+        case MemoryCategory::Results: return "results";
+        case MemoryCategory::Count: break;
+    }
+    return "unknown";
+}
+
+ProcessMemory ProcessMemory::read() {
+    ProcessMemory memory;
+    std::ifstream status("/proc/self/status");
+    string line;
+    while (std::getline(status, line)) {
+        // 形如 "VmHWM:     123456 kB"
+        size_t* target = nullptr;
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            target = &memory.rss;
+        } else if (line.compare(0, 6, "VmHWM:") == 0) {
+            target = &memory.peak;
+        }
+        if (target != nullptr) {
+            *target = static_cast<size_t>(std::strtoull(line.c_str() + 6, nullptr, 10)) * 1024;
+        }
+    }
+    return memory;
+}
+
+bool ProcessMemory::resetPeak() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if (!clear_refs) {
+        return false;
+    }
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+}
+
+MemoryTracker& MemoryTracker::instance() {
+    static MemoryTracker tracker;
+    return tracker;
+}
+
+void MemoryTracker::start() {
+    generation_.fetch_add(1, std::memory_order_relaxed);
+    for (size_t c = 0; c < kCategories; c++) {
+        current_[c].store(0, std::memory_order_relaxed);
+        peak_[c].store(0, std::memory_order_relaxed);
+        phase_peak_[c].store(0, std::memory_order_relaxed);
+    }
+    phases_.clear();
+    in_phase_ = false;
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void MemoryTracker::stop() {
+    if (in_phase_) {
+        endPhase();
+    }
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void MemoryTracker::add(MemoryCategory category, int64_t bytes) {
+    size_t c = static_cast<size_t>(category);
+    int64_t now = current_[c].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    if (bytes <= 0) {
+        return;
+    }
+    for (auto* peak : {&peak_[c], &phase_peak_[c]}) {
+        int64_t seen = peak->load(std::memory_order_relaxed);
+        while (now > seen && !peak->compare_exchange_weak(seen, now, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+void MemoryTracker::beginPhase(const string& name) {
+    if (in_phase_) {
+        endPhase();
+    }
+    current_phase_ = phases_.size();
+    for (size_t p = 0; p < phases_.size(); p++) {
+        if (phases_[p].name == name) {
+            current_phase_ = p;
+        }
+    }
+    bool exact = ProcessMemory::resetPeak();
+    ProcessMemory memory = ProcessMemory::read();
+    if (current_phase_ == phases_.size()) {
+        MemoryReport::Phase phase;
+        phase.name = name;
+        phase.rss_before = memory.rss;
+        phases_.push_back(phase);
+    }
+    phases_[current_phase_].peak_exact = phases_[current_phase_].peak_exact && exact;
+    for (size_t c = 0; c < kCategories; c++) {
+        phase_peak_[c].store(current_[c].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    in_phase_ = true;
+}
+
+void MemoryTracker::endPhase() {
+    if (!in_phase_) {
+        return;
+    }
+    in_phase_ = false;
+    ProcessMemory memory = ProcessMemory::read();
+    MemoryReport::Phase& phase = phases_[current_phase_];
+    phase.rss_after = memory.rss;
+    phase.peak_rss = std::max(phase.peak_rss, memory.peak);
+    for (size_t c = 0; c < kCategories; c++) {
+        int64_t peak = phase_peak_[c].load(std::memory_order_relaxed);
+        phase.peak[c] = std::max(phase.peak[c], static_cast<size_t>(std::max<int64_t>(peak, 0)));
+    }
+}
+
+MemoryReport MemoryTracker::report() const {
+    MemoryReport report;
+    report.phases = phases_;
+    for (size_t c = 0; c < kCategories; c++) {
+        report.current[c] = static_cast<size_t>(std::max<int64_t>(current_[c].load(std::memory_order_relaxed), 0));
+        report.peak[c] = static_cast<size_t>(std::max<int64_t>(peak_[c].load(std::memory_order_relaxed), 0));
+    }
+    report.process = ProcessMemory::read();
+    // 每个阶段开始时都重置了 VmHWM，整体峰值取各阶段峰值的最大值
+    for (const auto& phase : phases_) {
+        report.process.peak = std::max(report.process.peak, phase.peak_rss);
+    }
+    return report;
+}
+
+namespace {
+
+// 字节数显示为 MB，保留两位小数
+string megabytes(size_t bytes) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", bytes / (1024.0 * 1024.0));
+    return buffer;
+}
+
+} // namespace
+
+void MemoryReport::print(std::ostream& out) const {
+    char line[200];
+    const size_t categories = static_cast<size_t>(MemoryCategory::Count);
+    out << "\n========== 内存统计（MB）==========\n";
+    std::snprintf(line, sizeof(line), "%-20s %12s %12s %12s\n", "phase", "rss_before", "rss_after", "peak_rss");
+    out << line;
+    bool approximate = false;
+    for (const auto& phase : phases) {
+        std::snprintf(line, sizeof(line), "%-20s %12s %12s %11s%s\n", phase.name.c_str(),
+                      megabytes(phase.rss_before).c_str(), megabytes(phase.rss_after).c_str(),
+                      megabytes(phase.peak_rss).c_str(), phase.peak_exact ? " " : "*");
+        out << line;
+        approximate = approximate || !phase.peak_exact;
+    }
+    if (approximate) {
+        out << "（* 无法重置峰值，为进程启动以来的峰值）\n";
+    }
+
+    out << "\n";
+    std::snprintf(line, sizeof(line), "%-20s", "structure");
+    out << line;
+    for (const auto& phase : phases) {
+        std::snprintf(line, sizeof(line), " %14s", phase.name.c_str());
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), " %12s %12s\n", "peak", "current");
+    out << line;
+    for (size_t c = 0; c < categories; c++) {
+        std::snprintf(line, sizeof(line), "%-20s", memoryCategoryName(static_cast<MemoryCategory>(c)));
+        out << line;
+        for (const auto& phase : phases) {
+            std::snprintf(line, sizeof(line), " %14s", megabytes(phase.peak[c]).c_str());
+            out << line;
+        }
+        std::snprintf(line, sizeof(line), " %12s %12s\n", megabytes(peak[c]).c_str(), megabytes(current[c]).c_str());
+        out << line;
+    }
+    out << "\n进程 RSS: " << megabytes(process.rss) << " MB，峰值 RSS: " << megabytes(process.peak) << " MB\n";
+    out << "================================\n";
+}
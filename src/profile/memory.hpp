@@ -0,0 +1,216 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * 内存统计的数据结构分类
+ */
+enum class MemoryCategory : size_t {
+    Records,         // DataLoader 的原始记录
+    InvertedIndex,   // DataLoader 的倒排索引
+    TidLists,        // Apriori 各 level、CHARM / MAFIA 搜索树上的 tid 列表
+    FpNodes,         // FP 树节点（含子节点表，fptree 为估算值）
+    PatternBases,    // 条件模式基（路径列表）
+    Results,         // 结果池和闭 / 最大项集候选
+    Count
+};
+
+/**
+ * 分类的显示名称
+ */
+const char* memoryCategoryName(MemoryCategory category);
+
+/**
+ * 进程的常驻内存，读自 /proc/self/status（非 Linux 上为 0）
+ */
+struct ProcessMemory {
+    size_t rss = 0;    // VmRSS，字节
+    size_t peak = 0;   // VmHWM：常驻内存峰值，字节
+
+    static ProcessMemory read();
+
+    /**
+     * 把 VmHWM 重置为当前 RSS（写 /proc/self/clear_refs，需要 Linux 4.0+）
+     * @return 是否成功
+     */
+    static bool resetPeak();
+};
+
+/**
+ * 内存统计结果
+ */
+struct MemoryReport {
+    struct Phase {
+        std::string name;
+        size_t rss_before = 0;
+        size_t rss_after = 0;
+        size_t peak_rss = 0;          // 阶段内的常驻内存峰值
+        bool peak_exact = true;       // 峰值无法重置时为进程启动以来的峰值
+        size_t peak[static_cast<size_t>(MemoryCategory::Count)] = {};   // 阶段内各分类的峰值
+    };
+
+    std::vector<Phase> phases;
+    size_t current[static_cast<size_t>(MemoryCategory::Count)] = {};
+    size_t peak[static_cast<size_t>(MemoryCategory::Count)] = {};
+    ProcessMemory process;
+
+    /**
+     * 打印各阶段的 RSS 与峰值，以及各数据结构的峰值和当前占用
+     */
+    void print(std::ostream& out) const;
+};
+
+/**
+ * 按数据结构统计的内存占用：各结构在分配或释放时通过 MemoryCharge 登记字节数，
+ * 记录当前值和峰值；再按阶段记录进程 RSS 和峰值 RSS，用于估算机器规格和发现内存回归
+ * 登记是粗粒度的（每棵树、每个 level、每组 tid 列表一次），未启用时每次登记只有一次原子读
+ */
+class MemoryTracker {
+public:
+    static MemoryTracker& instance();
+
+    static bool enabled() noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 清空统计并开始记录；之前登记的字节数不再计入
+     */
+    void start();
+
+    /**
+     * 停止记录（已有数据保留到下次 start）
+     */
+    void stop();
+
+    /**
+     * 开始一个阶段：重置峰值 RSS 和阶段内各分类的峰值
+     */
+    void beginPhase(const std::string& name);
+
+    /**
+     * 结束当前阶段（同名阶段的峰值取最大）
+     */
+    void endPhase();
+
+    MemoryReport report() const;
+
+private:
+    friend class MemoryCharge;
+
+    static constexpr size_t kCategories = static_cast<size_t>(MemoryCategory::Count);
+
+    MemoryTracker() = default;
+
+    static uint64_t generation() noexcept {
+        return generation_.load(std::memory_order_relaxed);
+    }
+
+    void add(MemoryCategory category, int64_t bytes);
+
+    static std::atomic<bool> enabled_;
+    static std::atomic<uint64_t> generation_;   // 每次 start 递增，旧的登记在释放时忽略
+
+    std::atomic<int64_t> current_[kCategories] = {};
+    std::atomic<int64_t> peak_[kCategories] = {};
+    std::atomic<int64_t> phase_peak_[kCategories] = {};
+
+    std::vector<MemoryReport::Phase> phases_;
+    size_t current_phase_ = 0;
+    bool in_phase_ = false;
+};
+
+/**
+ * 一块登记在某个分类下的内存：析构或重新登记时自动释放之前的字节数
+ * 作为数据结构的成员或局部变量使用；复制时按同样的字节数重新登记（副本确实占用同样的内存）
+ */
+class MemoryCharge {
+public:
+    MemoryCharge() = default;
+
+    MemoryCharge(MemoryCategory category, size_t bytes) {
+        set(category, bytes);
+    }
+
+    MemoryCharge(const MemoryCharge& other) {
+        set(other.category_, other.bytes_);
+    }
+
+    MemoryCharge(MemoryCharge&& other) noexcept
+        : category_(other.category_), bytes_(other.bytes_), generation_(other.generation_) {
+        other.bytes_ = 0;
+    }
+
+    MemoryCharge& operator=(const MemoryCharge& other) {
+        if (this != &other) {
+            set(other.category_, other.bytes_);
+        }
+        return *this;
+    }
+
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+        if (this != &other) {
+            release();
+            category_ = other.category_;
+            bytes_ = other.bytes_;
+            generation_ = other.generation_;
+            other.bytes_ = 0;
+        }
+        return *this;
+    }
+
+    ~MemoryCharge() {
+        release();
+    }
+
+    /**
+     * 改为登记 bytes 字节（未启用统计时只释放之前的登记）
+     */
+    void set(MemoryCategory category, size_t bytes) {
+        release();
+        if (bytes > 0 && MemoryTracker::enabled()) {
+            category_ = category;
+            bytes_ = bytes;
+            generation_ = MemoryTracker::generation();
+            MemoryTracker::instance().add(category_, static_cast<int64_t>(bytes_));
+        }
+    }
+
+    void release() {
+        if (bytes_ > 0) {
+            if (generation_ == MemoryTracker::generation()) {
+                MemoryTracker::instance().add(category_, -static_cast<int64_t>(bytes_));
+            }
+            bytes_ = 0;
+        }
+    }
+
+    size_t bytes() const noexcept {
+        return bytes_;
+    }
+
+private:
+    MemoryCategory category_ = MemoryCategory::Records;
+    size_t bytes_ = 0;
+    uint64_t generation_ = 0;
+};
+
+/**
+ * 二维 vector 占用的堆内存（外层数组 + 每个内层数组的容量）
+ */
+template <typename T>
+size_t nestedVectorBytes(const std::vector<std::vector<T>>& rows) {
+    size_t bytes = rows.capacity() * sizeof(std::vector<T>);
+    for (const auto& row : rows) {
+        bytes += row.capacity() * sizeof(T);
+    }
+    return bytes;
+}
+
+#endif // MEMORY_TRACKER_HPP
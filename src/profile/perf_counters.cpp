@@ -0,0 +1,287 @@
+#include "perf_counters.hpp"
+#include "profile/profiler.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using std::string;
+using std::vector;
+
+PerfCounters::Sample& PerfCounters::Sample::operator+=(const Sample& other) {
+    for (size_t e = 0; e < Count; e++) {
+        if (other.available[e]) {
+            values[e] += other.values[e];
+            available[e] = true;
+        }
+    }
+    return *this;
+}
+
+const char* PerfCounters::eventName(Event event) {
+    switch (event) {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case L1DMisses: return "L1d-misses";
+        case LLCMisses: return "LLC-misses";
+        case BranchMisses: return "branch-misses";
+        case DTLBMisses: return "dTLB-misses";
+        case TaskClock: return "task-clock(ns)";
+        case PageFaults: return "page-faults";
+        case Count: break;
+    }
+    return "unknown";
+}
+
+PerfCounters::~PerfCounters() {
+    closeAll();
+}
+
+#ifdef __linux__
+
+namespace {
+
+perf_event_attr eventAttr(PerfCounters::Event event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    auto cache = [](uint64_t cache_id) {
+        return cache_id | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+    switch (event) {
+        case PerfCounters::Cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounters::Instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounters::L1DMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case PerfCounters::LLCMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case PerfCounters::BranchMisses:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfCounters::DTLBMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        case PerfCounters::TaskClock:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_TASK_CLOCK;
+            break;
+        case PerfCounters::PageFaults:
+            attr.type = PERF_TYPE_SOFTWARE;
+            attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+            break;
+        case PerfCounters::Count:
+            break;
+    }
+    return attr;
+}
+
+vector<pid_t> processThreads() {
+    vector<pid_t> tids;
+    DIR* dir = opendir("/proc/self/task");
+    if (dir == nullptr) {
+        tids.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+        return tids;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            tids.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+        }
+    }
+    closedir(dir);
+    return tids;
+}
+
+} // namespace
+
+bool PerfCounters::start() {
+    closeAll();
+    error_.clear();
+    vector<pid_t> tids = processThreads();
+    bool any = false;
+    for (size_t e = 0; e < Count; e++) {
+        perf_event_attr attr = eventAttr(static_cast<Event>(e));
+        for (pid_t tid : tids) {
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+            if (fd < 0) {
+                // 线程可能刚好退出；第一个线程都打不开说明事件不可用
+                if (fds_[e].empty() && tid == tids.front()) {
+                    error_ += string(error_.empty() ? "" : "，") + eventName(static_cast<Event>(e)) + ": " + std::strerror(errno);
+                    break;
+                }
+                continue;
+            }
+            fds_[e].push_back(fd);
+        }
+        any = any || !fds_[e].empty();
+    }
+    for (size_t e = 0; e < Count; e++) {
+        for (int fd : fds_[e]) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    return any;
+}
+
+PerfCounters::Sample PerfCounters::stop() {
+    Sample sample;
+    for (size_t e = 0; e < Count; e++) {
+        for (int fd : fds_[e]) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (size_t e = 0; e < Count; e++) {
+        for (int fd : fds_[e]) {
+            uint64_t data[3] = {0, 0, 0};   // 值、enabled 时间、running 时间
+            if (read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+                continue;
+            }
+            // 计数器被多路复用时按运行时间比例换算
+            double value = static_cast<double>(data[0]);
+            if (data[2] > 0 && data[2] < data[1]) {
+                value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+            }
+            sample.values[e] += static_cast<uint64_t>(value);
+            sample.available[e] = true;
+        }
+    }
+    closeAll();
+    return sample;
+}
+
+void PerfCounters::closeAll() {
+    for (auto& fds : fds_) {
+        for (int fd : fds) {
+            close(fd);
+        }
+        fds.clear();
+    }
+}
+
+#else
+
+bool PerfCounters::start() {
+    error_ = "性能计数器仅支持 Linux";
+    return false;
+}
+
+PerfCounters::Sample PerfCounters::stop() {
+    return Sample();
+}
+
+void PerfCounters::closeAll() {
+}
+
+#endif
+
+void PerfPhases::begin(const string& name) {
+    current_ = phases_.size();
+    for (size_t p = 0; p < phases_.size(); p++) {
+        if (phases_[p].name == name) {
+            current_ = p;
+        }
+    }
+    if (current_ == phases_.size()) {
+        phases_.push_back(Phase{name, PerfCounters::Sample(), 0, 0});
+    }
+    ProfileReport report = Profiler::instance().report();
+    intersections_start_ = report.counters[static_cast<size_t>(ProfileCounter::Intersections)];
+    nodes_start_ = report.counters[static_cast<size_t>(ProfileCounter::NodesAllocated)];
+    running_ = counters_.start();
+    if (error_.empty()) {
+        error_ = counters_.error();
+    }
+}
+
+void PerfPhases::end() {
+    if (current_ >= phases_.size()) {
+        return;
+    }
+    Phase& phase = phases_[current_];
+    if (running_) {
+        phase.sample += counters_.stop();
+    }
+    running_ = false;
+    ProfileReport report = Profiler::instance().report();
+    phase.intersections += report.counters[static_cast<size_t>(ProfileCounter::Intersections)] - intersections_start_;
+    phase.nodes += report.counters[static_cast<size_t>(ProfileCounter::NodesAllocated)] - nodes_start_;
+    current_ = phases_.size();
+}
+
+void PerfPhases::print(std::ostream& out) const {
+    char cell[64];
+    auto value = [&cell](const PerfCounters::Sample& sample, size_t e) -> const char* {
+        if (!sample.available[e]) {
+            return "-";
+        }
+        std::snprintf(cell, sizeof(cell), "%llu", static_cast<unsigned long long>(sample.values[e]));
+        return cell;
+    };
+
+    out << "\n========== 硬件性能计数器 ==========\n";
+    if (!error_.empty()) {
+        out << "不可用的事件: " << error_ << "\n";
+    }
+    for (const auto& phase : phases_) {
+        out << "[" << phase.name << "]\n";
+        for (size_t e = 0; e < PerfCounters::Count; e++) {
+            std::snprintf(cell, sizeof(cell), "  %-16s ", PerfCounters::eventName(static_cast<PerfCounters::Event>(e)));
+            out << cell;
+            out << value(phase.sample, e) << "\n";
+        }
+        if (phase.sample.available[PerfCounters::Cycles] && phase.sample.available[PerfCounters::Instructions]) {
+            std::snprintf(cell, sizeof(cell), "  %-16s %.3f\n", "IPC", phase.sample.ipc());
+            out << cell;
+        }
+        // 每次求交 / 每个节点的缺失数：衡量数据布局改动（CSR、紧凑节点、位图）的缓存效果
+        const PerfCounters::Event misses[] = {PerfCounters::L1DMisses, PerfCounters::LLCMisses,
+                                              PerfCounters::BranchMisses, PerfCounters::DTLBMisses};
+        const std::pair<const char*, uint64_t> units[] = {{"intersection", phase.intersections}, {"node", phase.nodes}};
+        for (const auto& unit : units) {
+            if (unit.second == 0) {
+                continue;
+            }
+            out << "  per " << unit.first << " (" << unit.second << "):";
+            bool any = false;
+            for (auto e : misses) {
+                if (phase.sample.available[e]) {
+                    std::snprintf(cell, sizeof(cell), " %s=%.2f", PerfCounters::eventName(e),
+                                  static_cast<double>(phase.sample.values[e]) / static_cast<double>(unit.second));
+                    out << cell;
+                    any = true;
+                }
+            }
+            if (phase.sample.available[PerfCounters::Cycles]) {
+                std::snprintf(cell, sizeof(cell), " cycles=%.1f",
+                              static_cast<double>(phase.sample.values[PerfCounters::Cycles]) / static_cast<double>(unit.second));
+                out << cell;
+                any = true;
+            }
+            out << (any ? "\n" : " （缺失计数不可用）\n");
+        }
+    }
+    out << "================================\n";
+}
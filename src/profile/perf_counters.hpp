@@ -0,0 +1,119 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * 硬件（及软件）性能计数器：基于 Linux perf_event_open，只统计用户态
+ * 开始时为进程中已有的每个线程各打开一组计数器，结束时读数求和，因此线程池中的工作线程也计算在内；
+ * 阶段进行中新建的线程不计入。虚拟机或权限不足（perf_event_paranoid）时硬件事件可能打不开，
+ * 每个事件单独打开，打不开的事件记为不可用，其余照常统计。非 Linux 平台上全部不可用。
+ */
+class PerfCounters {
+public:
+    enum Event : size_t {
+        Cycles,
+        Instructions,
+        L1DMisses,       // L1 数据缓存读缺失
+        LLCMisses,       // 末级缓存读缺失
+        BranchMisses,
+        DTLBMisses,      // 数据 TLB 读缺失
+        TaskClock,       // 软件事件：CPU 时间（纳秒）
+        PageFaults,      // 软件事件：缺页次数
+        Count
+    };
+
+    /**
+     * 一次测量的结果：多路复用时按 enabled/running 时间比例换算
+     */
+    struct Sample {
+        uint64_t values[Count] = {};
+        bool available[Count] = {};
+
+        double ipc() const {
+            return available[Cycles] && available[Instructions] && values[Cycles] > 0
+                ? static_cast<double>(values[Instructions]) / static_cast<double>(values[Cycles]) : 0.0;
+        }
+
+        Sample& operator+=(const Sample& other);
+    };
+
+    static const char* eventName(Event event);
+
+    PerfCounters() = default;
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * 为当前所有线程打开计数器并开始计数
+     * @return 至少有一个事件可用
+     */
+    bool start();
+
+    /**
+     * 停止计数，读取并关闭计数器
+     */
+    Sample stop();
+
+    /**
+     * 打不开的事件及原因（start 之后有效）
+     */
+    const std::string& error() const noexcept {
+        return error_;
+    }
+
+private:
+    void closeAll();
+
+    std::vector<int> fds_[Count];
+    std::string error_;
+};
+
+/**
+ * 按阶段累积的性能计数，附带同一阶段的剖析器计数（求交次数、节点数），用于换算每次求交 / 每个节点的缺失数
+ */
+class PerfPhases {
+public:
+    struct Phase {
+        std::string name;
+        PerfCounters::Sample sample;
+        uint64_t intersections = 0;
+        uint64_t nodes = 0;
+    };
+
+    /**
+     * 开始一个阶段（同名阶段累加）
+     */
+    void begin(const std::string& name);
+
+    /**
+     * 结束当前阶段
+     */
+    void end();
+
+    const std::vector<Phase>& phases() const noexcept {
+        return phases_;
+    }
+
+    /**
+     * 打印每个阶段的计数、IPC，以及每次求交 / 每个节点的缺失数
+     */
+    void print(std::ostream& out) const;
+
+private:
+    PerfCounters counters_;
+    std::vector<Phase> phases_;
+    size_t current_ = 0;
+    uint64_t intersections_start_ = 0;
+    uint64_t nodes_start_ = 0;
+    bool running_ = false;
+    std::string error_;
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,202 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+using std::string;
+using std::vector;
+
+std::atomic<bool> Profiler::enabled_{false};
+
+const char* profileCounterName(ProfileCounter counter) {
+    switch (counter) {
+        case ProfileCounter::CandidatesGenerated: return "candidates_generated";
+        case ProfileCounter::CandidatesPruned: return "candidates_pruned";
+        case ProfileCounter::Intersections: return "intersections";
+        case ProfileCounter::NodesAllocated: return "nodes_allocated";
+        case ProfileCounter::BytesAllocated: return "bytes_allocated";
+        case ProfileCounter::Count: break;
+    }
+    return "unknown";
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadRecord& Profiler::local() {
+    thread_local ThreadRecord* record = nullptr;
+    if (record == nullptr) {
+        Profiler& profiler = instance();
+        std::lock_guard<std::mutex> lock(profiler.mutex_);
+        profiler.threads_.push_back(std::make_unique<ThreadRecord>());
+        record = profiler.threads_.back().get();
+        record->tid = static_cast<uint32_t>(profiler.threads_.size() - 1);
+    }
+    return *record;
+}
+
+void Profiler::start(size_t max_events_per_thread) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& thread : threads_) {
+        std::fill(std::begin(thread->counters), std::end(thread->counters), 0);
+        thread->events.clear();
+        thread->timers.clear();
+        thread->dropped = 0;
+    }
+    max_events_ = max_events_per_thread;
+    epoch_ = Clock::now();
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Profiler::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+    stopped_ = Clock::now();
+}
+
+void Profiler::record(ThreadRecord& thread, const char* name, uint64_t start_ns, uint64_t duration_ns) {
+    // 同一线程内的计时器名称很少，按指针线性查找
+    TimerStat* stat = nullptr;
+    for (auto& timer : thread.timers) {
+        if (timer.name == name) {
+            stat = &timer;
+            break;
+        }
+    }
+    if (stat == nullptr) {
+        thread.timers.push_back(TimerStat{name, 0, 0, 0});
+        stat = &thread.timers.back();
+    }
+    stat->calls++;
+    stat->total_ns += duration_ns;
+    stat->max_ns = std::max(stat->max_ns, duration_ns);
+
+    if (thread.events.size() < max_events_) {
+        thread.events.push_back(Event{name, start_ns, duration_ns});
+    } else {
+        thread.dropped++;
+    }
+}
+
+ProfileReport Profiler::report() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ProfileReport report;
+    report.wall_ns = enabled() ? sinceEpoch(Clock::now()) : sinceEpoch(stopped_);
+
+    // 不同编译单元中同名字面量的地址可能不同，按内容合并
+    std::map<string, ProfileReport::Timer> timers;
+    for (const auto& thread : threads_) {
+        bool active = !thread->timers.empty();
+        for (size_t c = 0; c < static_cast<size_t>(ProfileCounter::Count); c++) {
+            report.counters[c] += thread->counters[c];
+            active = active || thread->counters[c] != 0;
+        }
+        if (!active) {
+            continue;
+        }
+        ProfileReport::Thread summary;
+        summary.tid = thread->tid;
+        std::copy(std::begin(thread->counters), std::end(thread->counters), summary.counters);
+        summary.events = thread->events.size();
+        summary.dropped = thread->dropped;
+        report.threads.push_back(summary);
+
+        for (const auto& stat : thread->timers) {
+            auto& timer = timers[stat.name];
+            timer.name = stat.name;
+            timer.calls += stat.calls;
+            timer.total_ns += stat.total_ns;
+            timer.max_ns = std::max(timer.max_ns, stat.max_ns);
+            timer.threads++;
+        }
+    }
+    for (auto& entry : timers) {
+        report.timers.push_back(std::move(entry.second));
+    }
+    std::sort(report.timers.begin(), report.timers.end(), [](const ProfileReport::Timer& a, const ProfileReport::Timer& b) {
+        return a.total_ns > b.total_ns;
+    });
+    return report;
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    char buffer[256];
+    bool first = true;
+    auto separator = [&out, &first]() {
+        out << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    uint64_t end_ns = enabled() ? sinceEpoch(Clock::now()) : sinceEpoch(stopped_);
+    for (const auto& thread : threads_) {
+        bool active = !thread->events.empty();
+        for (uint64_t value : thread->counters) {
+            active = active || value != 0;
+        }
+        if (!active) {
+            continue;
+        }
+        separator();
+        std::snprintf(buffer, sizeof(buffer),
+                      "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+                      thread->tid, thread->tid);
+        out << buffer;
+        // 完整事件：ts 和 dur 以微秒为单位
+        for (const auto& event : thread->events) {
+            separator();
+            std::snprintf(buffer, sizeof(buffer),
+                          "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                          event.name, thread->tid, event.start_ns / 1000.0, event.duration_ns / 1000.0);
+            out << buffer;
+        }
+        // 线程的计数器总值作为结束时刻的计数器事件
+        separator();
+        std::snprintf(buffer, sizeof(buffer), "{\"name\":\"counters\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{",
+                      thread->tid, end_ns / 1000.0);
+        out << buffer;
+        for (size_t c = 0; c < static_cast<size_t>(ProfileCounter::Count); c++) {
+            out << (c > 0 ? "," : "") << '"' << profileCounterName(static_cast<ProfileCounter>(c)) << "\":" << thread->counters[c];
+        }
+        out << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void ProfileReport::print(std::ostream& out) const {
+    char line[200];
+    out << "\n========== 性能剖析（总时长 " << wall_ns / 1000000.0 << " ms）==========\n";
+    std::snprintf(line, sizeof(line), "%-28s %10s %12s %12s %12s %6s\n",
+                  "timer", "calls", "total(ms)", "mean(us)", "max(ms)", "thr");
+    out << line;
+    for (const auto& timer : timers) {
+        std::snprintf(line, sizeof(line), "%-28s %10llu %12.2f %12.2f %12.2f %6zu\n", timer.name.c_str(),
+                      static_cast<unsigned long long>(timer.calls), timer.total_ns / 1e6,
+                      timer.calls > 0 ? timer.total_ns / 1e3 / static_cast<double>(timer.calls) : 0.0,
+                      timer.max_ns / 1e6, timer.threads);
+        out << line;
+    }
+
+    out << "\n";
+    std::snprintf(line, sizeof(line), "%-28s %16s  %s\n", "counter", "total", "per thread");
+    out << line;
+    for (size_t c = 0; c < static_cast<size_t>(ProfileCounter::Count); c++) {
+        std::snprintf(line, sizeof(line), "%-28s %16llu ", profileCounterName(static_cast<ProfileCounter>(c)),
+                      static_cast<unsigned long long>(counters[c]));
+        out << line;
+        for (const auto& thread : threads) {
+            out << " " << thread.tid << ":" << thread.counters[c];
+        }
+        out << "\n";
+    }
+    size_t dropped = 0;
+    for (const auto& thread : threads) {
+        dropped += thread.dropped;
+    }
+    if (dropped > 0) {
+        out << "（trace 事件超过每线程上限，" << dropped << " 个事件只计入汇总）\n";
+    }
+    out << "================================\n";
+}
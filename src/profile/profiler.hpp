@@ -0,0 +1,181 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * 热路径计数器
+ */
+enum class ProfileCounter : size_t {
+    CandidatesGenerated,   // 生成的候选项集（Apriori 的连接结果、CHARM/MAFIA 尝试的扩展）
+    CandidatesPruned,      // 因支持计数不足被剪掉的候选
+    Intersections,         // tid列表求交次数
+    NodesAllocated,        // 分配的FP树节点数
+    BytesAllocated,        // 节点和tid列表占用的字节数
+    Count
+};
+
+/**
+ * 计数器的显示名称
+ */
+const char* profileCounterName(ProfileCounter counter);
+
+/**
+ * 汇总后的剖析结果
+ */
+struct ProfileReport {
+    struct Timer {
+        std::string name;
+        uint64_t calls = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;     // 单次最长
+        size_t threads = 0;      // 出现过该计时器的线程数
+    };
+    struct Thread {
+        uint32_t tid = 0;
+        uint64_t counters[static_cast<size_t>(ProfileCounter::Count)] = {};
+        size_t events = 0;
+        size_t dropped = 0;      // 超过事件上限未记录的事件数
+    };
+
+    std::vector<Timer> timers;   // 按总耗时降序
+    std::vector<Thread> threads; // 有数据的线程
+    uint64_t counters[static_cast<size_t>(ProfileCounter::Count)] = {};
+    uint64_t wall_ns = 0;        // start() 到 stop() 的时间
+
+    /**
+     * 打印汇总表：计时器（调用次数、总耗时、平均、最长）和计数器（总计及各线程）
+     */
+    void print(std::ostream& out) const;
+};
+
+/**
+ * 低开销的剖析器：每个线程在自己的记录中累加计数和计时，不加锁；未启用时每个埋点只有一次原子读
+ * 计时器同时按名称聚合并记录为 Chrome trace 事件（每个线程的事件数有上限，超出部分只聚合不记录）
+ * 数据在 start() 时清空，应在没有挖掘任务运行时调用 start()/stop() 和导出
+ */
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 每个线程默认最多记录的 trace 事件数
+    static constexpr size_t kDefaultMaxEvents = 1 << 18;
+
+    static Profiler& instance();
+
+    static bool enabled() noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * 清空所有线程的数据并开始记录
+     */
+    void start(size_t max_events_per_thread = kDefaultMaxEvents);
+
+    /**
+     * 停止记录（已有数据保留到下次 start）
+     */
+    void stop();
+
+    /**
+     * 累加当前线程的计数器
+     */
+    static void count(ProfileCounter counter, uint64_t n = 1) {
+        if (enabled()) {
+            local().counters[static_cast<size_t>(counter)] += n;
+        }
+    }
+
+    /**
+     * 汇总所有线程的数据
+     */
+    ProfileReport report() const;
+
+    /**
+     * 导出 Chrome trace-event JSON（chrome://tracing 或 Perfetto 打开）
+     */
+    void writeChromeTrace(std::ostream& out) const;
+
+private:
+    friend class ProfileScope;
+
+    struct Event {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+
+    struct TimerStat {
+        const char* name;
+        uint64_t calls;
+        uint64_t total_ns;
+        uint64_t max_ns;
+    };
+
+    // 每个线程的记录：只由所属线程写入
+    struct ThreadRecord {
+        uint32_t tid = 0;
+        uint64_t counters[static_cast<size_t>(ProfileCounter::Count)] = {};
+        std::vector<Event> events;
+        std::vector<TimerStat> timers;
+        size_t dropped = 0;
+    };
+
+    Profiler() = default;
+
+    static ThreadRecord& local();
+
+    void record(ThreadRecord& thread, const char* name, uint64_t start_ns, uint64_t duration_ns);
+
+    uint64_t sinceEpoch(Clock::time_point t) const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t - epoch_).count());
+    }
+
+    static std::atomic<bool> enabled_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<ThreadRecord>> threads_;   // 线程退出后记录仍保留
+    Clock::time_point epoch_ = Clock::now();
+    Clock::time_point stopped_ = Clock::now();
+    size_t max_events_ = kDefaultMaxEvents;
+};
+
+/**
+ * 作用域计时：构造到析构的时间计入名为 name 的计时器（name 须为字符串字面量）
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name_(name) {
+        if (Profiler::enabled()) {
+            thread_ = &Profiler::local();
+            start_ = Profiler::Clock::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (thread_ != nullptr) {
+            auto end = Profiler::Clock::now();
+            auto& profiler = Profiler::instance();
+            profiler.record(*thread_, name_, profiler.sinceEpoch(start_),
+                            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count()));
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_;
+    Profiler::ThreadRecord* thread_ = nullptr;
+    Profiler::Clock::time_point start_;
+};
+
+#endif // PROFILER_HPP
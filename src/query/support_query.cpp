@@ -0,0 +1,211 @@
+#include "support_query.hpp"
+#include "miner/tidlist.hpp"
+#include "profile/profiler.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+
+using std::vector;
+
+namespace {
+
+// 两个列表的交集大小：长度相差悬殊时短表在长表中倍增查找，否则直接归并
+size_t countPair(const vector<int>& small, const vector<int>& large) {
+    size_t count = 0;
+    if (small.size() * 16 < large.size()) {
+        size_t cursor = 0;
+        for (int tid : small) {
+            cursor = gallopLowerBound(large, cursor, tid);
+            if (cursor == large.size()) {
+                break;
+            }
+            if (large[cursor] == tid) {
+                count++;
+                cursor++;
+            }
+        }
+        return count;
+    }
+    size_t i = 0, j = 0;
+    if (large.size() <= small.size() * 2) {
+        // 长度接近时比较结果难以预测，用无分支的归并
+        while (i < small.size() && j < large.size()) {
+            int a = small[i];
+            int b = large[j];
+            count += a == b;
+            i += a <= b;
+            j += b <= a;
+        }
+        return count;
+    }
+    while (i < small.size() && j < large.size()) {
+        if (small[i] < large[j]) {
+            i++;
+        } else if (small[i] > large[j]) {
+            j++;
+        } else {
+            count++;
+            i++;
+            j++;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+SupportQuery::SupportQuery(const DataLoader& db) : db_(db) {
+}
+
+vector<int> SupportQuery::canonical(const vector<int>& itemset) const {
+    vector<int> items = itemset;
+    std::sort(items.begin(), items.end());
+    items.erase(std::unique(items.begin(), items.end()), items.end());
+    std::stable_sort(items.begin(), items.end(), [this](int a, int b) {
+        return db_.getElementSupport(a) < db_.getElementSupport(b);
+    });
+    return items;
+}
+
+size_t SupportQuery::countIntersection(vector<const vector<int>*> lists) {
+    Profiler::count(ProfileCounter::Intersections);
+    if (lists.empty()) {
+        return 0;
+    }
+    std::sort(lists.begin(), lists.end(), [](const vector<int>* a, const vector<int>* b) {
+        return a->size() < b->size();
+    });
+    if (lists[0]->empty()) {
+        return 0;
+    }
+    if (lists.size() == 1) {
+        return lists[0]->size();
+    }
+    if (lists.size() == 2) {
+        return countPair(*lists[0], *lists[1]);
+    }
+
+    const vector<int>& shortest = *lists[0];
+    vector<size_t> cursors(lists.size(), 0);
+    // 第二个列表与最短列表长度接近时相邻候选的间隔很小，逐个前进比倍增查找更快；
+    // 能到达后面列表的候选已被前面的列表筛过，稀疏得多，总是倍增查找
+    vector<char> linear(lists.size(), 0);
+    linear[1] = lists[1]->size() <= shortest.size() * 4;
+    size_t count = 0;
+    size_t i = 0;
+    while (i < shortest.size()) {
+        int candidate = shortest[i];
+        size_t k = 1;
+        for (; k < lists.size(); k++) {
+            const vector<int>& list = *lists[k];
+            size_t& cursor = cursors[k];
+            if (linear[k]) {
+                while (cursor < list.size() && list[cursor] < candidate) {
+                    cursor++;
+                }
+            } else {
+                cursor = gallopLowerBound(list, cursor, candidate);
+            }
+            if (cursor == list.size()) {
+                return count;
+            }
+            if (list[cursor] != candidate) {
+                break;
+            }
+        }
+        if (k == lists.size()) {
+            count++;
+            i++;
+        } else {
+            // 候选跳到更长列表中遇到的更大记录，最短列表中间的记录全部跳过
+            int next = (*lists[k])[cursors[k]];
+            if (linear[k]) {
+                while (i < shortest.size() && shortest[i] < next) {
+                    i++;
+                }
+            } else {
+                i = gallopLowerBound(shortest, i + 1, next);
+            }
+        }
+    }
+    return count;
+}
+
+uint32_t SupportQuery::support(const vector<int>& itemset) const {
+    if (itemset.empty()) {
+        return static_cast<uint32_t>(db_.all_count);
+    }
+    vector<const vector<int>*> lists;
+    for (int item : itemset) {
+        lists.push_back(&db_.getRecordsByElement(item));
+    }
+    return static_cast<uint32_t>(countIntersection(std::move(lists)));
+}
+
+vector<uint32_t> SupportQuery::supportBatch(const vector<vector<int>>& itemsets, int thread_count) const {
+    vector<vector<int>> queries(itemsets.size());
+    for (size_t q = 0; q < itemsets.size(); q++) {
+        queries[q] = canonical(itemsets[q]);
+    }
+    // 按规范顺序的字典序排序，共享前缀的查询相邻
+    vector<size_t> order(queries.size());
+    for (size_t q = 0; q < order.size(); q++) {
+        order[q] = q;
+    }
+    std::sort(order.begin(), order.end(), [&queries](size_t a, size_t b) {
+        return queries[a] < queries[b];
+    });
+
+    vector<uint32_t> out(itemsets.size(), 0);
+    size_t threads = thread_count > 1 ? static_cast<size_t>(thread_count) : 1;
+    parallelFor(order.size(), threads, 256, [&](size_t begin, size_t end) {
+        runSorted(queries, order, begin, end, out);
+    });
+    return out;
+}
+
+void SupportQuery::runSorted(const vector<vector<int>>& queries, const vector<size_t>& order,
+                             size_t begin, size_t end, vector<uint32_t>& out) const {
+    // prefixes[d] 为当前查询前 d+1 个项的交集（d > 0 时有效，前1个项直接使用倒排索引），
+    // 只保存后面的查询还会用到的前缀
+    vector<vector<int>> prefixes;
+    auto prefix = [this, &prefixes](const vector<int>& query, size_t d) -> const vector<int>& {
+        return d == 0 ? db_.getRecordsByElement(query[0]) : prefixes[d];
+    };
+    auto commonPrefix = [](const vector<int>& a, const vector<int>& b) {
+        size_t n = std::min(a.size(), b.size());
+        size_t d = 0;
+        while (d < n && a[d] == b[d]) {
+            d++;
+        }
+        return d;
+    };
+
+    for (size_t r = begin; r < end; r++) {
+        const vector<int>& query = queries[order[r]];
+        if (query.empty()) {
+            out[order[r]] = static_cast<uint32_t>(db_.all_count);
+            continue;
+        }
+        // 与上一个查询共享的前缀已经求好；与下一个查询共享的部分需要物化
+        size_t shared = std::min(prefixes.size(), r > begin ? commonPrefix(query, queries[order[r - 1]]) : size_t(0));
+        size_t keep = r + 1 < end ? commonPrefix(query, queries[order[r + 1]]) : 0;
+        prefixes.resize(std::max<size_t>(shared, 1));
+        for (size_t d = prefixes.size(); d < keep; d++) {
+            vector<int> next;
+            intersectTids(prefix(query, d - 1), db_.getRecordsByElement(query[d]), 0, next);
+            prefixes.push_back(std::move(next));
+        }
+
+        // 剩余的项与最长的已知前缀一起做多路求交
+        size_t known = std::max<size_t>(1, std::min(prefixes.size(), query.size()));
+        if (known == query.size()) {
+            out[order[r]] = static_cast<uint32_t>(prefix(query, known - 1).size());
+            continue;
+        }
+        vector<const vector<int>*> lists{&prefix(query, known - 1)};
+        for (size_t d = known; d < query.size(); d++) {
+            lists.push_back(&db_.getRecordsByElement(query[d]));
+        }
+        out[order[r]] = static_cast<uint32_t>(countIntersection(std::move(lists)));
+    }
+}
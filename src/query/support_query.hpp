@@ -0,0 +1,51 @@
+#ifndef SUPPORT_QUERY_HPP
+#define SUPPORT_QUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dataload/data_loader.hpp"
+
+/**
+ * 任意项集的支持计数查询（不需要挖掘）
+ * 直接在倒排索引上做多路求交：各项的记录索引列表按长度升序，候选记录总是取自最短的列表，
+ * 依次在更长的列表中倍增查找；某个列表中找到的是更大的记录时，以它为新的候选回到最短列表继续，
+ * 跳过的区间不逐个比较，代价取决于列表之间交错的程度而不是列表总长度。
+ * 批量查询时项集按规范顺序排序，相邻项集的公共前缀只求交一次。
+ */
+class SupportQuery {
+public:
+    explicit SupportQuery(const DataLoader& db);
+
+    /**
+     * 单个项集的支持计数（项的顺序任意，可以重复；空项集返回事务总数）
+     */
+    uint32_t support(const std::vector<int>& itemset) const;
+
+    /**
+     * 批量查询，结果与输入一一对应
+     * @param thread_count 线程数，小于等于1时在当前线程执行
+     */
+    std::vector<uint32_t> supportBatch(const std::vector<std::vector<int>>& itemsets, int thread_count = 0) const;
+
+    /**
+     * 多路求交计数：lists 中所有升序列表的公共元素个数
+     */
+    static size_t countIntersection(std::vector<const std::vector<int>*> lists);
+
+private:
+    /**
+     * 规范顺序：去重后按记录索引列表长度升序，长度相同按项升序
+     */
+    std::vector<int> canonical(const std::vector<int>& itemset) const;
+
+    /**
+     * 处理已按规范顺序排序的查询 order[begin, end)，相邻查询共享前缀的求交结果
+     */
+    void runSorted(const std::vector<std::vector<int>>& queries, const std::vector<size_t>& order,
+                   size_t begin, size_t end, std::vector<uint32_t>& out) const;
+
+    const DataLoader& db_;
+};
+
+#endif // SUPPORT_QUERY_HPP
@@ -0,0 +1,47 @@
+#include "file_sink.hpp"
+#include <stdexcept>
+
+using std::string;
+
+// 格式化一批项集为文本行
+static void formatText(const ItemsetPool& batch, string& out) {
+    batch.forEach([&out](const ItemsetPool::ItemsetView& view) {
+        out += "  [";
+        for (uint32_t i = 0; i < view.length; i++) {
+            if (i > 0) out += ", ";
+            out += std::to_string(view.items[i]);
+        }
+        out += "]: 支持计数=";
+        out += std::to_string(view.support);
+        out += '\n';
+    });
+}
+
+TextFileSink::TextFileSink(const string& path)
+    : path_(path), file_(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("无法打开输出文件: " + path);
+    }
+}
+
+void TextFileSink::consume(const ItemsetPool& batch) {
+    string buffer;
+    buffer.reserve(batch.size() * 32);
+    formatText(batch, buffer);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    check();
+}
+
+void TextFileSink::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush();
+    check();
+}
+
+void TextFileSink::check() const {
+    if (!file_.good()) {
+        throw std::runtime_error("写入输出文件失败: " + path_);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef FILE_SINK_HPP
+#define FILE_SINK_HPP
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include "result/sink.hpp"
+
+/**
+ * 文本文件接收端：每个项集一行，格式与 fptree_standard_results.txt 中的项集行一致
+ *   [a, b, c]: 支持计数=N
+ * 每批项集先在调用线程中格式化，再加锁一次性写入文件
+ * 二进制格式见 result/result_file.hpp
+ */
+class TextFileSink : public ItemsetSink {
+public:
+    /**
+     * @param path 输出文件路径
+     * @throws std::runtime_error 无法打开文件
+     */
+    explicit TextFileSink(const std::string& path);
+
+    /**
+     * @throws std::runtime_error 写入失败（如磁盘已满）
+     */
+    void consume(const ItemsetPool& batch) override;
+
+    /**
+     * 刷新到磁盘
+     * @throws std::runtime_error 写入失败（如磁盘已满）
+     */
+    void finish() override;
+
+private:
+    /**
+     * @throws std::runtime_error 文件流处于错误状态
+     */
+    void check() const;
+
+    std::mutex mutex_;
+    std::string path_;
+    std::ofstream file_;
+};
+
+#endif // FILE_SINK_HPP
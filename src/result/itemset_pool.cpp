@@ -0,0 +1,127 @@
+#include "itemset_pool.hpp"
+#include <algorithm>
+
+using std::vector;
+
+ItemsetPool::ItemsetPool(bool dedup)
+    : dedup_(dedup), total_(0) {
+}
+
+bool ItemsetPool::insert(const int* items, size_t length, uint32_t support) {
+    if (length == 0) {
+        return false;
+    }
+
+    // 先追加到扁平数组尾部，再在原地做插入排序得到规范形式（项集很短，插入排序最快）
+    size_t offset = items_.size();
+    items_.insert(items_.end(), items, items + length);
+    int* first = items_.data() + offset;
+    for (size_t i = 1; i < length; i++) {
+        int value = first[i];
+        size_t j = i;
+        while (j > 0 && first[j - 1] > value) {
+            first[j] = first[j - 1];
+            j--;
+        }
+        first[j] = value;
+    }
+
+    size_t level = length - 1;
+    if (level >= levels_.size()) {
+        levels_.resize(level + 1);
+        if (dedup_) {
+            index_.resize(level + 1);
+        }
+    }
+
+    if (dedup_) {
+        uint64_t hash = canonicalHash(first, length);
+        auto& level_index = index_[level];
+        // 64位哈希碰撞极少见，但碰撞的项集都要建立索引，逐个比较同一哈希下的全部记录
+        auto range = level_index.equal_range(hash);
+        for (auto found = range.first; found != range.second; ++found) {
+            const Entry& e = levels_[level][found->second];
+            if (std::equal(first, first + length, items_.data() + e.offset)) {
+                // 已存在：回退刚追加的项
+                items_.resize(offset);
+                return false;
+            }
+        }
+        level_index.emplace(hash, levels_[level].size());
+    }
+
+    levels_[level].push_back(Entry{offset, static_cast<uint32_t>(length), support});
+    total_++;
+    if (items_.capacity() != accounted_capacity_ && MemoryTracker::enabled()) {
+        account();
+    }
+    return true;
+}
+
+void ItemsetPool::merge(const ItemsetPool& other) {
+    if (!dedup_) {
+        // 不去重时直接整体拷贝，偏移量统一平移
+        size_t base = items_.size();
+        items_.insert(items_.end(), other.items_.begin(), other.items_.end());
+        if (other.levels_.size() > levels_.size()) {
+            levels_.resize(other.levels_.size());
+        }
+        for (size_t level = 0; level < other.levels_.size(); level++) {
+            auto& dst = levels_[level];
+            dst.reserve(dst.size() + other.levels_[level].size());
+            for (const auto& e : other.levels_[level]) {
+                dst.push_back(Entry{base + e.offset, e.length, e.support});
+            }
+        }
+        total_ += other.total_;
+        if (MemoryTracker::enabled()) {
+            account();
+        }
+        return;
+    }
+
+    other.forEach([this](const ItemsetView& view) {
+        insert(view.items, view.length, view.support);
+    });
+}
+
+void ItemsetPool::clear() {
+    items_.clear();
+    for (auto& level : levels_) {
+        level.clear();
+    }
+    for (auto& level_index : index_) {
+        level_index.clear();
+    }
+    total_ = 0;
+}
+
+void ItemsetPool::account() {
+    accounted_capacity_ = items_.capacity();
+    memory_.set(MemoryCategory::Results, memoryBytes());
+}
+
+size_t ItemsetPool::memoryBytes() const noexcept {
+    size_t bytes = items_.capacity() * sizeof(int);
+    for (const auto& level : levels_) {
+        bytes += level.capacity() * sizeof(Entry);
+    }
+    for (const auto& level_index : index_) {
+        // 估算：每个哈希节点约为键值对加上链表指针和桶
+        bytes += level_index.size() * (sizeof(uint64_t) + sizeof(size_t) + 2 * sizeof(void*));
+        bytes += level_index.bucket_count() * sizeof(void*);
+    }
+    return bytes;
+}
+
+uint64_t ItemsetPool::canonicalHash(const int* sorted_items, size_t length) noexcept {
+    // 基于 splitmix64 的逐项混合，长度作为种子，保证不同长度的项集互不干扰
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ static_cast<uint64_t>(length);
+    for (size_t i = 0; i < length; i++) {
+        uint64_t z = hash + static_cast<uint64_t>(static_cast<uint32_t>(sorted_items[i])) + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        hash = z ^ (z >> 31);
+    }
+    return hash;
+}
@@ -0,0 +1,133 @@
+#ifndef ITEMSET_POOL_HPP
+#define ITEMSET_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "profile/memory.hpp"
+
+/**
+ * 频繁项集结果池
+ * 所有项集按升序（规范形式）连续存放在一个只追加的扁平数组中，
+ * 每个level只保存 (offset, length, support) 记录，插入时不产生单独的堆分配。
+ * 可选的去重通过规范哈希（对排序后的项集做强哈希）实现。
+ */
+class ItemsetPool {
+public:
+    // 单个项集记录：在扁平数组中的偏移、长度和支持计数
+    struct Entry {
+        size_t offset;
+        uint32_t length;
+        uint32_t support;
+    };
+
+    // 项集的只读视图
+    struct ItemsetView {
+        const int* items;
+        uint32_t length;
+        uint32_t support;
+
+        const int* begin() const noexcept { return items; }
+        const int* end() const noexcept { return items + length; }
+        size_t size() const noexcept { return length; }
+        int operator[](size_t i) const noexcept { return items[i]; }
+    };
+
+    /**
+     * 构造函数
+     * @param dedup 是否对插入的项集去重（挖掘过程本身不产生重复时可以关闭）
+     */
+    explicit ItemsetPool(bool dedup = false);
+
+    /**
+     * 插入一个项集，项的顺序任意，内部会转换为升序的规范形式
+     * @param items 项数组
+     * @param length 项数量
+     * @param support 支持计数
+     * @return 插入成功返回true，开启去重且项集已存在时返回false
+     */
+    bool insert(const int* items, size_t length, uint32_t support);
+
+    /**
+     * 将另一个结果池的所有项集追加到当前结果池（用于合并线程局部结果）
+     */
+    void merge(const ItemsetPool& other);
+
+    /**
+     * 清空所有项集（保留已分配的内存）
+     */
+    void clear();
+
+    /**
+     * level数量，level i 存放 (i+1) 项集
+     */
+    size_t levelCount() const noexcept {
+        return levels_.size();
+    }
+
+    /**
+     * 指定level中的项集数量
+     */
+    size_t levelSize(size_t level) const noexcept {
+        return level < levels_.size() ? levels_[level].size() : 0;
+    }
+
+    /**
+     * 所有项集总数
+     */
+    size_t size() const noexcept {
+        return total_;
+    }
+
+    bool empty() const noexcept {
+        return total_ == 0;
+    }
+
+    /**
+     * 获取指定level中第index个项集
+     */
+    ItemsetView get(size_t level, size_t index) const {
+        const Entry& e = levels_[level][index];
+        return ItemsetView{items_.data() + e.offset, e.length, e.support};
+    }
+
+    /**
+     * 按level顺序遍历所有项集
+     * @param fn 回调函数，参数为 ItemsetView
+     */
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (const auto& level : levels_) {
+            for (const auto& e : level) {
+                fn(ItemsetView{items_.data() + e.offset, e.length, e.support});
+            }
+        }
+    }
+
+    /**
+     * 结果池当前占用的字节数（扁平数组 + 记录 + 去重索引）
+     */
+    size_t memoryBytes() const noexcept;
+
+    /**
+     * 计算升序项集的规范哈希（64位，顺序敏感，仅对规范形式使用）
+     */
+    static uint64_t canonicalHash(const int* sorted_items, size_t length) noexcept;
+
+private:
+    /**
+     * 按当前容量重新登记结果池的内存（扁平数组扩容时调用）
+     */
+    void account();
+
+    bool dedup_;
+    size_t total_;
+    std::vector<int> items_;                                     // 扁平项数组
+    std::vector<std::vector<Entry>> levels_;                     // 每个level的项集记录
+    std::vector<std::unordered_multimap<uint64_t, size_t>> index_;    // 每个level：规范哈希 -> 记录下标，哈希碰撞时一对多（仅去重时使用）
+    size_t accounted_capacity_ = 0;                              // 上次登记时扁平数组的容量
+    MemoryCharge memory_;
+};
+
+#endif // ITEMSET_POOL_HPP
@@ -0,0 +1,438 @@
+#include "result_file.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <tuple>
+
+using std::string;
+using std::vector;
+
+// 定长字段按小端序读写（目标平台均为小端，直接按内存布局拷贝）
+template <typename T>
+static void putField(string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+static T getField(const char* data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+namespace {
+
+// 编码一个项集：第一个项与上一个项集第一个项的差值、后续项的差值、支持计数（段和有序段临时文件共用）
+void encodeItemset(string& out, const int* itemset, size_t length, uint32_t support, int& prev_first) {
+    appendVarint(out, static_cast<uint32_t>(itemset[0] - prev_first));
+    prev_first = itemset[0];
+    for (size_t k = 1; k < length; k++) {
+        appendVarint(out, static_cast<uint32_t>(itemset[k] - itemset[k - 1]));
+    }
+    appendVarint(out, support);
+}
+
+/**
+ * 同一level中按字典序排好的一串项集，归并时逐个读取
+ */
+class SortedRun {
+public:
+    explicit SortedRun(size_t length) : length_(length), items_(length) {}
+    virtual ~SortedRun() = default;
+
+    /**
+     * 读取下一个项集，没有更多项集时返回 false
+     */
+    virtual bool next() = 0;
+
+    const int* items() const noexcept {
+        return items_.data();
+    }
+
+    uint32_t support() const noexcept {
+        return support_;
+    }
+
+protected:
+    size_t length_;
+    vector<int> items_;
+    uint32_t support_ = 0;
+};
+
+// 有序段临时文件：按块读入，逐个解码
+class FileRun : public SortedRun {
+public:
+    FileRun(const string& path, size_t length)
+        : SortedRun(length), path_(path), in_(path, std::ios::in | std::ios::binary),
+          buffer_(kBlockBytes + (length + 1) * kMaxVarintBytes, '\0') {
+        if (!in_.is_open()) {
+            throw std::runtime_error("无法打开临时文件: " + path);
+        }
+    }
+
+    bool next() override {
+        refill();
+        if (begin_ == end_) {
+            return false;
+        }
+        const unsigned char* data = reinterpret_cast<const unsigned char*>(buffer_.data());
+        const unsigned char* cursor = data + begin_;
+        const unsigned char* end = data + end_;
+        prev_first_ += static_cast<int>(readVarint(cursor, end));
+        items_[0] = prev_first_;
+        for (size_t k = 1; k < length_; k++) {
+            items_[k] = items_[k - 1] + static_cast<int>(readVarint(cursor, end));
+        }
+        support_ = static_cast<uint32_t>(readVarint(cursor, end));
+        begin_ = static_cast<size_t>(cursor - data);
+        return true;
+    }
+
+private:
+    static constexpr size_t kBlockBytes = 1 << 16;
+    static constexpr size_t kMaxVarintBytes = 10;
+
+    // 剩余的字节不够一个最长的项集时，把它们挪到开头再读入一块
+    void refill() {
+        if (eof_ || end_ - begin_ >= (length_ + 1) * kMaxVarintBytes) {
+            return;
+        }
+        std::memmove(&buffer_[0], buffer_.data() + begin_, end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+        in_.read(&buffer_[end_], static_cast<std::streamsize>(buffer_.size() - end_));
+        end_ += static_cast<size_t>(in_.gcount());
+        if (in_.bad()) {
+            throw std::runtime_error("读取临时文件失败: " + path_);
+        }
+        eof_ = in_.eof();
+    }
+
+    string path_;
+    std::ifstream in_;
+    string buffer_;
+    size_t begin_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+    int prev_first_ = 0;
+};
+
+// 内存中还没写出的最后一批项集：排序后直接参与归并
+class MemoryRun : public SortedRun {
+public:
+    MemoryRun(const vector<int>& items, const vector<uint32_t>& supports, size_t length)
+        : SortedRun(length), items_in_(items), supports_(supports), order_(sortedOrder(items, supports.size(), length)) {}
+
+    bool next() override {
+        if (position_ == order_.size()) {
+            return false;
+        }
+        size_t index = order_[position_++];
+        std::copy(items_in_.begin() + index * length_, items_in_.begin() + (index + 1) * length_, items_.begin());
+        support_ = supports_[index];
+        return true;
+    }
+
+    /**
+     * 扁平存放的 count 个长度为 length 的项集按字典序排列后的下标
+     */
+    static vector<size_t> sortedOrder(const vector<int>& items, size_t count, size_t length) {
+        vector<size_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&items, length](size_t a, size_t b) {
+            const int* pa = items.data() + a * length;
+            const int* pb = items.data() + b * length;
+            return std::lexicographical_compare(pa, pa + length, pb, pb + length);
+        });
+        return order;
+    }
+
+private:
+    const vector<int>& items_in_;
+    const vector<uint32_t>& supports_;
+    vector<size_t> order_;
+    size_t position_ = 0;
+};
+
+} // namespace
+
+BinaryFileSink::BinaryFileSink(const string& path, uint64_t transaction_count,
+                               uint64_t min_support_count, double min_support)
+    : path_(path), transaction_count_(transaction_count), min_support_count_(min_support_count),
+      min_support_(min_support), finished_(false), buffered_bytes_(0),
+      file_(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("无法打开输出文件: " + path);
+    }
+}
+
+BinaryFileSink::~BinaryFileSink() {
+    // 没有正常结束（例如挖掘中途抛出异常）时清理有序段临时文件
+    removeRuns();
+}
+
+string BinaryFileSink::runPath(size_t level, size_t run) const {
+    return path_ + ".level" + std::to_string(level) + ".run" + std::to_string(run) + ".tmp";
+}
+
+void BinaryFileSink::removeRuns() {
+    for (size_t level = 0; level < run_counts_.size(); level++) {
+        for (size_t run = 0; run < run_counts_[level]; run++) {
+            std::remove(runPath(level, run).c_str());
+        }
+        run_counts_[level] = 0;
+    }
+}
+
+void BinaryFileSink::writeRun(size_t level, size_t run, const LevelBuffer& buffer) const {
+    size_t length = level + 1;
+    string path = runPath(level, run);
+    std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        throw std::runtime_error("无法打开临时文件: " + path);
+    }
+    string chunk;
+    int prev_first = 0;
+    for (size_t index : MemoryRun::sortedOrder(buffer.items, buffer.supports.size(), length)) {
+        encodeItemset(chunk, buffer.items.data() + index * length, length, buffer.supports[index], prev_first);
+        if (chunk.size() >= kWriteChunkBytes) {
+            out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            chunk.clear();
+        }
+    }
+    out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    out.close();
+    if (out.fail()) {
+        throw std::runtime_error("写入临时文件失败: " + path);
+    }
+}
+
+void BinaryFileSink::consume(const ItemsetPool& batch) {
+    // 缓冲超过上限时把各level的缓冲连同分配好的段编号取出，排序和写盘不持锁
+    vector<std::tuple<size_t, size_t, LevelBuffer>> runs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (batch.levelCount() > buffers_.size()) {
+            buffers_.resize(batch.levelCount());
+            run_counts_.resize(batch.levelCount(), 0);
+            spill_counts_.resize(batch.levelCount(), 0);
+        }
+        for (size_t level = 0; level < batch.levelCount(); level++) {
+            LevelBuffer& buffer = buffers_[level];
+            for (size_t i = 0; i < batch.levelSize(level); i++) {
+                auto view = batch.get(level, i);
+                buffer.items.insert(buffer.items.end(), view.items, view.items + view.length);
+                buffer.supports.push_back(view.support);
+            }
+            spill_counts_[level] += batch.levelSize(level);
+            buffered_bytes_ += batch.levelSize(level) * ((level + 1) * sizeof(int) + sizeof(uint32_t));
+        }
+        if (buffered_bytes_ >= kRunBytes) {
+            for (size_t level = 0; level < buffers_.size(); level++) {
+                if (!buffers_[level].supports.empty()) {
+                    runs.emplace_back(level, run_counts_[level]++, std::move(buffers_[level]));
+                    buffers_[level] = LevelBuffer();
+                }
+            }
+            buffered_bytes_ = 0;
+        }
+    }
+    for (const auto& run : runs) {
+        writeRun(std::get<0>(run), std::get<1>(run), std::get<2>(run));
+    }
+}
+
+void BinaryFileSink::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    // 末尾没有项集的level不写入
+    size_t level_count = spill_counts_.size();
+    while (level_count > 0 && spill_counts_[level_count - 1] == 0) {
+        level_count--;
+    }
+
+    // 先跳过文件头和段表，段写完后再回填
+    uint64_t offset = result_file::kHeaderBytes + level_count * result_file::kSectionEntryBytes;
+    file_.write(string(offset, '\0').data(), static_cast<std::streamsize>(offset));
+
+    string table;
+    uint64_t total = 0;
+    string chunk;
+    for (size_t level = 0; level < level_count; level++) {
+        size_t length = level + 1;
+
+        // 该level的各有序段（磁盘上的和内存中剩下的一批）做多路归并，边归并边编码写出
+        vector<std::unique_ptr<SortedRun>> runs;
+        for (size_t run = 0; run < run_counts_[level]; run++) {
+            runs.push_back(std::make_unique<FileRun>(runPath(level, run), length));
+        }
+        if (!buffers_[level].supports.empty()) {
+            runs.push_back(std::make_unique<MemoryRun>(buffers_[level].items, buffers_[level].supports, length));
+        }
+        auto after = [&runs, length](size_t a, size_t b) {
+            const int* pa = runs[a]->items();
+            const int* pb = runs[b]->items();
+            return std::lexicographical_compare(pb, pb + length, pa, pa + length);
+        };
+        std::priority_queue<size_t, vector<size_t>, decltype(after)> heap(after);
+        for (size_t r = 0; r < runs.size(); r++) {
+            if (runs[r]->next()) {
+                heap.push(r);
+            }
+        }
+
+        uint64_t count = 0;
+        uint64_t section_bytes = 0;
+        int prev_first = 0;
+        chunk.clear();
+        while (!heap.empty()) {
+            size_t r = heap.top();
+            heap.pop();
+            encodeItemset(chunk, runs[r]->items(), length, runs[r]->support(), prev_first);
+            count++;
+            if (chunk.size() >= kWriteChunkBytes) {
+                file_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                section_bytes += chunk.size();
+                chunk.clear();
+            }
+            if (runs[r]->next()) {
+                heap.push(r);
+            }
+        }
+        file_.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        section_bytes += chunk.size();
+        if (!file_.good()) {
+            throw std::runtime_error("写入输出文件失败: " + path_);
+        }
+
+        runs.clear();
+        for (size_t run = 0; run < run_counts_[level]; run++) {
+            std::remove(runPath(level, run).c_str());
+        }
+        run_counts_[level] = 0;
+        buffers_[level] = LevelBuffer();
+
+        putField<uint64_t>(table, offset);
+        putField<uint64_t>(table, section_bytes);
+        putField<uint64_t>(table, count);
+        offset += section_bytes;
+        total += count;
+    }
+
+    string header(result_file::kMagic, sizeof(result_file::kMagic));
+    putField<uint32_t>(header, result_file::kVersion);
+    putField<uint64_t>(header, transaction_count_);
+    putField<uint64_t>(header, min_support_count_);
+    putField<double>(header, min_support_);
+    putField<uint64_t>(header, total);
+    putField<uint32_t>(header, static_cast<uint32_t>(level_count));
+    putField<uint32_t>(header, 0);
+
+    file_.seekp(0);
+    file_.write(header.data(), static_cast<std::streamsize>(header.size()));
+    file_.write(table.data(), static_cast<std::streamsize>(table.size()));
+    file_.close();
+    if (file_.fail()) {
+        throw std::runtime_error("写入输出文件失败: " + path_);
+    }
+    buffers_.clear();
+}
+
+ResultFile::ResultFile(const string& path)
+    : transaction_count_(0), min_support_count_(0), min_support_(0.0), total_(0) {
+    std::error_code error;
+    map_.map(path, error);
+    if (error) {
+        throw std::runtime_error("无法打开结果文件: " + path);
+    }
+
+    const char* data = map_.data();
+    size_t size = map_.size();
+    if (size < result_file::kHeaderBytes || std::memcmp(data, result_file::kMagic, sizeof(result_file::kMagic)) != 0) {
+        throw std::runtime_error("不是二进制结果文件: " + path);
+    }
+    uint32_t version = getField<uint32_t>(data, 4);
+    if (version != result_file::kVersion) {
+        throw std::runtime_error("不支持的结果文件版本: " + std::to_string(version));
+    }
+
+    transaction_count_ = getField<uint64_t>(data, 8);
+    min_support_count_ = getField<uint64_t>(data, 16);
+    min_support_ = getField<double>(data, 24);
+    total_ = getField<uint64_t>(data, 32);
+    uint32_t level_count = getField<uint32_t>(data, 40);
+
+    if (size < result_file::kHeaderBytes + uint64_t(level_count) * result_file::kSectionEntryBytes) {
+        throw std::runtime_error("结果文件段表被截断: " + path);
+    }
+    sections_.resize(level_count);
+    for (uint32_t level = 0; level < level_count; level++) {
+        size_t entry = result_file::kHeaderBytes + level * result_file::kSectionEntryBytes;
+        Section& section = sections_[level];
+        section.offset = getField<uint64_t>(data, entry);
+        section.bytes = getField<uint64_t>(data, entry + 8);
+        section.count = getField<uint64_t>(data, entry + 16);
+        if (section.offset > size || section.bytes > size - section.offset) {
+            throw std::runtime_error("结果文件数据段越界: " + path);
+        }
+    }
+}
+
+void ResultFile::load(ItemsetPool& out) const {
+    forEach([&out](const ItemsetPool::ItemsetView& view) {
+        out.insert(view.items, view.length, view.support);
+    });
+}
+
+bool isResultFile(const string& path) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    char magic[sizeof(result_file::kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    return in.gcount() == sizeof(magic) && std::memcmp(magic, result_file::kMagic, sizeof(magic)) == 0;
+}
+
+void writeTextReport(const ResultFile& in, std::ostream& out) {
+    const string rule(50, '=');
+    out << "\n" << rule << "\n";
+    out << "========== FP-Tree 算法完整结果 ==========\n\n";
+
+    size_t max_level = 0;
+    for (size_t level = 0; level < in.levelCount(); level++) {
+        if (in.levelSize(level) == 0) {
+            continue;
+        }
+        max_level = level;
+        out << "Level " << level << " (频繁" << level + 1 << "项集):\n";
+        out << "总计: " << in.levelSize(level) << " 个频繁" << level + 1 << "项集\n";
+
+        string buffer;
+        in.forEachInLevel(level, [&buffer](const ItemsetPool::ItemsetView& view) {
+            buffer += "  [";
+            for (uint32_t i = 0; i < view.length; i++) {
+                if (i > 0) buffer += ", ";
+                buffer += std::to_string(view.items[i]);
+            }
+            buffer += "]: 支持计数=";
+            buffer += std::to_string(view.support);
+            buffer += '\n';
+        });
+        out << buffer << "\n";
+    }
+
+    out << rule << "\n";
+    out << "所有级别总计: " << in.size() << " 个频繁项集\n";
+    out << "最大级别: " << max_level << "\n";
+    out << "最小支持度阈值: " << in.minSupport() << "\n";
+    out << rule;
+}
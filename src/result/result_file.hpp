@@ -0,0 +1,205 @@
+#ifndef RESULT_FILE_HPP
+#define RESULT_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "external/mio.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+#include "result/varint.hpp"
+
+/**
+ * 二进制结果文件格式（可直接内存映射读取，所有整数为小端序）
+ *
+ *   文件头（48字节）：
+ *     char[4]  魔数 "DMRF"
+ *     uint32   版本号
+ *     uint64   事务总数
+ *     uint64   最小支持计数
+ *     double   最小支持度（用户输入值）
+ *     uint64   项集总数
+ *     uint32   level数量
+ *     uint32   保留
+ *   段表：每个level一项（24字节）：uint64 段偏移, uint64 段字节数, uint64 项集数
+ *   段数据：level i 中的 (i+1) 项集按字典序排列，每个项集依次编码为
+ *     varint 第一个项与上一个项集第一个项的差值
+ *     varint 后续每个项与前一项的差值
+ *     varint 支持计数
+ */
+namespace result_file {
+    constexpr char kMagic[4] = {'D', 'M', 'R', 'F'};
+    constexpr uint32_t kVersion = 1;
+    constexpr size_t kHeaderBytes = 48;
+    constexpr size_t kSectionEntryBytes = 24;
+}
+
+/**
+ * 二进制结果文件接收端（外排序）
+ * 挖掘过程中各level的项集先缓冲在内存中，缓冲超过 kRunBytes 时每个level排序后写成一个有序段临时文件；
+ * finish 时逐个level把各有序段与内存中剩下的一批做多路归并，边归并边编码写出正式的段。
+ * 内存占用只有一批缓冲和每个有序段的读缓冲，与项集总数无关
+ */
+class BinaryFileSink : public ItemsetSink {
+public:
+    /**
+     * @param path 输出文件路径
+     * @param transaction_count 事务总数（写入文件头）
+     * @param min_support_count 最小支持计数（写入文件头）
+     * @param min_support 用户输入的最小支持度（写入文件头）
+     * @throws std::runtime_error 无法打开文件
+     */
+    BinaryFileSink(const std::string& path, uint64_t transaction_count = 0,
+                   uint64_t min_support_count = 0, double min_support = 0.0);
+    ~BinaryFileSink();
+
+    /**
+     * @throws std::runtime_error 无法打开或写入临时文件
+     */
+    void consume(const ItemsetPool& batch) override;
+
+    /**
+     * 归并、写出各段并关闭文件
+     * @throws std::runtime_error 写入临时文件或输出文件失败（如磁盘已满）
+     */
+    void finish() override;
+
+private:
+    // 单个level尚未写出的项集：扁平存放的项（每个 level + 1 个）和支持计数
+    struct LevelBuffer {
+        std::vector<int> items;
+        std::vector<uint32_t> supports;
+    };
+
+    // 各level缓冲的项集合计超过这么多字节时排序写出为有序段
+    static constexpr size_t kRunBytes = 64 << 20;
+    // 编码结果攒够这么多字节写一次文件
+    static constexpr size_t kWriteChunkBytes = 1 << 20;
+
+    std::string runPath(size_t level, size_t run) const;
+
+    /**
+     * 排序一批项集并写成有序段临时文件
+     * @throws std::runtime_error 无法打开或写入临时文件
+     */
+    void writeRun(size_t level, size_t run, const LevelBuffer& buffer) const;
+
+    /**
+     * 删除还没有删除的有序段临时文件
+     */
+    void removeRuns();
+
+    std::mutex mutex_;
+    std::string path_;
+    uint64_t transaction_count_;
+    uint64_t min_support_count_;
+    double min_support_;
+    bool finished_;
+    size_t buffered_bytes_;                 // 各level缓冲的项集字节数合计
+    std::ofstream file_;
+    std::vector<LevelBuffer> buffers_;      // 每个level内存中的缓冲
+    std::vector<size_t> run_counts_;        // 每个level已写出的有序段数
+    std::vector<uint64_t> spill_counts_;    // 每个level的项集数
+};
+
+/**
+ * 二进制结果文件读取器（内存映射，按需解码）
+ */
+class ResultFile {
+public:
+    /**
+     * 打开并校验结果文件
+     * @throws std::runtime_error 文件无法打开或格式错误
+     */
+    explicit ResultFile(const std::string& path);
+
+    uint64_t transactionCount() const noexcept { return transaction_count_; }
+    uint64_t minSupportCount() const noexcept { return min_support_count_; }
+    double minSupport() const noexcept { return min_support_; }
+    uint64_t size() const noexcept { return total_; }
+
+    size_t levelCount() const noexcept {
+        return sections_.size();
+    }
+
+    size_t levelSize(size_t level) const noexcept {
+        return level < sections_.size() ? sections_[level].count : 0;
+    }
+
+    /**
+     * 按字典序遍历指定level的项集
+     * @param fn 回调函数，参数为 ItemsetPool::ItemsetView
+     */
+    template <typename F>
+    void forEachInLevel(size_t level, F&& fn) const;
+
+    /**
+     * 按level顺序遍历所有项集
+     */
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (size_t level = 0; level < sections_.size(); level++) {
+            forEachInLevel(level, fn);
+        }
+    }
+
+    /**
+     * 把所有项集读入结果池
+     */
+    void load(ItemsetPool& out) const;
+
+private:
+    struct Section {
+        uint64_t offset;
+        uint64_t bytes;
+        uint64_t count;
+    };
+
+    mio::mmap_source map_;
+    uint64_t transaction_count_;
+    uint64_t min_support_count_;
+    double min_support_;
+    uint64_t total_;
+    std::vector<Section> sections_;
+};
+
+/**
+ * 判断文件是否为二进制结果文件（检查魔数）
+ */
+bool isResultFile(const std::string& path);
+
+/**
+ * 把二进制结果文件转换为 fptree_standard_results.txt 的文本布局
+ */
+void writeTextReport(const ResultFile& in, std::ostream& out);
+
+template <typename F>
+void ResultFile::forEachInLevel(size_t level, F&& fn) const {
+    if (level >= sections_.size()) {
+        return;
+    }
+    const Section& section = sections_[level];
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(map_.data()) + section.offset;
+    const unsigned char* end = cursor + section.bytes;
+
+    uint32_t length = static_cast<uint32_t>(level + 1);
+    std::vector<int> items(length);
+    int prev_first = 0;
+    for (uint64_t i = 0; i < section.count; i++) {
+        int item = prev_first + static_cast<int>(readVarint(cursor, end));
+        prev_first = item;
+        items[0] = item;
+        for (uint32_t k = 1; k < length; k++) {
+            item += static_cast<int>(readVarint(cursor, end));
+            items[k] = item;
+        }
+        uint32_t support = static_cast<uint32_t>(readVarint(cursor, end));
+        fn(ItemsetPool::ItemsetView{items.data(), length, support});
+    }
+}
+
+#endif // RESULT_FILE_HPP
@@ -0,0 +1,185 @@
+#ifndef SINK_HPP
+#define SINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "result/itemset_pool.hpp"
+
+/**
+ * 结果接收端：引擎把挖掘到的项集（附带支持计数）成批推送给它
+ * consume 可能被多个挖掘线程并发调用，实现需自行保证线程安全
+ */
+class ItemsetSink {
+public:
+    virtual ~ItemsetSink() = default;
+
+    /**
+     * 接收一批项集
+     */
+    virtual void consume(const ItemsetPool& batch) = 0;
+
+    /**
+     * 挖掘结束，所有批次均已推送
+     */
+    virtual void finish() {}
+};
+
+/**
+ * 把所有项集收集到内存中的接收端
+ */
+class CollectSink : public ItemsetSink {
+public:
+    void consume(const ItemsetPool& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        itemsets_.merge(batch);
+    }
+
+    const ItemsetPool& itemsets() const noexcept {
+        return itemsets_;
+    }
+
+private:
+    std::mutex mutex_;
+    ItemsetPool itemsets_;
+};
+
+/**
+ * 只统计数量的接收端：按level计数，不保存项集
+ */
+class CountingSink : public ItemsetSink {
+public:
+    void consume(const ItemsetPool& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (batch.levelCount() > levels_.size()) {
+            levels_.resize(batch.levelCount(), 0);
+        }
+        for (size_t level = 0; level < batch.levelCount(); level++) {
+            levels_[level] += batch.levelSize(level);
+        }
+        total_ += batch.size();
+    }
+
+    size_t levelCount() const noexcept {
+        return levels_.size();
+    }
+
+    size_t levelSize(size_t level) const noexcept {
+        return level < levels_.size() ? levels_[level] : 0;
+    }
+
+    size_t size() const noexcept {
+        return total_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<size_t> levels_;
+    size_t total_ = 0;
+};
+
+/**
+ * 分流接收端：每批项集依次推送给两个接收端（second 可以为空）
+ */
+class TeeSink : public ItemsetSink {
+public:
+    TeeSink(ItemsetSink& first, ItemsetSink* second) : first_(first), second_(second) {}
+
+    void consume(const ItemsetPool& batch) override {
+        first_.consume(batch);
+        if (second_) second_->consume(batch);
+    }
+
+    void finish() override {
+        first_.finish();
+        if (second_) second_->finish();
+    }
+
+private:
+    ItemsetSink& first_;
+    ItemsetSink* second_;
+};
+
+/**
+ * 回调接收端：逐个项集调用回调函数（回调串行执行）
+ */
+class CallbackSink : public ItemsetSink {
+public:
+    using Callback = std::function<void(const ItemsetPool::ItemsetView&)>;
+
+    explicit CallbackSink(Callback callback) : callback_(std::move(callback)) {}
+
+    void consume(const ItemsetPool& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.forEach(callback_);
+    }
+
+private:
+    std::mutex mutex_;
+    Callback callback_;
+};
+
+/**
+ * 挖掘线程的本地缓冲：项集先写入线程本地的结果池，攒够一批再一次性推送给接收端
+ * 写完后须调用 flush() 推送剩余的项集，接收端的错误（如写文件失败）从 flush() 抛出
+ */
+class SinkWriter {
+public:
+    // 默认每攒够这么多个项集推送一次
+    static constexpr size_t kDefaultFlushItemsets = 1 << 16;
+
+    explicit SinkWriter(ItemsetSink& sink, size_t flush_itemsets = kDefaultFlushItemsets)
+        : sink_(&sink), flush_itemsets_(flush_itemsets) {}
+
+    SinkWriter(SinkWriter&&) = default;
+    SinkWriter& operator=(SinkWriter&&) = default;
+
+    /**
+     * 正常结束时应当先显式调用 flush()：析构时的推送只是兜底（例如挖掘中途抛出异常），
+     * 此时接收端的错误被忽略，不能从析构函数中抛出
+     */
+    ~SinkWriter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    /**
+     * 写入一个项集（项的顺序任意）
+     */
+    void emit(const int* items, size_t length, uint32_t support) {
+        buffer_.insert(items, length, support);
+        emitted_++;
+        if (buffer_.size() >= flush_itemsets_) {
+            flush();
+        }
+    }
+
+    /**
+     * 已写入的项集总数
+     */
+    size_t emittedCount() const noexcept {
+        return emitted_;
+    }
+
+    /**
+     * 把缓冲中的项集推送给接收端
+     */
+    void flush() {
+        if (sink_ != nullptr && !buffer_.empty()) {
+            sink_->consume(buffer_);
+            buffer_.clear();
+        }
+    }
+
+private:
+    ItemsetSink* sink_;
+    size_t flush_itemsets_;
+    size_t emitted_ = 0;
+    ItemsetPool buffer_;
+};
+
+#endif // SINK_HPP
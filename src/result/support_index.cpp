@@ -0,0 +1,52 @@
+#include "support_index.hpp"
+#include <algorithm>
+
+SupportIndex::SupportIndex(const ItemsetPool& itemsets)
+    : itemsets_(itemsets), tables_(itemsets.levelCount()) {
+    for (size_t level = 0; level < itemsets.levelCount(); level++) {
+        size_t count = itemsets.levelSize(level);
+        if (count == 0) {
+            continue;
+        }
+        // 装载因子不超过0.5
+        size_t capacity = 1;
+        while (capacity < count * 2) {
+            capacity <<= 1;
+        }
+        auto& table = tables_[level];
+        table.assign(capacity, Slot{0, kEmpty});
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < count; i++) {
+            auto view = itemsets.get(level, i);
+            uint64_t hash = ItemsetPool::canonicalHash(view.items, view.length);
+            size_t slot = static_cast<size_t>(hash) & mask;
+            while (table[slot].index != kEmpty) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = Slot{hash, static_cast<uint32_t>(i)};
+        }
+    }
+}
+
+uint32_t SupportIndex::support(const int* sorted_items, size_t length) const noexcept {
+    if (length == 0 || length > tables_.size()) {
+        return 0;
+    }
+    size_t level = length - 1;
+    const auto& table = tables_[level];
+    if (table.empty()) {
+        return 0;
+    }
+    uint64_t hash = ItemsetPool::canonicalHash(sorted_items, length);
+    size_t mask = table.size() - 1;
+    for (size_t slot = static_cast<size_t>(hash) & mask; table[slot].index != kEmpty; slot = (slot + 1) & mask) {
+        if (table[slot].hash != hash) {
+            continue;
+        }
+        auto view = itemsets_.get(level, table[slot].index);
+        if (std::equal(sorted_items, sorted_items + length, view.items)) {
+            return view.support;
+        }
+    }
+    return 0;
+}
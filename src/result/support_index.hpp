@@ -0,0 +1,41 @@
+#ifndef SUPPORT_INDEX_HPP
+#define SUPPORT_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "result/itemset_pool.hpp"
+
+/**
+ * 项集支持计数的O(1)查找表
+ * 每个level一张开放寻址哈希表（线性探测），槽中只存规范哈希和记录下标，
+ * 命中后再比较项集本身，不会因哈希冲突返回错误的支持计数。
+ * 只引用结果池，不复制项集，结果池必须比索引活得久且不再修改。
+ */
+class SupportIndex {
+public:
+    explicit SupportIndex(const ItemsetPool& itemsets);
+
+    /**
+     * 查询升序项集的支持计数
+     * @return 支持计数，项集不在结果池中时返回0
+     */
+    uint32_t support(const int* sorted_items, size_t length) const noexcept;
+
+    const ItemsetPool& itemsets() const noexcept {
+        return itemsets_;
+    }
+
+private:
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+
+    struct Slot {
+        uint64_t hash;
+        uint32_t index;
+    };
+
+    const ItemsetPool& itemsets_;
+    std::vector<std::vector<Slot>> tables_;   // 每个level的哈希表，容量为2的幂
+};
+
+#endif // SUPPORT_INDEX_HPP
@@ -0,0 +1,41 @@
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+/**
+ * LEB128 变长整数编码：每字节7位有效数据，最高位表示后面还有字节
+ */
+inline void appendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * 解码一个变长整数并前移读指针
+ * @throws std::runtime_error 数据被截断
+ */
+inline uint64_t readVarint(const unsigned char*& cursor, const unsigned char* end) {
+    uint64_t value = 0;
+    int shift = 0;
+    while (cursor < end) {
+        unsigned char byte = *cursor++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+        shift += 7;
+        if (shift > 63) {
+            break;
+        }
+    }
+    throw std::runtime_error("变长整数数据损坏或被截断");
+}
+
+#endif // VARINT_HPP
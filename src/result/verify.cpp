@@ -0,0 +1,295 @@
+#include "verify.hpp"
+#include "result_file.hpp"
+#include "sched/parallel_for.hpp"
+#include "external/mio.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+using std::pair;
+using std::string;
+using std::vector;
+
+// 解析一段文本中的项集行 "[a, b, c]: 支持计数=N"，其他行（标题、level、总计）跳过
+static void parseTextChunk(const char* cursor, const char* end, ItemsetPool& out) {
+    vector<int> items;
+    while (cursor < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        if (line_end == nullptr) {
+            line_end = end;
+        }
+
+        const char* p = cursor;
+        while (p < line_end && (*p == ' ' || *p == '\t')) p++;
+        if (p < line_end && *p == '[') {
+            p++;
+            items.clear();
+            bool valid = true;
+            while (p < line_end && *p != ']') {
+                if (*p == ',' || *p == ' ') {
+                    p++;
+                    continue;
+                }
+                bool negative = *p == '-';
+                if (negative) p++;
+                if (p >= line_end || *p < '0' || *p > '9') {
+                    valid = false;
+                    break;
+                }
+                int value = 0;
+                while (p < line_end && *p >= '0' && *p <= '9') {
+                    value = value * 10 + (*p - '0');
+                    p++;
+                }
+                items.push_back(negative ? -value : value);
+            }
+
+            // 支持计数在 ']' 之后的 '=' 后面
+            const char* eq = p < line_end ? static_cast<const char*>(std::memchr(p, '=', line_end - p)) : nullptr;
+            if (valid && eq != nullptr && !items.empty()) {
+                uint32_t support = 0;
+                for (const char* q = eq + 1; q < line_end && *q >= '0' && *q <= '9'; q++) {
+                    support = support * 10 + static_cast<uint32_t>(*q - '0');
+                }
+                out.insert(items.data(), items.size(), support);
+            }
+        }
+        cursor = line_end + 1;
+    }
+}
+
+void loadResultFile(const string& path, ItemsetPool& out, int thread_count) {
+    if (isResultFile(path)) {
+        ResultFile(path).load(out);
+        return;
+    }
+
+    mio::mmap_source map;
+    std::error_code error;
+    map.map(path, error);
+    if (error) {
+        throw std::runtime_error("无法打开结果文件: " + path);
+    }
+    const char* data = map.data();
+    size_t size = map.size();
+
+    // 按行边界切块，每块解析到独立的结果池，最后按块的顺序合并
+    size_t threads = resolveThreadCount(thread_count);
+    size_t chunks = std::max<size_t>(1, std::min(threads, size / (1 << 16)));
+    vector<pair<size_t, size_t>> ranges;
+    size_t begin = 0;
+    for (size_t c = 1; c <= chunks && begin < size; c++) {
+        size_t end = c == chunks ? size : size * c / chunks;
+        while (end < size && data[end - 1] != '\n') end++;
+        if (end > begin) {
+            ranges.emplace_back(begin, end);
+        }
+        begin = end;
+    }
+
+    vector<ItemsetPool> parts(ranges.size());
+    parallelFor(ranges.size(), threads, 1, [&](size_t first, size_t last) {
+        for (size_t r = first; r < last; r++) {
+            parseTextChunk(data + ranges[r].first, data + ranges[r].second, parts[r]);
+        }
+    });
+    for (const auto& part : parts) {
+        out.merge(part);
+    }
+}
+
+namespace {
+
+// 单个level的规范哈希索引：按哈希排序的 (哈希, 记录下标)，查找时比较项集排除哈希冲突
+class LevelIndex {
+public:
+    void build(const ItemsetPool& pool, size_t level) {
+        pool_ = &pool;
+        level_ = level;
+        keys_.resize(pool.levelSize(level));
+        for (size_t i = 0; i < keys_.size(); i++) {
+            auto view = pool.get(level, i);
+            keys_[i] = {ItemsetPool::canonicalHash(view.items, view.length), static_cast<uint32_t>(i)};
+        }
+        std::sort(keys_.begin(), keys_.end());
+
+        // 同一哈希下与前面某条记录项集相同的记录是重复项（查找只会返回最前面的一条）
+        duplicates_.clear();
+        for (size_t group = 0; group < keys_.size();) {
+            size_t group_end = group + 1;
+            while (group_end < keys_.size() && keys_[group_end].first == keys_[group].first) group_end++;
+            for (size_t i = group + 1; i < group_end; i++) {
+                auto view = pool.get(level, keys_[i].second);
+                for (size_t j = group; j < i; j++) {
+                    auto earlier = pool.get(level, keys_[j].second);
+                    if (std::equal(view.begin(), view.end(), earlier.begin(), earlier.end())) {
+                        duplicates_.push_back(keys_[i].second);
+                        break;
+                    }
+                }
+            }
+            group = group_end;
+        }
+    }
+
+    // 重复出现的记录下标（第一次出现的不算）
+    const vector<uint32_t>& duplicates() const noexcept {
+        return duplicates_;
+    }
+
+    // 返回匹配项集的记录下标，不存在时返回 -1
+    long long find(const ItemsetPool::ItemsetView& view) const {
+        uint64_t hash = ItemsetPool::canonicalHash(view.items, view.length);
+        auto it = std::lower_bound(keys_.begin(), keys_.end(), pair<uint64_t, uint32_t>{hash, 0});
+        for (; it != keys_.end() && it->first == hash; ++it) {
+            auto candidate = pool_->get(level_, it->second);
+            if (std::equal(view.begin(), view.end(), candidate.begin(), candidate.end())) {
+                return it->second;
+            }
+        }
+        return -1;
+    }
+
+private:
+    const ItemsetPool* pool_ = nullptr;
+    size_t level_ = 0;
+    vector<pair<uint64_t, uint32_t>> keys_;
+    vector<uint32_t> duplicates_;
+};
+
+} // namespace
+
+VerifyReport verifyResults(const ItemsetPool& expected, const ItemsetPool& actual, int thread_count) {
+    size_t threads = resolveThreadCount(thread_count);
+    size_t level_count = std::max(expected.levelCount(), actual.levelCount());
+
+    VerifyReport report;
+    report.levels.resize(level_count);
+
+    // 两边每个level各建一个索引，互不依赖，一起并行构建
+    vector<LevelIndex> expected_index(level_count);
+    vector<LevelIndex> actual_index(level_count);
+    parallelFor(level_count * 2, threads, 1, [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; t++) {
+            if (t < level_count) {
+                expected_index[t].build(expected, t);
+            } else {
+                actual_index[t - level_count].build(actual, t - level_count);
+            }
+        }
+    });
+
+    std::mutex mutex;
+    auto difference = [](const ItemsetPool::ItemsetView& view, uint32_t expected_support, uint32_t actual_support) {
+        return VerifyReport::Difference{vector<int>(view.begin(), view.end()), expected_support, actual_support};
+    };
+
+    for (size_t level = 0; level < level_count; level++) {
+        report.levels[level].expected = expected.levelSize(level);
+        report.levels[level].actual = actual.levelSize(level);
+        for (uint32_t i : expected_index[level].duplicates()) {
+            auto view = expected.get(level, i);
+            report.expected_duplicates.push_back(difference(view, view.support, 0));
+        }
+        for (uint32_t i : actual_index[level].duplicates()) {
+            auto view = actual.get(level, i);
+            report.actual_duplicates.push_back(difference(view, 0, view.support));
+        }
+
+        // 本次结果逐个到标准结果中查找：多出的项集、支持计数不同的项集
+        parallelFor(actual.levelSize(level), threads, 1024, [&](size_t begin, size_t end) {
+            vector<VerifyReport::Difference> extra, mismatch;
+            for (size_t i = begin; i < end; i++) {
+                auto view = actual.get(level, i);
+                long long found = expected_index[level].find(view);
+                if (found < 0) {
+                    extra.push_back(difference(view, 0, view.support));
+                } else {
+                    uint32_t support = expected.get(level, static_cast<size_t>(found)).support;
+                    if (support != view.support) {
+                        mismatch.push_back(difference(view, support, view.support));
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            report.extra.insert(report.extra.end(), extra.begin(), extra.end());
+            report.support_mismatch.insert(report.support_mismatch.end(), mismatch.begin(), mismatch.end());
+        });
+
+        // 标准结果逐个到本次结果中查找：缺失的项集
+        parallelFor(expected.levelSize(level), threads, 1024, [&](size_t begin, size_t end) {
+            vector<VerifyReport::Difference> missing;
+            for (size_t i = begin; i < end; i++) {
+                auto view = expected.get(level, i);
+                if (actual_index[level].find(view) < 0) {
+                    missing.push_back(difference(view, view.support, 0));
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            report.missing.insert(report.missing.end(), missing.begin(), missing.end());
+        });
+    }
+
+    // 并行收集的顺序不确定，排序后输出稳定
+    auto by_itemset = [](const VerifyReport::Difference& a, const VerifyReport::Difference& b) {
+        if (a.items.size() != b.items.size()) {
+            return a.items.size() < b.items.size();
+        }
+        return a.items < b.items;
+    };
+    std::sort(report.missing.begin(), report.missing.end(), by_itemset);
+    std::sort(report.extra.begin(), report.extra.end(), by_itemset);
+    std::sort(report.support_mismatch.begin(), report.support_mismatch.end(), by_itemset);
+    std::sort(report.expected_duplicates.begin(), report.expected_duplicates.end(), by_itemset);
+    std::sort(report.actual_duplicates.begin(), report.actual_duplicates.end(), by_itemset);
+    return report;
+}
+
+// duplicate 为 true 时列表是同一份结果中的重复项集，只打印该份结果中的支持计数
+static void printDifferences(const char* title, const vector<VerifyReport::Difference>& list,
+                             std::ostream& out, size_t max_listed, bool duplicate = false) {
+    out << title << ": " << list.size() << "\n";
+    for (size_t i = 0; i < list.size() && i < max_listed; i++) {
+        const auto& diff = list[i];
+        out << "  [";
+        for (size_t k = 0; k < diff.items.size(); k++) {
+            if (k > 0) out << ", ";
+            out << diff.items[k];
+        }
+        if (duplicate) {
+            out << "]: 支持计数=" << std::max(diff.expected_support, diff.actual_support) << "\n";
+        } else {
+            out << "]: 标准支持计数=" << diff.expected_support << ", 本次支持计数=" << diff.actual_support << "\n";
+        }
+    }
+    if (list.size() > max_listed) {
+        out << "  ... 省略 " << list.size() - max_listed << " 个\n";
+    }
+}
+
+void printVerifyReport(const VerifyReport& report, std::ostream& out, size_t max_listed) {
+    out << "========== 结果校验 ==========\n";
+    size_t expected_total = 0, actual_total = 0;
+    for (size_t level = 0; level < report.levels.size(); level++) {
+        const auto& count = report.levels[level];
+        expected_total += count.expected;
+        actual_total += count.actual;
+        out << "level: " << level << " 标准 " << count.expected << " 本次 " << count.actual;
+        if (count.expected != count.actual) {
+            out << " (差 " << static_cast<long long>(count.actual) - static_cast<long long>(count.expected) << ")";
+        }
+        out << "\n";
+    }
+    out << "总计: 标准 " << expected_total << " 本次 " << actual_total << "\n";
+
+    printDifferences("缺失项集", report.missing, out, max_listed);
+    printDifferences("多余项集", report.extra, out, max_listed);
+    printDifferences("支持计数不一致", report.support_mismatch, out, max_listed);
+    printDifferences("标准结果重复项集", report.expected_duplicates, out, max_listed, true);
+    printDifferences("本次结果重复项集", report.actual_duplicates, out, max_listed, true);
+    out << "校验结果: " << (report.ok() ? "一致" : "不一致") << "\n";
+    out << "================================" << std::endl;
+}
@@ -0,0 +1,67 @@
+#ifndef VERIFY_HPP
+#define VERIFY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "result/itemset_pool.hpp"
+
+/**
+ * 结果校验报告：以 expected（标准结果）为基准比较 actual（本次运行结果）
+ */
+struct VerifyReport {
+    // 单个level的项集数量
+    struct LevelCount {
+        size_t expected = 0;
+        size_t actual = 0;
+    };
+
+    // 单个有差异的项集，缺失一方的支持计数为0
+    struct Difference {
+        std::vector<int> items;
+        uint32_t expected_support = 0;
+        uint32_t actual_support = 0;
+    };
+
+    std::vector<LevelCount> levels;
+    std::vector<Difference> missing;            // 标准结果中有、本次结果中没有
+    std::vector<Difference> extra;              // 本次结果中有、标准结果中没有
+    std::vector<Difference> support_mismatch;   // 两边都有但支持计数不同
+    std::vector<Difference> expected_duplicates; // 标准结果中重复出现的项集（每多出现一次记一个）
+    std::vector<Difference> actual_duplicates;   // 本次结果中重复出现的项集（每多出现一次记一个）
+
+    bool ok() const noexcept {
+        for (const auto& level : levels) {
+            if (level.expected != level.actual) {
+                return false;
+            }
+        }
+        return missing.empty() && extra.empty() && support_mismatch.empty()
+            && expected_duplicates.empty() && actual_duplicates.empty();
+    }
+};
+
+/**
+ * 读取结果文件到结果池，自动识别格式：
+ * 二进制结果文件（result/result_file.hpp），或文本格式（fptree_standard_results.txt 布局
+ * 及 TextFileSink 输出，只解析形如 "[a, b]: 支持计数=N" 的行）
+ * 文本文件按行边界切块后在线程池上并行解析
+ * @throws std::runtime_error 文件无法打开或格式错误
+ */
+void loadResultFile(const std::string& path, ItemsetPool& out, int thread_count = 0);
+
+/**
+ * 比较两份结果：按level建立规范哈希索引后在线程池上并行互查
+ * 同一份结果中重复出现的项集单独报告，不会因为能在另一份中找到而被当作一致
+ * 差异列表按项集长度、字典序排列
+ */
+VerifyReport verifyResults(const ItemsetPool& expected, const ItemsetPool& actual, int thread_count = 0);
+
+/**
+ * 打印校验报告，每类差异最多列出 max_listed 个项集
+ */
+void printVerifyReport(const VerifyReport& report, std::ostream& out, size_t max_listed = 20);
+
+#endif // VERIFY_HPP
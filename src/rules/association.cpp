@@ -0,0 +1,139 @@
+#include "association.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <atomic>
+
+using std::vector;
+
+// 每攒够这么多条规则推送一次
+static constexpr size_t kFlushRules = 1 << 14;
+
+RuleGenerator::RuleGenerator(const ItemsetPool& itemsets, size_t transaction_count,
+                             double min_confidence, int thread_count)
+    : itemsets_(itemsets), index_(itemsets), transaction_count_(static_cast<double>(transaction_count)),
+      min_confidence_(min_confidence), thread_count_(resolveThreadCount(thread_count)) {
+}
+
+size_t RuleGenerator::generate(RuleSink& sink) {
+    // 只有至少2项的项集才能拆分出规则，按 (level, 下标) 展开后分块并行
+    vector<std::pair<uint32_t, uint32_t>> work;
+    for (size_t level = 1; level < itemsets_.levelCount(); level++) {
+        for (size_t i = 0; i < itemsets_.levelSize(level); i++) {
+            work.emplace_back(static_cast<uint32_t>(level), static_cast<uint32_t>(i));
+        }
+    }
+
+    std::atomic<size_t> generated{0};
+    parallelFor(work.size(), thread_count_, 256, [&](size_t begin, size_t end) {
+        RuleBatch batch;
+        Scratch scratch;
+        size_t count = 0;
+        for (size_t w = begin; w < end; w++) {
+            generateFor(itemsets_.get(work[w].first, work[w].second), batch, scratch);
+            if (batch.size() >= kFlushRules) {
+                count += batch.size();
+                sink.consume(batch);
+                batch.clear();
+            }
+        }
+        if (!batch.empty()) {
+            count += batch.size();
+            sink.consume(batch);
+        }
+        generated += count;
+    });
+
+    sink.finish();
+    return generated.load();
+}
+
+void RuleGenerator::generateFor(const ItemsetPool::ItemsetView& itemset, RuleBatch& out, Scratch& scratch) const {
+    size_t k = itemset.length;
+    auto& consequents = scratch.consequents;
+    auto& next = scratch.next;
+    auto& candidate = scratch.candidate;
+
+    // 1项后件
+    consequents.clear();
+    for (size_t i = 0; i < k; i++) {
+        if (evaluate(itemset, itemset.items + i, 1, out, scratch)) {
+            consequents.push_back(itemset.items[i]);
+        }
+    }
+
+    // 后件逐层扩展：m项后件两两连接（前 m-1 项相同）得到 m+1 项候选，
+    // 候选的所有 m 项子集都必须已通过，否则置信度不可能达标
+    for (size_t m = 1; m + 1 < k && consequents.size() >= 2 * m; m++) {
+        size_t count = consequents.size() / m;
+        auto passed = [&consequents, m, count](const int* subset) {
+            size_t lo = 0, hi = count;
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                const int* probe = consequents.data() + mid * m;
+                if (std::lexicographical_compare(probe, probe + m, subset, subset + m)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo < count && std::equal(subset, subset + m, consequents.data() + lo * m);
+        };
+
+        next.clear();
+        vector<int> subset(m);
+        for (size_t a = 0; a < count; a++) {
+            const int* left = consequents.data() + a * m;
+            for (size_t b = a + 1; b < count; b++) {
+                const int* right = consequents.data() + b * m;
+                if (!std::equal(left, left + m - 1, right)) {
+                    break;   // 后件按字典序排列，前缀不同之后不会再相同
+                }
+                candidate.assign(left, left + m);
+                candidate.push_back(right[m - 1]);
+
+                // 去掉最后两项之一的子集就是 left 和 right，只需检查去掉前 m-1 项之一的子集
+                bool all_passed = true;
+                for (size_t drop = 0; drop + 2 <= m && all_passed; drop++) {
+                    size_t s = 0;
+                    for (size_t j = 0; j <= m; j++) {
+                        if (j != drop) subset[s++] = candidate[j];
+                    }
+                    all_passed = passed(subset.data());
+                }
+                if (all_passed && evaluate(itemset, candidate.data(), candidate.size(), out, scratch)) {
+                    next.insert(next.end(), candidate.begin(), candidate.end());
+                }
+            }
+        }
+        consequents.swap(next);
+    }
+}
+
+bool RuleGenerator::evaluate(const ItemsetPool::ItemsetView& itemset, const int* consequent, size_t length,
+                             RuleBatch& out, Scratch& scratch) const {
+    // 前件 = 项集 - 后件（两者都是升序）
+    auto& antecedent = scratch.antecedent;
+    antecedent.clear();
+    std::set_difference(itemset.begin(), itemset.end(), consequent, consequent + length,
+                        std::back_inserter(antecedent));
+
+    uint32_t antecedent_support = index_.support(antecedent.data(), antecedent.size());
+    if (antecedent_support == 0) {
+        return false;   // 结果不完整（缺少子集），无法计算
+    }
+    double confidence = static_cast<double>(itemset.support) / antecedent_support;
+    if (confidence < min_confidence_) {
+        return false;
+    }
+
+    uint32_t consequent_support = index_.support(consequent, length);
+    double n = transaction_count_;
+    double lift = 0.0, leverage = 0.0;
+    if (consequent_support > 0 && n > 0) {
+        lift = confidence * n / consequent_support;
+        leverage = itemset.support / n - (antecedent_support / n) * (consequent_support / n);
+    }
+    out.add(antecedent.data(), antecedent.size(), consequent, length,
+            itemset.support, confidence, lift, leverage);
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef ASSOCIATION_HPP
+#define ASSOCIATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "result/itemset_pool.hpp"
+#include "result/support_index.hpp"
+#include "rules/rule_sink.hpp"
+
+/**
+ * 关联规则生成
+ * 对每个频繁项集 I（至少2项）枚举后件 Y，生成规则 (I \ Y) => Y。
+ * 后件从1项开始逐层扩展：后件变大时前件变小、置信度不会升高（反单调），
+ * 所以只有全部子后件都满足最小置信度的候选才会被扩展和计算。
+ * 所有支持计数通过 SupportIndex 以O(1)查得，不需要回到数据集重新计数。
+ */
+class RuleGenerator {
+public:
+    /**
+     * @param itemsets 完整的频繁项集（含支持计数），任何频繁项集的子集都必须在其中
+     * @param transaction_count 事务总数（计算提升度和杠杆率）
+     * @param min_confidence 最小置信度（0~1）
+     * @param thread_count 线程数，小于等于0时取硬件并发数
+     */
+    RuleGenerator(const ItemsetPool& itemsets, size_t transaction_count,
+                  double min_confidence, int thread_count = 0);
+
+    /**
+     * 生成规则并成批推送到接收端，结束时调用 sink.finish()
+     * @return 生成的规则数量
+     */
+    size_t generate(RuleSink& sink);
+
+private:
+    // 每个线程的临时空间
+    struct Scratch {
+        std::vector<int> consequents;       // 当前层通过的后件（扁平存放，每个长度相同）
+        std::vector<int> next;              // 下一层通过的后件
+        std::vector<int> candidate;
+        std::vector<int> antecedent;
+    };
+
+    /**
+     * 为一个项集生成所有满足最小置信度的规则
+     */
+    void generateFor(const ItemsetPool::ItemsetView& itemset, RuleBatch& out, Scratch& scratch) const;
+
+    /**
+     * 计算规则 (I \ Y) => Y 的度量，满足最小置信度时写入 out
+     * @return 是否满足最小置信度
+     */
+    bool evaluate(const ItemsetPool::ItemsetView& itemset, const int* consequent, size_t length,
+                  RuleBatch& out, Scratch& scratch) const;
+
+    const ItemsetPool& itemsets_;
+    SupportIndex index_;
+    double transaction_count_;
+    double min_confidence_;
+    size_t thread_count_;
+};
+
+#endif // ASSOCIATION_HPP
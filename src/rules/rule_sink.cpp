@@ -0,0 +1,55 @@
+#include "rule_sink.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+using std::string;
+
+static void appendItems(string& out, const int* items, uint32_t length) {
+    out += '[';
+    for (uint32_t i = 0; i < length; i++) {
+        if (i > 0) out += ", ";
+        out += std::to_string(items[i]);
+    }
+    out += ']';
+}
+
+TextRuleSink::TextRuleSink(const string& path)
+    : path_(path), file_(path, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("无法打开输出文件: " + path);
+    }
+}
+
+void TextRuleSink::consume(const RuleBatch& batch) {
+    // 在调用线程中格式化，再加锁一次性写入
+    string buffer;
+    buffer.reserve(batch.size() * 80);
+    char metrics[96];
+    batch.forEach([&buffer, &metrics](const RuleBatch::RuleView& rule) {
+        buffer += "  ";
+        appendItems(buffer, rule.antecedent, rule.antecedent_length);
+        buffer += " => ";
+        appendItems(buffer, rule.consequent, rule.consequent_length);
+        buffer += ": 支持计数=";
+        buffer += std::to_string(rule.support);
+        std::snprintf(metrics, sizeof(metrics), ", 置信度=%.4f, 提升度=%.4f, 杠杆率=%.6f\n",
+                      rule.confidence, rule.lift, rule.leverage);
+        buffer += metrics;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    check();
+}
+
+void TextRuleSink::finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush();
+    check();
+}
+
+void TextRuleSink::check() const {
+    if (!file_.good()) {
+        throw std::runtime_error("写入输出文件失败: " + path_);
+    }
+}
@@ -0,0 +1,173 @@
+#ifndef RULE_SINK_HPP
+#define RULE_SINK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 一批关联规则 X => Y
+ * 前件和后件（均为升序）连续存放在一个扁平数组中，每条规则只保存偏移、长度和度量值
+ */
+class RuleBatch {
+public:
+    struct Record {
+        size_t offset;
+        uint32_t antecedent_length;
+        uint32_t consequent_length;
+        uint32_t support;        // X ∪ Y 的支持计数
+        double confidence;       // sup(X ∪ Y) / sup(X)
+        double lift;             // confidence / (sup(Y) / N)
+        double leverage;         // sup(X ∪ Y) / N - (sup(X) / N) * (sup(Y) / N)
+    };
+
+    // 规则的只读视图
+    struct RuleView {
+        const int* antecedent;
+        uint32_t antecedent_length;
+        const int* consequent;
+        uint32_t consequent_length;
+        uint32_t support;
+        double confidence;
+        double lift;
+        double leverage;
+    };
+
+    void add(const int* antecedent, size_t antecedent_length,
+             const int* consequent, size_t consequent_length,
+             uint32_t support, double confidence, double lift, double leverage) {
+        records_.push_back(Record{items_.size(), static_cast<uint32_t>(antecedent_length),
+                                  static_cast<uint32_t>(consequent_length), support, confidence, lift, leverage});
+        items_.insert(items_.end(), antecedent, antecedent + antecedent_length);
+        items_.insert(items_.end(), consequent, consequent + consequent_length);
+    }
+
+    /**
+     * 追加另一批规则
+     */
+    void merge(const RuleBatch& other) {
+        size_t base = items_.size();
+        items_.insert(items_.end(), other.items_.begin(), other.items_.end());
+        for (Record record : other.records_) {
+            record.offset += base;
+            records_.push_back(record);
+        }
+    }
+
+    void clear() {
+        items_.clear();
+        records_.clear();
+    }
+
+    size_t size() const noexcept {
+        return records_.size();
+    }
+
+    bool empty() const noexcept {
+        return records_.empty();
+    }
+
+    RuleView get(size_t index) const {
+        const Record& r = records_[index];
+        const int* base = items_.data() + r.offset;
+        return RuleView{base, r.antecedent_length, base + r.antecedent_length, r.consequent_length,
+                        r.support, r.confidence, r.lift, r.leverage};
+    }
+
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (size_t i = 0; i < records_.size(); i++) {
+            fn(get(i));
+        }
+    }
+
+private:
+    std::vector<int> items_;
+    std::vector<Record> records_;
+};
+
+/**
+ * 规则接收端：规则生成线程成批推送，consume 可能被并发调用
+ */
+class RuleSink {
+public:
+    virtual ~RuleSink() = default;
+    virtual void consume(const RuleBatch& batch) = 0;
+    virtual void finish() {}
+};
+
+/**
+ * 只统计规则数量的接收端
+ */
+class CountingRuleSink : public RuleSink {
+public:
+    void consume(const RuleBatch& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        total_ += batch.size();
+    }
+
+    size_t size() const noexcept {
+        return total_;
+    }
+
+private:
+    std::mutex mutex_;
+    size_t total_ = 0;
+};
+
+/**
+ * 把所有规则收集到内存中的接收端
+ */
+class CollectRuleSink : public RuleSink {
+public:
+    void consume(const RuleBatch& batch) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rules_.merge(batch);
+    }
+
+    const RuleBatch& rules() const noexcept {
+        return rules_;
+    }
+
+private:
+    std::mutex mutex_;
+    RuleBatch rules_;
+};
+
+/**
+ * 文本文件接收端：每条规则一行
+ *   [a, b] => [c]: 支持计数=N, 置信度=0.8123, 提升度=3.2100, 杠杆率=0.0012
+ */
+class TextRuleSink : public RuleSink {
+public:
+    /**
+     * @throws std::runtime_error 无法打开文件
+     */
+    explicit TextRuleSink(const std::string& path);
+
+    /**
+     * @throws std::runtime_error 写入失败（如磁盘已满）
+     */
+    void consume(const RuleBatch& batch) override;
+
+    /**
+     * 刷新到磁盘
+     * @throws std::runtime_error 写入失败（如磁盘已满）
+     */
+    void finish() override;
+
+private:
+    /**
+     * @throws std::runtime_error 文件流处于错误状态
+     */
+    void check() const;
+
+    std::mutex mutex_;
+    std::string path_;
+    std::ofstream file_;
+};
+
+#endif // RULE_SINK_HPP
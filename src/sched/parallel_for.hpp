@@ -0,0 +1,49 @@
+#ifndef PARALLEL_FOR_HPP
+#define PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+#include "threadsignal.hpp"
+
+/**
+ * 线程数换算：大于0时直接使用，否则取硬件并发数
+ */
+inline size_t resolveThreadCount(int thread_count) {
+    if (thread_count > 0) {
+        return static_cast<size_t>(thread_count);
+    }
+    size_t hard = std::thread::hardware_concurrency();
+    return hard > 0 ? hard : 1;
+}
+
+/**
+ * 把 [0, n) 切成若干块（每块至少 min_block 个）在全局线程池上执行 fn(begin, end)，
+ * 单线程或数据量不足两块时直接在当前线程执行。
+ * 不要在线程池的任务内部调用，否则可能因等待自身所在的线程池而死锁。
+ */
+template <typename F>
+void parallelFor(size_t n, size_t threads, size_t min_block, F&& fn) {
+    if (threads <= 1 || n <= min_block) {
+        fn(size_t(0), n);
+        return;
+    }
+    size_t blocks = std::min(threads * 4, (n + min_block - 1) / min_block);
+    size_t block_size = (n + blocks - 1) / blocks;
+
+    auto& pool = getThreadPool(threads);
+    std::vector<std::future<void>> futures;
+    for (size_t begin = 0; begin < n; begin += block_size) {
+        size_t end = std::min(n, begin + block_size);
+        futures.push_back(pool.submit_task([&fn, begin, end]() {
+            fn(begin, end);
+        }));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
+#endif // PARALLEL_FOR_HPP
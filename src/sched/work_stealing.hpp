@@ -0,0 +1,156 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include "bs.hpp"
+#include "fptree/mine_stack.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 基于 BS 线程池的工作窃取调度器
+ * 每个工作线程持有一个私有工作栈（无锁）和一个共享栈（加锁）。
+ * 有线程空闲时，忙碌的线程把私有栈底部的一半栈帧（离根最近、工作量最大）捐出到共享栈，
+ * 空闲线程从任意共享栈中窃取，因此任意递归深度的子问题都可以被拆分到其他线程。
+ * Frame 的要求同 MineStack。
+ */
+template <typename Frame>
+class WorkStealingScheduler {
+public:
+    /**
+     * @param pool 运行工作线程的线程池
+     * @param workers 期望的工作线程数，不会超过线程池的线程数
+     */
+    WorkStealingScheduler(BS::thread_pool<>& pool, size_t workers)
+        : pool_(pool),
+          workers_(std::max<size_t>(1, std::min(workers, pool.get_thread_count()))),
+          shared_(workers_),
+          locks_(new std::mutex[workers_]),
+          outstanding_(0), hungry_(0), steals_(0) {
+    }
+
+    size_t workerCount() const noexcept {
+        return workers_;
+    }
+
+    /**
+     * 窃取成功的次数（用于观察负载均衡情况）
+     */
+    size_t stealCount() const noexcept {
+        return steals_.load();
+    }
+
+    /**
+     * 将初始栈帧轮流分配到各工作线程的共享栈
+     */
+    void seed(MineStack<Frame>& initial) {
+        outstanding_ += initial.size();
+        initial.scatter(shared_);
+    }
+
+    /**
+     * 运行所有工作线程直到全部栈帧处理完毕
+     * @param expand 展开函数 expand(worker, frame, local_stack)，子栈帧压入 local_stack
+     */
+    template <typename F>
+    void run(F&& expand) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(workers_);
+        for (size_t w = 0; w < workers_; w++) {
+            futures.push_back(pool_.submit_task([this, w, &expand]() {
+                workerLoop(w, expand);
+            }));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+    }
+
+private:
+    template <typename F>
+    void workerLoop(size_t worker, F& expand) {
+        MineStack<Frame> local;
+        Frame frame;
+
+        while (true) {
+            if (!acquire(worker, local)) {
+                // 空闲：登记为饥饿状态，等待其他线程捐出工作或全部完成
+                hungry_++;
+                bool done = false;
+                while (true) {
+                    // 共享栈为空且无人持有工作时不会再产生新工作；两者计在同一个计数里，
+                    // 不会出现“读到活跃数为0时刚捐出的栈帧还在排队”而提前退出
+                    if (outstanding_.load() == 0) {
+                        done = true;
+                        break;
+                    }
+                    if (acquire(worker, local)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+                hungry_--;
+                if (done) {
+                    return;
+                }
+            }
+
+            while (local.pop(frame)) {
+                expand(worker, frame, local);
+                if (hungry_.load(std::memory_order_relaxed) > 0 && local.size() >= 2) {
+                    donate(worker, local);
+                }
+            }
+            outstanding_--;
+        }
+    }
+
+    /**
+     * 从自己的共享栈开始依次尝试取走一个共享栈中的全部栈帧
+     * 成功时在持锁状态下把取走的栈帧换成一个活跃线程（一次原子操作），保证工作不会“消失”
+     */
+    bool acquire(size_t worker, MineStack<Frame>& local) {
+        for (size_t i = 0; i < workers_; i++) {
+            size_t victim = (worker + i) % workers_;
+            std::lock_guard<std::mutex> lock(locks_[victim]);
+            auto& shared = shared_[victim];
+            if (shared.empty()) {
+                continue;
+            }
+            outstanding_ -= shared.size() - 1;
+            std::swap(local, shared);
+            if (victim != worker) {
+                steals_++;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * 把私有栈底部的一半栈帧捐出到自己的共享栈
+     */
+    void donate(size_t worker, MineStack<Frame>& local) {
+        std::lock_guard<std::mutex> lock(locks_[worker]);
+        auto& shared = shared_[worker];
+        if (!shared.empty()) {
+            return;
+        }
+        outstanding_ += local.splitHalf(shared);
+    }
+
+    BS::thread_pool<>& pool_;
+    size_t workers_;
+    std::vector<MineStack<Frame>> shared_;      // 每个工作线程的共享栈
+    std::unique_ptr<std::mutex[]> locks_;       // 共享栈的锁
+    std::atomic<size_t> outstanding_;           // 共享栈中的栈帧数 + 持有工作的线程数
+    std::atomic<size_t> hungry_;                // 等待工作的线程数
+    std::atomic<size_t> steals_;                // 窃取次数
+};
+
+#endif // WORK_STEALING_HPP
@@ -0,0 +1,403 @@
+#include "daemon.hpp"
+#include "query/support_query.hpp"
+#include "rules/association.hpp"
+#include "rules/rule_sink.hpp"
+#include "sched/parallel_for.hpp"
+#include "topk/topk.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace {
+
+// 单个请求行的长度上限
+constexpr size_t kMaxRequestBytes = 1 << 20;
+
+// 带缓冲的按行读取
+class LineReader {
+public:
+    explicit LineReader(int fd) : fd_(fd) {}
+
+    /**
+     * 读取一行（不含换行符），连接关闭或出错时返回 false
+     */
+    bool next(string& line) {
+        while (true) {
+            size_t newline = buffer_.find('\n');
+            if (newline != string::npos) {
+                line.assign(buffer_, 0, newline);
+                buffer_.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                return true;
+            }
+            if (buffer_.size() > kMaxRequestBytes) {
+                return false;
+            }
+            char chunk[4096];
+            ssize_t received = ::recv(fd_, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(received));
+        }
+    }
+
+private:
+    int fd_;
+    string buffer_;
+};
+
+bool sendAll(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+sockaddr_un socketAddress(const string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("套接字路径过长: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+vector<string> splitFields(const string& line) {
+    vector<string> fields;
+    std::istringstream in(line);
+    for (string field; in >> field;) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+void writeItems(std::ostream& out, const int* items, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        out << ' ' << items[i];
+    }
+}
+
+// 按支持计数降序列出前 limit 个项集
+void writeTopItemsets(std::ostream& out, const ItemsetPool& itemsets, size_t limit) {
+    vector<ItemsetPool::ItemsetView> views;
+    views.reserve(itemsets.size());
+    itemsets.forEach([&views](const ItemsetPool::ItemsetView& view) { views.push_back(view); });
+    limit = std::min(limit, views.size());
+    std::partial_sort(views.begin(), views.begin() + limit, views.end(),
+                      [](const ItemsetPool::ItemsetView& a, const ItemsetPool::ItemsetView& b) {
+        return a.support > b.support;
+    });
+    for (size_t i = 0; i < limit; i++) {
+        out << views[i].support;
+        writeItems(out, views[i].items, views[i].length);
+        out << '\n';
+    }
+}
+
+} // namespace
+
+MiningDaemon::MiningDaemon(const string& socket_path, int request_threads, int mine_threads, const string& cache_directory)
+    : socket_path_(socket_path), mine_threads_(mine_threads), listen_fd_(-1), stopping_(false),
+      cache_(cache_directory), requests_(resolveThreadCount(request_threads)) {
+}
+
+MiningDaemon::~MiningDaemon() {
+    stop();
+    requests_.wait();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+    }
+}
+
+void MiningDaemon::addDataset(const string& name, const string& filename, char delimiter) {
+    Dataset entry;
+    entry.name = name;
+    entry.loader = std::make_unique<DataLoader>(filename, delimiter, mine_threads_);
+    entry.view = std::make_unique<DatasetView>(*entry.loader);
+    entry.fingerprint = datasetFingerprint(*entry.view, mine_threads_);
+    cout << "数据集 " << name << " 已加载: " << entry.loader->size() << " 条记录" << endl;
+    datasets_.push_back(std::move(entry));
+}
+
+void MiningDaemon::run() {
+    sockaddr_un address = socketAddress(socket_path_);
+    ::unlink(socket_path_.c_str());
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(string("无法创建套接字: ") + std::strerror(errno));
+    }
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(listen_fd_, 64) < 0) {
+        throw std::runtime_error("无法监听套接字 " + socket_path_ + ": " + std::strerror(errno));
+    }
+    cout << "挖掘服务已启动: " << socket_path_ << "（请求线程 " << requests_.get_thread_count()
+         << "，挖掘线程 " << mine_threads_ << "）" << endl;
+
+    while (!stopping_) {
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (!stopping_) {
+                std::cerr << "accept 失败: " << std::strerror(errno) << endl;
+            }
+            break;
+        }
+        requests_.detach_task([this, fd]() {
+            serve(fd);
+        });
+    }
+    // 等待处理中的连接结束
+    requests_.wait();
+    cout << "挖掘服务已停止" << endl;
+}
+
+void MiningDaemon::stop() {
+    if (stopping_.exchange(true)) {
+        return;
+    }
+    if (listen_fd_ >= 0) {
+        // 唤醒阻塞在 accept 上的主循环
+        ::shutdown(listen_fd_, SHUT_RDWR);
+    }
+    // 空闲连接的读取立即返回，正在写出的响应不受影响
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    for (int fd : connections_) {
+        ::shutdown(fd, SHUT_RD);
+    }
+}
+
+void MiningDaemon::serve(int fd) {
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.insert(fd);
+    }
+    LineReader reader(fd);
+    string line;
+    while (!stopping_ && reader.next(line)) {
+        std::ostringstream out;
+        try {
+            handle(line, out);
+        } catch (const std::exception& e) {
+            out.str("");
+            out << "ERR " << e.what() << '\n';
+        }
+        out << "END\n";
+        if (!sendAll(fd, out.str())) {
+            break;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.erase(fd);
+    }
+    ::close(fd);
+}
+
+const MiningDaemon::Dataset& MiningDaemon::dataset(const string& name) const {
+    for (const auto& entry : datasets_) {
+        if (entry.name == name) {
+            return entry;
+        }
+    }
+    throw std::runtime_error("未知的数据集: " + name);
+}
+
+const MinerRegistry::Entry& MiningDaemon::engine(const string& name) const {
+    for (const auto& entry : MinerRegistry::instance().entries()) {
+        if (entry.name == name) {
+            return entry;
+        }
+    }
+    throw std::runtime_error("未知的挖掘引擎: " + name);
+}
+
+void MiningDaemon::handle(const string& request, std::ostream& out) {
+    vector<string> args = splitFields(request);
+    if (args.empty()) {
+        throw std::runtime_error("空请求");
+    }
+    const string& command = args[0];
+    if (command == "PING") {
+        out << "OK pong\n";
+    } else if (command == "DATASETS") {
+        out << "OK " << datasets_.size() << '\n';
+        for (const auto& entry : datasets_) {
+            out << entry.name << ' ' << entry.loader->all_count << ' ' << std::hex << entry.fingerprint << std::dec << '\n';
+        }
+    } else if (command == "MINE") {
+        handleMine(args, out);
+    } else if (command == "SUPPORT") {
+        handleSupport(args, out);
+    } else if (command == "TOPK") {
+        handleTopK(args, out);
+    } else if (command == "RULES") {
+        handleRules(args, out);
+    } else if (command == "SHUTDOWN") {
+        stop();
+        out << "OK\n";
+    } else {
+        throw std::runtime_error("未知的请求: " + command);
+    }
+}
+
+void MiningDaemon::handleMine(const vector<string>& args, std::ostream& out) {
+    if (args.size() != 4 && args.size() != 5) {
+        throw std::runtime_error("用法: MINE <数据集> <引擎> <支持度> [列出数]");
+    }
+    const Dataset& data = dataset(args[1]);
+    const MinerRegistry::Entry& entry = engine(args[2]);
+    SupportThreshold threshold{std::stod(args[3])};
+    size_t limit = args.size() == 5 ? std::stoul(args[4]) : 0;
+
+    auto miner = MinerRegistry::instance().create(entry.name, mine_threads_);
+    auto start = std::chrono::high_resolution_clock::now();
+    CollectSink sink;
+    bool cached = cache_.mine(*miner, entry, *data.view, data.fingerprint, threshold, sink);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    const ItemsetPool& itemsets = sink.itemsets();
+    out << "OK itemsets=" << itemsets.size() << " cached=" << (cached ? 1 : 0) << " ms="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << '\n';
+    for (size_t level = 0; level < itemsets.levelCount(); level++) {
+        out << "LEVEL " << level << ' ' << itemsets.levelSize(level) << '\n';
+    }
+    writeTopItemsets(out, itemsets, limit);
+}
+
+void MiningDaemon::handleSupport(const vector<string>& args, std::ostream& out) {
+    if (args.size() < 3) {
+        throw std::runtime_error("用法: SUPPORT <数据集> <项> [<项> ...] [; <项> ...]");
+    }
+    const Dataset& data = dataset(args[1]);
+    vector<vector<int>> itemsets(1);
+    for (size_t i = 2; i < args.size(); i++) {
+        if (args[i] == ";") {
+            itemsets.emplace_back();
+        } else {
+            itemsets.back().push_back(std::stoi(args[i]));
+        }
+    }
+    SupportQuery query(*data.loader);
+    vector<uint32_t> supports = itemsets.size() == 1
+        ? vector<uint32_t>{query.support(itemsets[0])}
+        : query.supportBatch(itemsets);
+    out << "OK";
+    for (uint32_t support : supports) {
+        out << ' ' << support;
+    }
+    out << '\n';
+}
+
+void MiningDaemon::handleTopK(const vector<string>& args, std::ostream& out) {
+    if (args.size() != 3 && args.size() != 4) {
+        throw std::runtime_error("用法: TOPK <数据集> <K> [最大长度]");
+    }
+    const Dataset& data = dataset(args[1]);
+    size_t k = std::stoul(args[2]);
+    size_t max_length = args.size() == 4 ? std::stoul(args[3]) : 0;
+
+    TopK topk(*data.loader, k, max_length, mine_threads_);
+    const ItemsetPool& itemsets = topk.getTopItemsets();
+    out << "OK itemsets=" << itemsets.size() << " threshold=" << topk.finalThreshold() << '\n';
+    writeTopItemsets(out, itemsets, itemsets.size());
+}
+
+void MiningDaemon::handleRules(const vector<string>& args, std::ostream& out) {
+    if (args.size() != 5 && args.size() != 6) {
+        throw std::runtime_error("用法: RULES <数据集> <引擎> <支持度> <最小置信度> [列出数]");
+    }
+    const Dataset& data = dataset(args[1]);
+    const MinerRegistry::Entry& entry = engine(args[2]);
+    if (entry.kind != ItemsetKind::Frequent) {
+        throw std::runtime_error("生成规则需要全部频繁项集，引擎 " + entry.name + " 输出的是" + itemsetKindName(entry.kind));
+    }
+    SupportThreshold threshold{std::stod(args[3])};
+    double min_confidence = std::stod(args[4]);
+    size_t limit = args.size() == 6 ? std::stoul(args[5]) : 0;
+
+    auto miner = MinerRegistry::instance().create(entry.name, mine_threads_);
+    CollectSink itemsets;
+    cache_.mine(*miner, entry, *data.view, data.fingerprint, threshold, itemsets);
+
+    RuleGenerator generator(itemsets.itemsets(), data.loader->all_count, min_confidence, mine_threads_);
+    CollectRuleSink rules;
+    generator.generate(rules);
+
+    const RuleBatch& batch = rules.rules();
+    out << "OK rules=" << batch.size() << '\n';
+    vector<size_t> order(batch.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    limit = std::min(limit, order.size());
+    std::partial_sort(order.begin(), order.begin() + limit, order.end(), [&batch](size_t a, size_t b) {
+        return batch.get(a).confidence > batch.get(b).confidence;
+    });
+    for (size_t i = 0; i < limit; i++) {
+        RuleBatch::RuleView rule = batch.get(order[i]);
+        out << rule.confidence << ' ' << rule.lift << ' ' << rule.support;
+        writeItems(out, rule.antecedent, rule.antecedent_length);
+        out << " =>";
+        writeItems(out, rule.consequent, rule.consequent_length);
+        out << '\n';
+    }
+}
+
+int queryDaemon(const string& socket_path, const string& request, std::ostream& out) {
+    sockaddr_un address = socketAddress(socket_path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        string reason = std::strerror(errno);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        throw std::runtime_error("无法连接挖掘服务 " + socket_path + ": " + reason);
+    }
+
+    int status = 1;
+    if (sendAll(fd, request + "\n")) {
+        LineReader reader(fd);
+        string line;
+        bool first = true;
+        while (reader.next(line) && line != "END") {
+            if (first) {
+                status = line.compare(0, 2, "OK") == 0 ? 0 : 1;
+                first = false;
+            }
+            out << line << '\n';
+        }
+    }
+    ::close(fd);
+    return status;
+}
@@ -0,0 +1,123 @@
+#ifndef DAEMON_HPP
+#define DAEMON_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+#include "bs.hpp"
+#include "dataload/data_loader.hpp"
+#include "miner/miner.hpp"
+#include "miner/result_cache.hpp"
+
+/**
+ * 常驻挖掘服务：数据集只加载一次，倒排索引常驻内存，通过本地 Unix 套接字接收查询
+ *
+ * 协议为文本行，每行一个请求，字段以空格分隔，同一连接上的请求依次处理：
+ *   PING                                           -> OK pong
+ *   DATASETS                                       -> OK <数量>，随后每行 <名称> <事务数> <指纹>
+ *   MINE <数据集> <引擎> <支持度> [列出数]          -> OK itemsets=<总数> cached=<0|1> ms=<耗时>
+ *                                                     随后每行 LEVEL <level> <数量>，
+ *                                                     再按支持计数降序列出至多 列出数 行 <支持计数> <项...>
+ *   SUPPORT <数据集> <项...> [; <项...> ...]        -> OK <支持计数...>（多个项集以 ; 分隔，批量查询共享公共前缀）
+ *   TOPK <数据集> <K> [最大长度]                    -> OK itemsets=<数量> threshold=<最终阈值>，随后每行 <支持计数> <项...>
+ *   RULES <数据集> <引擎> <支持度> <最小置信度> [列出数]
+ *                                                  -> OK rules=<数量>，随后按置信度降序列出至多 列出数 行
+ *                                                     <置信度> <提升度> <支持计数> <前件...> => <后件...>
+ *   SHUTDOWN                                       -> OK，不再接受新连接，处理中的请求完成后退出
+ * 每个响应以单独一行 END 结束；请求出错时响应 ERR <原因>。
+ *
+ * 每个连接在服务自己的请求线程池中处理，多个连接的请求并发执行；
+ * 挖掘引擎内部使用全局线程池，两者分开，请求线程等待挖掘任务时不会因占满同一个线程池而死锁。
+ * MINE、RULES 经过结果缓存，同一数据集更高阈值的请求直接过滤已有结果。
+ */
+class MiningDaemon {
+public:
+    /**
+     * @param socket_path Unix 套接字路径（已存在时先删除）
+     * @param request_threads 同时处理的连接数，小于等于0时取硬件并发数
+     * @param mine_threads 每个挖掘请求使用的线程数
+     * @param cache_directory 结果缓存的持久化目录，为空时只缓存在内存中
+     */
+    MiningDaemon(const std::string& socket_path, int request_threads, int mine_threads,
+                 const std::string& cache_directory = "");
+    ~MiningDaemon();
+
+    /**
+     * 加载数据集（在 run 之前调用）
+     * @param name 请求中使用的数据集名称
+     * @param filename CSV 文件路径
+     * @param delimiter 分隔符
+     */
+    void addDataset(const std::string& name, const std::string& filename, char delimiter = ' ');
+
+    /**
+     * 监听套接字并处理请求，直到收到 SHUTDOWN
+     * @throws std::runtime_error 套接字无法创建或绑定
+     */
+    void run();
+
+    /**
+     * 停止接受新连接（可在其他线程调用）
+     */
+    void stop();
+
+private:
+    struct Dataset {
+        std::string name;
+        std::unique_ptr<DataLoader> loader;
+        std::unique_ptr<DatasetView> view;
+        uint64_t fingerprint;
+    };
+
+    /**
+     * 处理一个连接上的所有请求
+     */
+    void serve(int fd);
+
+    /**
+     * 处理一个请求，响应（不含结尾的 END）写入 out
+     */
+    void handle(const std::string& request, std::ostream& out);
+
+    void handleMine(const std::vector<std::string>& args, std::ostream& out);
+    void handleSupport(const std::vector<std::string>& args, std::ostream& out);
+    void handleTopK(const std::vector<std::string>& args, std::ostream& out);
+    void handleRules(const std::vector<std::string>& args, std::ostream& out);
+
+    /**
+     * 按名称查找数据集
+     * @throws std::runtime_error 数据集不存在
+     */
+    const Dataset& dataset(const std::string& name) const;
+
+    /**
+     * 按名称查找引擎
+     * @throws std::runtime_error 引擎不存在
+     */
+    const MinerRegistry::Entry& engine(const std::string& name) const;
+
+    std::string socket_path_;
+    int mine_threads_;
+    int listen_fd_;
+    std::atomic<bool> stopping_;
+    std::mutex connections_mutex_;
+    std::set<int> connections_;     // 打开的连接，停止时唤醒阻塞在读取上的连接
+    std::vector<Dataset> datasets_;
+    ResultCache cache_;
+    BS::thread_pool<> requests_;
+};
+
+/**
+ * 客户端：向服务发送一个请求，把响应（不含 END）写入 out
+ * @return 响应以 OK 开头时返回0，否则返回1
+ * @throws std::runtime_error 无法连接
+ */
+int queryDaemon(const std::string& socket_path, const std::string& request, std::ostream& out);
+
+#endif // DAEMON_HPP
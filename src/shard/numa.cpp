@@ -0,0 +1,55 @@
+#include "numa.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+
+vector<int> parseCpuList(const string& text) {
+    vector<int> cpus;
+    std::stringstream list(text);
+    for (string range; std::getline(list, range, ',');) {
+        while (!range.empty() && (range.back() == '\n' || range.back() == ' ')) {
+            range.pop_back();
+        }
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (first < 0 || last < first) {
+                throw std::invalid_argument(range);
+            }
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            throw std::runtime_error("无法解析 CPU 列表: " + text);
+        }
+    }
+    return cpus;
+}
+
+vector<vector<int>> numaNodeCpus() {
+    vector<vector<int>> nodes;
+    std::ifstream online("/sys/devices/system/node/online");
+    string text;
+    if (!online.is_open() || !std::getline(online, text)) {
+        return nodes;
+    }
+    for (int node : parseCpuList(text)) {
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        string cpus;
+        if (cpulist.is_open() && std::getline(cpulist, cpus)) {
+            vector<int> parsed = parseCpuList(cpus);
+            // 只有内存没有 CPU 的节点上无法运行工作进程
+            if (!parsed.empty()) {
+                nodes.push_back(std::move(parsed));
+            }
+        }
+    }
+    return nodes;
+}
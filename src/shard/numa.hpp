@@ -0,0 +1,19 @@
+#ifndef SHARD_NUMA_HPP
+#define SHARD_NUMA_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * 本机的 NUMA 拓扑：每个在线节点的 CPU 列表（读取 /sys/devices/system/node/node<N>/cpulist）
+ * 没有 NUMA 信息（非 Linux 或内核未提供）时为空
+ */
+std::vector<std::vector<int>> numaNodeCpus();
+
+/**
+ * 解析内核的 CPU 列表格式，如 "0-3,8-11"
+ * @throws std::runtime_error 格式错误
+ */
+std::vector<int> parseCpuList(const std::string& text);
+
+#endif // SHARD_NUMA_HPP
@@ -0,0 +1,242 @@
+#include "protocol.hpp"
+#include "result/varint.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// 消息头：类型 + 负载长度
+constexpr size_t kHeaderBytes = 5;
+
+/**
+ * 顺序读取负载中的字段
+ */
+class PayloadReader {
+public:
+    explicit PayloadReader(const string& payload)
+        : cursor_(reinterpret_cast<const unsigned char*>(payload.data())), end_(cursor_ + payload.size()) {}
+
+    uint64_t varint() {
+        return readVarint(cursor_, end_);
+    }
+
+    /**
+     * 读取元素个数：每个元素至少占一个字节，超过剩余字节数说明数据损坏（避免按损坏的个数分配内存）
+     */
+    uint64_t count() {
+        uint64_t value = varint();
+        if (value > static_cast<uint64_t>(end_ - cursor_)) {
+            throw std::runtime_error("分片消息数据损坏");
+        }
+        return value;
+    }
+
+    string text() {
+        uint64_t length = count();
+        string value(reinterpret_cast<const char*>(cursor_), length);
+        cursor_ += length;
+        return value;
+    }
+
+    /**
+     * 负载应当恰好读完
+     * @throws std::runtime_error 有多余的字节
+     */
+    void finish() const {
+        if (cursor_ != end_) {
+            throw std::runtime_error("分片消息数据损坏");
+        }
+    }
+
+private:
+    const unsigned char* cursor_;
+    const unsigned char* end_;
+};
+
+void appendText(string& out, const string& text) {
+    appendVarint(out, text.size());
+    out += text;
+}
+
+} // namespace
+
+MessageChannel::~MessageChannel() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void MessageChannel::send(MessageType type, const string& payload) {
+    if (payload.size() > UINT32_MAX) {
+        throw std::runtime_error("分片消息过大");
+    }
+    char header[kHeaderBytes];
+    header[0] = static_cast<char>(type);
+    uint32_t length = static_cast<uint32_t>(payload.size());
+    for (int i = 0; i < 4; i++) {
+        header[1 + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+
+    const char* parts[2] = {header, payload.data()};
+    size_t sizes[2] = {kHeaderBytes, payload.size()};
+    for (int part = 0; part < 2; part++) {
+        size_t sent = 0;
+        while (sent < sizes[part]) {
+            ssize_t n = ::send(fd_, parts[part] + sent, sizes[part] - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                throw std::runtime_error(string("分片消息发送失败: ") + std::strerror(errno));
+            }
+            sent += static_cast<size_t>(n);
+        }
+    }
+    sent_ += kHeaderBytes + payload.size();
+}
+
+bool MessageChannel::receive(Message& message) {
+    // 读满 size 个字节；一个字节都没读到就遇到 EOF 时返回 false
+    auto readFully = [this](char* out, size_t size) {
+        size_t received = 0;
+        while (received < size) {
+            ssize_t n = ::recv(fd_, out + received, size - received, 0);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                throw std::runtime_error(string("分片消息接收失败: ") + std::strerror(errno));
+            }
+            if (n == 0) {
+                if (received == 0) {
+                    return false;
+                }
+                throw std::runtime_error("分片消息被截断");
+            }
+            received += static_cast<size_t>(n);
+        }
+        return true;
+    };
+
+    unsigned char header[kHeaderBytes];
+    if (!readFully(reinterpret_cast<char*>(header), kHeaderBytes)) {
+        return false;
+    }
+    uint32_t length = 0;
+    for (int i = 0; i < 4; i++) {
+        length |= static_cast<uint32_t>(header[1 + i]) << (8 * i);
+    }
+    message.type = static_cast<MessageType>(header[0]);
+    message.payload.resize(length);
+    if (length > 0 && !readFully(&message.payload[0], length)) {
+        throw std::runtime_error("分片消息被截断");
+    }
+    received_ += kHeaderBytes + length;
+    return true;
+}
+
+string ShardSetup::encode() const {
+    string out;
+    appendText(out, engine);
+    appendVarint(out, threads);
+    appendVarint(out, min_count);
+    appendText(out, path);
+    appendVarint(out, static_cast<unsigned char>(delimiter));
+    appendVarint(out, begin);
+    appendVarint(out, end);
+    return out;
+}
+
+ShardSetup ShardSetup::decode(const string& payload) {
+    PayloadReader reader(payload);
+    ShardSetup setup;
+    setup.engine = reader.text();
+    setup.threads = static_cast<uint32_t>(reader.varint());
+    setup.min_count = reader.varint();
+    setup.path = reader.text();
+    setup.delimiter = static_cast<char>(reader.varint());
+    setup.begin = reader.varint();
+    setup.end = reader.varint();
+    reader.finish();
+    return setup;
+}
+
+string encodeItemsets(const ItemsetPool& itemsets) {
+    string out;
+    appendVarint(out, itemsets.size());
+    itemsets.forEach([&out](const ItemsetPool::ItemsetView& itemset) {
+        appendVarint(out, itemset.size());
+        int previous = 0;
+        for (int item : itemset) {
+            appendVarint(out, static_cast<uint64_t>(item - previous));
+            previous = item;
+        }
+    });
+    return out;
+}
+
+void decodeItemsets(const string& payload, ItemsetPool& out) {
+    PayloadReader reader(payload);
+    uint64_t count = reader.count();
+    vector<int> items;
+    for (uint64_t i = 0; i < count; i++) {
+        items.resize(reader.count());
+        int previous = 0;
+        for (int& item : items) {
+            item = previous + static_cast<int>(reader.varint());
+            previous = item;
+        }
+        out.insert(items.data(), items.size(), 0);
+    }
+    reader.finish();
+}
+
+string encodeTransactions(const DataLoader::Database& records, size_t begin, size_t end) {
+    string out;
+    appendVarint(out, end - begin);
+    for (size_t i = begin; i < end; i++) {
+        appendVarint(out, records[i].size());
+        for (int item : records[i]) {
+            appendVarint(out, static_cast<uint32_t>(item));
+        }
+    }
+    return out;
+}
+
+void decodeTransactions(const string& payload, DataLoader::Database& out) {
+    PayloadReader reader(payload);
+    uint64_t count = reader.count();
+    for (uint64_t i = 0; i < count; i++) {
+        DataLoader::Record record(reader.count());
+        for (int& item : record) {
+            item = static_cast<int>(static_cast<uint32_t>(reader.varint()));
+        }
+        out.push_back(std::move(record));
+    }
+    reader.finish();
+}
+
+string encodeCounts(const vector<uint32_t>& counts) {
+    string out;
+    appendVarint(out, counts.size());
+    for (uint32_t count : counts) {
+        appendVarint(out, count);
+    }
+    return out;
+}
+
+vector<uint32_t> decodeCounts(const string& payload) {
+    PayloadReader reader(payload);
+    vector<uint32_t> counts(reader.count());
+    for (uint32_t& count : counts) {
+        count = static_cast<uint32_t>(reader.varint());
+    }
+    reader.finish();
+    return counts;
+}
@@ -0,0 +1,135 @@
+#ifndef SHARD_PROTOCOL_HPP
+#define SHARD_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "result/itemset_pool.hpp"
+
+/**
+ * 协调进程与分片工作进程之间的消息类型
+ * 一次分片挖掘的消息顺序：
+ *   协调者 -> 工作进程：Setup，[Transactions ...，Done]（分片事务不从文件读取时）
+ *   工作进程 -> 协调者：Candidates ...，Done（局部频繁项集）
+ *   协调者 -> 工作进程：CandidateSet（全局候选集）
+ *   工作进程 -> 协调者：Supports（候选在分片上的支持计数，顺序与 CandidateSet 中的候选一致）
+ * 工作进程出错时发送 Error 后退出
+ */
+enum class MessageType : uint8_t {
+    Setup = 1,
+    Transactions = 2,
+    Candidates = 3,
+    CandidateSet = 4,
+    Supports = 5,
+    Done = 6,
+    Error = 7
+};
+
+/**
+ * 一条消息：线上格式为 1 字节类型 + 4 字节小端负载长度 + 负载
+ */
+struct Message {
+    MessageType type;
+    std::string payload;
+};
+
+/**
+ * 基于 Unix 域流套接字的消息通道，析构时关闭套接字
+ */
+class MessageChannel {
+public:
+    explicit MessageChannel(int fd) : fd_(fd) {}
+    ~MessageChannel();
+
+    MessageChannel(const MessageChannel&) = delete;
+    MessageChannel& operator=(const MessageChannel&) = delete;
+
+    int fd() const noexcept {
+        return fd_;
+    }
+
+    /**
+     * 已发送和已接收的字节数（含消息头）
+     */
+    size_t bytesSent() const noexcept {
+        return sent_;
+    }
+
+    size_t bytesReceived() const noexcept {
+        return received_;
+    }
+
+    /**
+     * 发送一条消息（对端已关闭时报错而不是触发 SIGPIPE）
+     * @throws std::runtime_error 写入失败
+     */
+    void send(MessageType type, const std::string& payload = std::string());
+
+    /**
+     * 阻塞读取一条完整的消息
+     * @return 对端在消息边界处关闭时为 false
+     * @throws std::runtime_error 读取失败或消息被截断
+     */
+    bool receive(Message& message);
+
+private:
+    int fd_;
+    size_t sent_ = 0;
+    size_t received_ = 0;
+};
+
+/**
+ * 分片的挖掘参数
+ */
+struct ShardSetup {
+    std::string engine;         // 引擎名称
+    uint32_t threads = 1;       // 工作进程内的线程数
+    uint64_t min_count = 1;     // 分片的局部支持计数阈值
+    std::string path;           // 数据文件，为空时事务随后由 Transactions 消息发送
+    char delimiter = ' ';
+    uint64_t begin = 0;         // 分片在文件中的行号范围 [begin, end)
+    uint64_t end = 0;
+
+    std::string encode() const;
+
+    /**
+     * @throws std::runtime_error 数据损坏
+     */
+    static ShardSetup decode(const std::string& payload);
+};
+
+/**
+ * 项集列表：varint 个数，每个项集为 varint 长度 + 升序项的 varint 差值（不含支持计数）
+ */
+std::string encodeItemsets(const ItemsetPool& itemsets);
+
+/**
+ * 解码项集并按顺序插入 out（支持计数为 0）
+ * @throws std::runtime_error 数据损坏
+ */
+void decodeItemsets(const std::string& payload, ItemsetPool& out);
+
+/**
+ * 事务列表：varint 条数，每条为 varint 长度 + 各项（按 uint32 的 varint，保持原顺序）
+ */
+std::string encodeTransactions(const DataLoader::Database& records, size_t begin, size_t end);
+
+/**
+ * 解码事务并追加到 out
+ * @throws std::runtime_error 数据损坏
+ */
+void decodeTransactions(const std::string& payload, DataLoader::Database& out);
+
+/**
+ * 计数列表：varint 个数 + 各计数的 varint
+ */
+std::string encodeCounts(const std::vector<uint32_t>& counts);
+
+/**
+ * @throws std::runtime_error 数据损坏
+ */
+std::vector<uint32_t> decodeCounts(const std::string& payload);
+
+#endif // SHARD_PROTOCOL_HPP
@@ -0,0 +1,397 @@
+#include "sharded.hpp"
+#include "partition/candidate_counter.hpp"
+#include "partition/son.hpp"
+#include "sched/parallel_for.hpp"
+#include "shard/numa.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <initializer_list>
+#include <mutex>
+#include <poll.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using std::string;
+using std::vector;
+
+namespace {
+
+// 每条 Transactions 消息包含的事务数
+constexpr size_t kTransactionBatch = 4096;
+
+// 字节数显示为 MB
+string megabytes(size_t bytes) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    return buffer;
+}
+
+/**
+ * 当前可执行文件的路径，工作进程以 dig shard-worker 的形式重新执行它
+ * @throws std::runtime_error 无法读取 /proc/self/exe
+ */
+string selfExecutable() {
+    char path[PATH_MAX];
+    ssize_t length = ::readlink("/proc/self/exe", path, sizeof(path) - 1);
+    if (length <= 0) {
+        throw std::runtime_error(string("无法确定可执行文件路径: ") + std::strerror(errno));
+    }
+    return string(path, static_cast<size_t>(length));
+}
+
+/**
+ * 把局部频繁项集逐批发给协调者，引擎的多个线程可能同时推送
+ */
+class ChannelSink : public ItemsetSink {
+public:
+    explicit ChannelSink(MessageChannel& channel) : channel_(channel) {}
+
+    void consume(const ItemsetPool& batch) override {
+        string payload = encodeItemsets(batch);
+        std::lock_guard<std::mutex> lock(mutex_);
+        channel_.send(MessageType::Candidates, payload);
+    }
+
+private:
+    MessageChannel& channel_;
+    std::mutex mutex_;
+};
+
+std::runtime_error unexpectedMessage(const Message& message) {
+    return std::runtime_error("收到意外的分片消息（类型 " + std::to_string(static_cast<int>(message.type)) + "）");
+}
+
+/**
+ * 工作进程读取协调者的下一条消息，类型须为 allowed 之一
+ * @throws std::runtime_error 连接关闭或类型不符
+ */
+Message expect(MessageChannel& channel, std::initializer_list<MessageType> allowed) {
+    Message message;
+    if (!channel.receive(message)) {
+        throw std::runtime_error("协调进程关闭了连接");
+    }
+    if (std::find(allowed.begin(), allowed.end(), message.type) == allowed.end()) {
+        throw unexpectedMessage(message);
+    }
+    return message;
+}
+
+/**
+ * 从文件中读取行号 [begin, end) 的事务
+ */
+DataLoader::Database readShard(const ShardSetup& setup) {
+    std::ifstream file(setup.path);
+    if (!file.is_open()) {
+        throw std::runtime_error("无法打开文件: " + setup.path);
+    }
+    DataLoader::Database records;
+    string line;
+    for (uint64_t index = 0; index < setup.end && std::getline(file, line); index++) {
+        if (index >= setup.begin) {
+            records.push_back(DataLoader::parseLine(line, setup.delimiter));
+        }
+    }
+    return records;
+}
+
+} // namespace
+
+/**
+ * 一个工作进程及与它相连的套接字；没有正常结束时析构会杀掉进程
+ */
+class ShardedMiner::Worker {
+public:
+    Worker(pid_t pid, int fd) : pid_(pid), channel_(fd) {}
+
+    ~Worker() {
+        if (pid_ > 0) {
+            ::kill(pid_, SIGKILL);
+            ::waitpid(pid_, nullptr, 0);
+        }
+    }
+
+    Worker(const Worker&) = delete;
+    Worker& operator=(const Worker&) = delete;
+
+    MessageChannel& channel() noexcept {
+        return channel_;
+    }
+
+    /**
+     * 等待进程退出
+     * @throws std::runtime_error 退出码不为 0
+     */
+    void join() {
+        int status = 0;
+        while (::waitpid(pid_, &status, 0) < 0 && errno == EINTR) {
+        }
+        pid_ = -1;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            throw std::runtime_error("分片工作进程异常退出");
+        }
+    }
+
+private:
+    pid_t pid_;
+    MessageChannel channel_;
+};
+
+ShardedMiner::ShardedMiner(const string& engine, int thread_count, size_t shards, bool pin_numa)
+    : engine_(engine), thread_count_(thread_count), shards_(std::max<size_t>(shards, 1)), pin_numa_(pin_numa) {
+    requireFrequentEngine(engine);
+}
+
+ShardedMiner::Workers ShardedMiner::spawn(size_t count) {
+    string executable = selfExecutable();
+    vector<vector<int>> nodes = pin_numa_ ? numaNodeCpus() : vector<vector<int>>();
+    stats_.numa_nodes = std::min(nodes.size(), count);
+
+    Workers workers;
+    for (size_t i = 0; i < count; i++) {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+            throw std::runtime_error(string("无法创建分片套接字: ") + std::strerror(errno));
+        }
+
+        // fork 之后到 exec 之前只能调用异步信号安全的函数，参数都提前准备好
+        string fd_text = std::to_string(sockets[1]);
+        string command = "shard-worker";
+        char* argv[] = {&executable[0], &command[0], &fd_text[0], nullptr};
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (!nodes.empty()) {
+            for (int cpu : nodes[i % nodes.size()]) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            // 绑定 CPU 后 exec，工作进程的内存按首次访问分配在所在节点上
+            if (!nodes.empty()) {
+                ::sched_setaffinity(0, sizeof(cpus), &cpus);
+            }
+            ::fcntl(sockets[1], F_SETFD, 0);
+            ::execv(argv[0], argv);
+            ::_exit(127);
+        }
+        ::close(sockets[1]);
+        if (pid < 0) {
+            ::close(sockets[0]);
+            throw std::runtime_error(string("无法创建分片工作进程: ") + std::strerror(errno));
+        }
+        workers.push_back(std::make_unique<Worker>(pid, sockets[0]));
+    }
+    return workers;
+}
+
+ShardSetup ShardedMiner::setupFor(size_t begin, size_t end, size_t min_count, size_t total) const {
+    ShardSetup setup;
+    setup.engine = engine_;
+    setup.threads = static_cast<uint32_t>(std::max<size_t>(1, resolveThreadCount(thread_count_) / shards_));
+    setup.min_count = SonMiner::localThreshold(min_count, end - begin, total);
+    setup.begin = begin;
+    setup.end = end;
+    return setup;
+}
+
+void ShardedMiner::mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) {
+    const DataLoader::Database& records = data.records();
+    size_t total = records.size();
+    size_t min_count = std::max<size_t>(threshold.resolve(data.transactionCount()), 1);
+    stats_ = Stats();
+    stats_.shards = std::max<size_t>(1, std::min(shards_, total));
+
+    Workers workers = spawn(stats_.shards);
+    for (size_t shard = 0; shard < workers.size(); shard++) {
+        size_t begin = total * shard / workers.size();
+        size_t end = total * (shard + 1) / workers.size();
+        MessageChannel& channel = workers[shard]->channel();
+        channel.send(MessageType::Setup, setupFor(begin, end, min_count, total).encode());
+        for (size_t batch = begin; batch < end; batch += kTransactionBatch) {
+            channel.send(MessageType::Transactions, encodeTransactions(records, batch, std::min(end, batch + kTransactionBatch)));
+        }
+        channel.send(MessageType::Done);
+    }
+    coordinate(workers, min_count, sink);
+    describe("事务经套接字发送");
+    sink.finish();
+}
+
+void ShardedMiner::mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink) {
+    size_t total = file.transactionCount();
+    size_t min_count = std::max<size_t>(threshold.resolve(total), 1);
+    stats_ = Stats();
+    stats_.shards = std::max<size_t>(1, std::min(shards_, total));
+
+    Workers workers = spawn(stats_.shards);
+    for (size_t shard = 0; shard < workers.size(); shard++) {
+        ShardSetup setup = setupFor(total * shard / workers.size(), total * (shard + 1) / workers.size(), min_count, total);
+        setup.path = file.path();
+        setup.delimiter = file.delimiter();
+        workers[shard]->channel().send(MessageType::Setup, setup.encode());
+    }
+    coordinate(workers, min_count, sink);
+    describe("工作进程各自读取文件");
+    sink.finish();
+}
+
+void ShardedMiner::describe(const string& source) {
+    fallback_ = "多进程分片挖掘（" + std::to_string(stats_.shards) + " 个工作进程，" + source;
+    if (stats_.numa_nodes > 0) {
+        fallback_ += "，绑定到 " + std::to_string(stats_.numa_nodes) + " 个 NUMA 节点";
+    }
+    fallback_ += "；候选 " + std::to_string(stats_.candidates) + " 个，全局频繁 " + std::to_string(stats_.frequent)
+        + " 个；消息发送 " + megabytes(stats_.bytes_sent) + "，接收 " + megabytes(stats_.bytes_received) + "）";
+}
+
+void ShardedMiner::coordinate(Workers& workers, size_t min_count, ItemsetSink& sink) {
+    // 第一轮：合并各分片的局部频繁项集
+    ItemsetPool candidates(true);
+    receiveAll(workers, [&](size_t, const Message& message) {
+        if (message.type == MessageType::Candidates) {
+            decodeItemsets(message.payload, candidates);
+            return false;
+        }
+        if (message.type == MessageType::Done) {
+            return true;
+        }
+        throw unexpectedMessage(message);
+    });
+
+    // 第二轮：下发候选集，按候选集中的顺序汇总各分片的支持计数
+    string candidate_set = encodeItemsets(candidates);
+    for (auto& worker : workers) {
+        worker->channel().send(MessageType::CandidateSet, candidate_set);
+    }
+    vector<uint64_t> supports(candidates.size(), 0);
+    receiveAll(workers, [&](size_t, const Message& message) {
+        if (message.type != MessageType::Supports) {
+            throw unexpectedMessage(message);
+        }
+        vector<uint32_t> counts = decodeCounts(message.payload);
+        if (counts.size() != supports.size()) {
+            throw std::runtime_error("分片返回的支持计数个数与候选数不符");
+        }
+        for (size_t i = 0; i < counts.size(); i++) {
+            supports[i] += counts[i];
+        }
+        return true;
+    });
+
+    SinkWriter writer(sink);
+    size_t index = 0;
+    candidates.forEach([&](const ItemsetPool::ItemsetView& itemset) {
+        if (supports[index] >= min_count) {
+            writer.emit(itemset.items, itemset.size(), static_cast<uint32_t>(supports[index]));
+        }
+        index++;
+    });
+    writer.flush();
+    stats_.candidates = candidates.size();
+    stats_.frequent = writer.emittedCount();
+
+    for (auto& worker : workers) {
+        stats_.bytes_sent += worker->channel().bytesSent();
+        stats_.bytes_received += worker->channel().bytesReceived();
+        worker->join();
+    }
+}
+
+void ShardedMiner::receiveAll(Workers& workers, const std::function<bool(size_t, const Message&)>& handle) {
+    vector<bool> finished(workers.size(), false);
+    size_t remaining = workers.size();
+    vector<pollfd> fds;
+    vector<size_t> owners;
+    Message message;
+    while (remaining > 0) {
+        fds.clear();
+        owners.clear();
+        for (size_t i = 0; i < workers.size(); i++) {
+            if (!finished[i]) {
+                fds.push_back(pollfd{workers[i]->channel().fd(), POLLIN, 0});
+                owners.push_back(i);
+            }
+        }
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(string("等待分片消息失败: ") + std::strerror(errno));
+        }
+        for (size_t k = 0; k < fds.size(); k++) {
+            if (fds[k].revents == 0) {
+                continue;
+            }
+            size_t worker = owners[k];
+            if (!workers[worker]->channel().receive(message)) {
+                throw std::runtime_error("分片工作进程 " + std::to_string(worker) + " 意外退出");
+            }
+            if (message.type == MessageType::Error) {
+                throw std::runtime_error("分片工作进程 " + std::to_string(worker) + " 出错: " + message.payload);
+            }
+            if (handle(worker, message)) {
+                finished[worker] = true;
+                remaining--;
+            }
+        }
+    }
+}
+
+int runShardWorker(int fd) {
+    MessageChannel channel(fd);
+    try {
+        ShardSetup setup = ShardSetup::decode(expect(channel, {MessageType::Setup}).payload);
+        DataLoader::Database records;
+        if (setup.path.empty()) {
+            for (;;) {
+                Message message = expect(channel, {MessageType::Transactions, MessageType::Done});
+                if (message.type == MessageType::Done) {
+                    break;
+                }
+                decodeTransactions(message.payload, records);
+            }
+        } else {
+            records = readShard(setup);
+        }
+        int threads = static_cast<int>(std::max<uint32_t>(setup.threads, 1));
+        DataLoader db(std::move(records), threads);
+
+        // 第一轮：按局部阈值挖掘本分片
+        ChannelSink candidates(channel);
+        auto miner = MinerRegistry::instance().create(setup.engine, threads);
+        miner->mine(DatasetView(db), SupportThreshold{static_cast<double>(setup.min_count)}, candidates);
+        channel.send(MessageType::Done);
+
+        // 第二轮：统计全局候选在本分片上的支持计数，按收到的顺序返回
+        ItemsetPool candidate_set;
+        decodeItemsets(expect(channel, {MessageType::CandidateSet}).payload, candidate_set);
+        CandidateCounter counter(candidate_set);
+        CandidateCounter::Counts counts = counter.emptyCounts();
+        counter.addRecords(db.getOriginalData(), threads, counts);
+        vector<uint32_t> supports;
+        supports.reserve(candidate_set.size());
+        candidate_set.forEach([&](const ItemsetPool::ItemsetView& itemset) {
+            int64_t id = counter.find(itemset.items, itemset.size());
+            supports.push_back(id >= 0 ? counts[id] : 0);
+        });
+        channel.send(MessageType::Supports, encodeCounts(supports));
+        return 0;
+    } catch (const std::exception& e) {
+        try {
+            channel.send(MessageType::Error, e.what());
+        } catch (const std::exception&) {
+            // 协调进程已经不在了，只能退出
+        }
+        return 1;
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef SHARDED_HPP
+#define SHARDED_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "miner/miner.hpp"
+#include "shard/protocol.hpp"
+
+/**
+ * 多进程分片挖掘：协调进程把事务切成若干分片，每个分片交给一个独立的工作进程（dig shard-worker），
+ * 工作进程有各自的地址空间和分配器，内存互不影响，可以分别绑定到不同的 NUMA 节点。
+ * 与 SON 分区挖掘一样分两轮：工作进程按缩小的阈值挖掘本分片，协调者合并局部频繁项集为全局候选集；
+ * 再把候选集下发给各工作进程统计分片上的支持计数，协调者求和后保留达到阈值的候选，结果是精确的。
+ * 进程之间通过 Unix 域套接字交换二进制消息（见 shard/protocol.hpp）。
+ */
+class ShardedMiner : public Miner {
+public:
+    struct Stats {
+        size_t shards = 0;          // 工作进程数
+        size_t numa_nodes = 0;      // 工作进程绑定到的 NUMA 节点数，0 表示未绑定
+        size_t candidates = 0;      // 全局候选数
+        size_t frequent = 0;        // 其中全局频繁的项集数
+        size_t bytes_sent = 0;      // 协调者发出的消息字节数
+        size_t bytes_received = 0;  // 协调者收到的消息字节数
+    };
+
+    /**
+     * @param engine 工作进程使用的引擎名称（须输出全部频繁项集）
+     * @param thread_count 总线程数，0 为硬件并发数，平分给各工作进程（每个至少 1 个）
+     * @param shards 工作进程数
+     * @param pin_numa 是否把工作进程依次绑定到各 NUMA 节点的 CPU 上
+     * @throws std::invalid_argument 引擎不存在或不输出全部频繁项集
+     */
+    ShardedMiner(const std::string& engine, int thread_count, size_t shards, bool pin_numa);
+
+    /**
+     * 与分片引擎同名，结果可以直接和该引擎比较
+     */
+    std::string name() const override {
+        return engine_;
+    }
+
+    /**
+     * 分片的事务经套接字发送给工作进程
+     * @throws std::runtime_error 无法启动工作进程、工作进程出错或异常退出
+     */
+    void mine(const DatasetView& data, const SupportThreshold& threshold, ItemsetSink& sink) override;
+
+    /**
+     * 协调者不读取事务，工作进程各自从文件读取自己的行范围
+     * @throws std::runtime_error 无法启动工作进程、工作进程出错或异常退出
+     */
+    void mineFile(const TransactionFile& file, const SupportThreshold& threshold, ItemsetSink& sink) override;
+
+    /**
+     * 上一次挖掘的统计
+     */
+    const Stats& stats() const noexcept {
+        return stats_;
+    }
+
+private:
+    class Worker;
+    using Workers = std::vector<std::unique_ptr<Worker>>;
+
+    /**
+     * 启动 count 个工作进程，各自持有一端套接字
+     * @throws std::runtime_error 无法创建套接字或进程
+     */
+    Workers spawn(size_t count);
+
+    /**
+     * 分片 [begin, end) 的挖掘参数（局部阈值按分片大小缩小）
+     */
+    ShardSetup setupFor(size_t begin, size_t end, size_t min_count, size_t total) const;
+
+    /**
+     * 两轮消息交换：合并候选、下发候选集、汇总支持计数并输出，最后等待工作进程退出
+     */
+    void coordinate(Workers& workers, size_t min_count, ItemsetSink& sink);
+
+    /**
+     * 轮询各工作进程的消息直到 handle 对每个进程都返回 true（该进程本轮结束）
+     * @throws std::runtime_error 工作进程报告错误或意外退出
+     */
+    void receiveAll(Workers& workers, const std::function<bool(size_t worker, const Message& message)>& handle);
+
+    /**
+     * 按本次的统计生成运行模式说明
+     * @param source 工作进程获得分片事务的方式
+     */
+    void describe(const std::string& source);
+
+    std::string engine_;
+    int thread_count_;
+    size_t shards_;
+    bool pin_numa_;
+    Stats stats_;
+};
+
+/**
+ * dig shard-worker 的入口：在继承来的套接字上按协议完成一个分片的两轮挖掘
+ * @param fd 与协调进程相连的套接字
+ * @return 进程退出码
+ */
+int runShardWorker(int fd);
+
+#endif // SHARDED_HPP
@@ -0,0 +1,239 @@
+#include "topk.hpp"
+#include "miner/tidlist.hpp"
+#include "sched/parallel_for.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using std::cout;
+using std::endl;
+using std::vector;
+
+TopK::TopK(const DataLoader& db, size_t k, size_t max_length, int thread_count, ItemsetSink* sink)
+    : db_(db), k_(k), max_length_(max_length), thread_count_(thread_count), final_threshold_(1), floor_(1), sink_(sink) {
+
+    cout << "\n========== Top-K 频繁项集 ==========" << endl;
+    cout << "K: " << k_;
+    if (max_length_ > 0) {
+        cout << "（1~" << max_length_ << " 项集各取K个）";
+    }
+    cout << endl;
+
+    if (k_ == 0) {
+        return;
+    }
+
+    auto begintime = std::chrono::high_resolution_clock::now();
+
+    thresholds_.reset(new std::atomic<uint32_t>[groupCount()]);
+    for (size_t g = 0; g < groupCount(); g++) {
+        thresholds_[g].store(1);
+    }
+
+    // 项按支持计数降序：高支持计数的项集先被找到，阈值尽早升高
+    const auto& inverted_index = db_.getInvertedIndex();
+    vector<int> order;
+    for (size_t item = 0; item < inverted_index.size(); item++) {
+        if (!inverted_index[item].empty()) {
+            order.push_back(static_cast<int>(item));
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&inverted_index](int a, int b) {
+        return inverted_index[a].size() > inverted_index[b].size();
+    });
+
+    vector<int> position(db_.getMaxValue() + 1, -1);
+    for (size_t r = 0; r < order.size(); r++) {
+        position[order[r]] = static_cast<int>(r);
+    }
+
+    // 内部阈值的下限：从第K大的1项集支持计数开始（整体取K个时这就是精确的下界）。
+    // 某组最终不足K个时说明下限过高，减半后重新搜索；每轮搜索在下限之上都是完整的
+    floor_ = 1;
+    if (order.size() >= k_) {
+        floor_ = static_cast<uint32_t>(inverted_index[order[k_ - 1]].size());
+    }
+
+    vector<vector<Candidate>> results;
+    while (true) {
+        for (size_t g = 0; g < groupCount(); g++) {
+            thresholds_[g].store(floor_);
+        }
+        search(order, position, results);
+
+        bool complete = true;
+        for (const auto& group : results) {
+            complete = complete && group.size() >= k_;
+        }
+        if (complete || floor_ <= 1) {
+            break;
+        }
+        floor_ = std::max<uint32_t>(1, floor_ / 2);
+        cout << "结果不足K个，阈值下限降为 " << floor_ << " 重新搜索" << endl;
+    }
+
+    emitTop(results);
+
+    auto endtime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endtime - begintime);
+    cout << "Top-K挖掘完成！最终支持计数阈值: " << final_threshold_ << "，耗时: " << duration.count() << "ms" << endl;
+}
+
+void TopK::search(const vector<int>& order, const vector<int>& position, vector<vector<Candidate>>& results) {
+    const auto& inverted_index = db_.getInvertedIndex();
+
+    // 顶层项分块，每块一个线程本地状态
+    size_t workers_wanted = thread_count_ > 1 ? static_cast<size_t>(thread_count_) : 1;
+    size_t blocks = workers_wanted == 1 ? 1 : std::max<size_t>(1, std::min(order.size(), workers_wanted * 4));
+    size_t block_size = (order.size() + blocks - 1) / blocks;
+    vector<Worker> workers(blocks);
+    for (auto& worker : workers) {
+        worker.heaps.resize(groupCount());
+    }
+
+    const auto& records = db_.getOriginalData();
+    parallelFor(blocks, workers_wanted, 1, [&](size_t begin, size_t end) {
+        vector<uint32_t> cooccur(order.size(), 0);
+        vector<size_t> siblings;
+        vector<int> prefix;
+        vector<int> tids;
+        for (size_t b = begin; b < end; b++) {
+            Worker& worker = workers[b];
+            size_t first = b * block_size;
+            size_t last = std::min(order.size(), first + block_size);
+            for (size_t i = first; i < last; i++) {
+                const auto& item_tids = inverted_index[order[i]];
+                uint32_t support = static_cast<uint32_t>(item_tids.size());
+                // 项按支持计数降序，后面的项只会更小
+                if (support < requiredSupport(1)) {
+                    break;
+                }
+                prefix.assign(1, order[i]);
+                offer(worker, prefix, support);
+
+                uint32_t need = requiredSupport(2);
+                if (support < need) {
+                    continue;
+                }
+                cooccurringSiblings(records, item_tids, position, i, need, cooccur, siblings);
+                vector<Extension> extensions;
+                for (size_t j : siblings) {
+                    if (intersectTids(item_tids, inverted_index[order[j]], need, tids)) {
+                        extensions.push_back(Extension{order[j], tids});
+                    }
+                }
+                if (!extensions.empty()) {
+                    mine(worker, prefix, extensions);
+                }
+            }
+        }
+    });
+
+    // 合并所有线程的堆，每组按排序规则取前K个
+    results.assign(groupCount(), {});
+    for (size_t group = 0; group < groupCount(); group++) {
+        auto& all = results[group];
+        for (auto& worker : workers) {
+            auto& entries = worker.heaps[group].entries;
+            std::move(entries.begin(), entries.end(), std::back_inserter(all));
+        }
+        std::sort(all.begin(), all.end(), better);
+        if (all.size() > k_) {
+            all.resize(k_);
+        }
+    }
+}
+
+bool TopK::better(const Candidate& a, const Candidate& b) {
+    if (a.support != b.support) {
+        return a.support > b.support;
+    }
+    if (a.items.size() != b.items.size()) {
+        return a.items.size() < b.items.size();
+    }
+    return a.items < b.items;
+}
+
+uint32_t TopK::requiredSupport(size_t length) const {
+    if (max_length_ == 0) {
+        return std::max(floor_, thresholds_[0].load(std::memory_order_relaxed));
+    }
+    if (length > max_length_) {
+        return UINT32_MAX;
+    }
+    uint32_t need = UINT32_MAX;
+    for (size_t g = length - 1; g < max_length_; g++) {
+        need = std::min(need, thresholds_[g].load(std::memory_order_relaxed));
+    }
+    return std::max(floor_, need);
+}
+
+void TopK::offer(Worker& worker, const vector<int>& items, uint32_t support) {
+    size_t group = groupOf(items.size());
+    auto& entries = worker.heaps[group].entries;
+    if (entries.size() >= k_ && support < entries.front().support) {
+        return;
+    }
+
+    Candidate candidate{items, support};
+    std::sort(candidate.items.begin(), candidate.items.end());
+    if (entries.size() < k_) {
+        entries.push_back(std::move(candidate));
+        std::push_heap(entries.begin(), entries.end(), better);
+    } else if (better(candidate, entries.front())) {
+        std::pop_heap(entries.begin(), entries.end(), better);
+        entries.back() = std::move(candidate);
+        std::push_heap(entries.begin(), entries.end(), better);
+    } else {
+        return;
+    }
+
+    // 本地堆满后，全局第K个项集的支持计数不会低于本地堆顶
+    if (entries.size() >= k_) {
+        uint32_t floor = entries.front().support;
+        auto& threshold = thresholds_[group];
+        uint32_t current = threshold.load(std::memory_order_relaxed);
+        while (current < floor && !threshold.compare_exchange_weak(current, floor, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+void TopK::mine(Worker& worker, vector<int>& prefix, vector<Extension>& extensions) {
+    size_t length = prefix.size() + 1;
+    vector<int> tids;
+    for (size_t i = 0; i < extensions.size(); i++) {
+        uint32_t support = static_cast<uint32_t>(extensions[i].tids.size());
+        // 阈值可能已被其他线程提高
+        if (support < requiredSupport(length)) {
+            continue;
+        }
+        prefix.push_back(extensions[i].item);
+        offer(worker, prefix, support);
+
+        uint32_t need = requiredSupport(length + 1);
+        if (support >= need) {
+            vector<Extension> children;
+            for (size_t j = i + 1; j < extensions.size(); j++) {
+                if (intersectTids(extensions[i].tids, extensions[j].tids, need, tids)) {
+                    children.push_back(Extension{extensions[j].item, tids});
+                }
+            }
+            // 递归深度不超过结果中最长项集的长度
+            if (!children.empty()) {
+                mine(worker, prefix, children);
+            }
+        }
+        prefix.pop_back();
+    }
+}
+
+void TopK::emitTop(const vector<vector<Candidate>>& results) {
+    SinkWriter writer(target());
+    for (const auto& group : results) {
+        for (const auto& candidate : group) {
+            writer.emit(candidate.items.data(), candidate.items.size(), candidate.support);
+        }
+        final_threshold_ = group.size() >= k_ ? group.back().support : 1;
+    }
+    writer.flush();
+}
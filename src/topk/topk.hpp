@@ -0,0 +1,127 @@
+#ifndef TOPK_HPP
+#define TOPK_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "dataload/data_loader.hpp"
+#include "result/itemset_pool.hpp"
+#include "result/sink.hpp"
+
+/**
+ * Top-K 频繁项集挖掘：不需要最小支持度，直接得到支持计数最高的K个项集
+ * 项按支持计数降序做深度优先的 tid 列表求交（Eclat），高支持计数的项集先被找到；
+ * 每个线程维护有界小顶堆，堆满后堆顶的支持计数就是当前的内部阈值，
+ * 线程之间通过原子变量共享最高的阈值，求交时低于阈值即提前结束，阈值随搜索不断提高。
+ * 阈值另有下限（初始为第K大的1项集支持计数），某组结果不足K个时下限减半重新搜索。
+ * 排序规则：支持计数降序，相同时项数少的在前，再按字典序，结果与线程数无关。
+ */
+class TopK {
+public:
+    /**
+     * 构造函数：挖掘Top-K项集
+     * @param db 数据加载器
+     * @param k 每组保留的项集数
+     * @param max_length 大于0时按长度分组，1~max_length 项集各保留K个；0 表示所有长度一起取K个
+     * @param thread_count 挖掘线程数，小于等于1时在当前线程串行挖掘
+     * @param sink 结果接收端，为空时结果收集在内存中，可通过 getTopItemsets 获取
+     */
+    TopK(const DataLoader& db, size_t k, size_t max_length = 0, int thread_count = 0, ItemsetSink* sink = nullptr);
+
+    /**
+     * 获取Top-K项集（按level组织，附带支持计数），指定了外部接收端时为空
+     */
+    const ItemsetPool& getTopItemsets() const {
+        return collected_.itemsets();
+    }
+
+    /**
+     * 最终的支持计数阈值（最后一组中第K个项集的支持计数，不足K个时为1）
+     */
+    uint32_t finalThreshold() const noexcept {
+        return final_threshold_;
+    }
+
+private:
+    struct Candidate {
+        std::vector<int> items;   // 升序
+        uint32_t support;
+    };
+
+    // 线程本地的有界堆，堆顶为当前最差的项集
+    struct Heap {
+        std::vector<Candidate> entries;
+    };
+
+    // 深度优先搜索中的一个扩展：prefix ∪ {item} 及其tid列表
+    struct Extension {
+        int item;
+        std::vector<int> tids;
+    };
+
+    // 每个线程的状态：每组一个堆
+    struct Worker {
+        std::vector<Heap> heaps;
+    };
+
+    const DataLoader& db_;
+    size_t k_;
+    size_t max_length_;
+    int thread_count_;
+    uint32_t final_threshold_;
+    uint32_t floor_;             // 本轮搜索的阈值下限
+
+    ItemsetSink* sink_;
+    CollectSink collected_;
+
+    ItemsetSink& target() {
+        return sink_ != nullptr ? *sink_ : collected_;
+    }
+
+    // 每组的共享阈值：所有线程本地堆顶支持计数的最大值
+    std::unique_ptr<std::atomic<uint32_t>[]> thresholds_;
+
+    // a 是否排在 b 前面
+    static bool better(const Candidate& a, const Candidate& b);
+
+    size_t groupCount() const noexcept {
+        return max_length_ > 0 ? max_length_ : 1;
+    }
+
+    size_t groupOf(size_t length) const noexcept {
+        return max_length_ > 0 ? length - 1 : 0;
+    }
+
+    /**
+     * 生成长度为 length 的项集时至少需要的支持计数：
+     * 之后所有长度分组阈值的最小值（它们的项集都是由这一层扩展出来的）
+     */
+    uint32_t requiredSupport(size_t length) const;
+
+    /**
+     * 尝试把项集放入线程本地堆，堆满时更新共享阈值
+     */
+    void offer(Worker& worker, const std::vector<int>& items, uint32_t support);
+
+    /**
+     * 深度优先展开：prefix 的所有扩展依次作为候选，再两两求交得到下一层
+     */
+    void mine(Worker& worker, std::vector<int>& prefix, std::vector<Extension>& extensions);
+
+    /**
+     * 以当前下限搜索一轮，合并所有线程的堆，每组按排序规则取前K个
+     * @param order 按支持计数降序排列的项
+     * @param position 原始项 -> 在 order 中的下标
+     */
+    void search(const std::vector<int>& order, const std::vector<int>& position,
+                std::vector<std::vector<Candidate>>& results);
+
+    /**
+     * 输出结果
+     */
+    void emitTop(const std::vector<std::vector<Candidate>>& results);
+};
+
+#endif // TOPK_HPP
@@ -0,0 +1,102 @@
+/**
+ * Apriori 内存预算（水平计数降级）的测试：有预算时峰值 RSS 要低于不限制时，结果数量相同
+ * 编译运行: g++ -O2 -std=c++17 -Iinclude -Isrc tests/apriori_budget_test.cpp src/apriori/apr.cpp src/dataload/data_loader.cpp \
+ *           src/result/itemset_pool.cpp src/profile/memory.cpp src/profile/profiler.cpp src/profile/perf_counters.cpp \
+ *           -o apriori_budget_test -pthread && ./apriori_budget_test
+ */
+#include "apriori/apr.hpp"
+#include "dataload/data_loader.hpp"
+#include "result/sink.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("失败: %s\n", what);
+        failures++;
+    }
+}
+
+struct RunResult {
+    bool ok = false;
+    size_t itemsets = 0;
+    long peak_kb = 0;   // 子进程的峰值 RSS
+};
+
+// 每条记录从 200 个项中随机取 16 个不同的项：2 项集全部频繁，tid 列表约 10 MB；
+// 3 项集都不频繁，但候选有 130 万个，水平计数一次全部生成要 20 MB 以上
+static DataLoader::Database makeRecords() {
+    std::mt19937 random(20240501);
+    std::vector<int> items(200);
+    for (size_t i = 0; i < items.size(); i++) {
+        items[i] = static_cast<int>(i);
+    }
+    DataLoader::Database records(20000);
+    for (auto& record : records) {
+        std::shuffle(items.begin(), items.end(), random);
+        record.assign(items.begin(), items.begin() + 16);
+        std::sort(record.begin(), record.end());
+    }
+    return records;
+}
+
+// 在子进程中加载并挖掘，峰值 RSS 互不影响；项集数量经管道传回
+// 数据也在子进程里加载：全局线程池的线程不会随 fork 复制，父进程不能先用线程池
+static RunResult mineInChild(size_t budget) {
+    RunResult result;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        std::freopen("/dev/null", "w", stdout);
+        DataLoader loader(makeRecords(), 2);
+        CountingSink sink;
+        Apriori apriori(loader, 30, 2, &sink, budget);
+        size_t itemsets = sink.size();
+        ssize_t written = write(fds[1], &itemsets, sizeof(itemsets));
+        _exit(written == sizeof(itemsets) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        close(fds[0]);
+        return result;
+    }
+    ssize_t got = read(fds[0], &result.itemsets, sizeof(result.itemsets));
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage {};
+    if (wait4(pid, &status, 0, &usage) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        result.ok = got == sizeof(result.itemsets);
+        result.peak_kb = usage.ru_maxrss;
+    }
+    return result;
+}
+
+int main() {
+    RunResult unlimited = mineInChild(0);
+    // 1 MB 放不下 level0 的 tid 列表，从一开始就用水平计数
+    RunResult budgeted = mineInChild(1 << 20);
+
+    expect(unlimited.ok, "不限制预算的挖掘失败");
+    expect(budgeted.ok, "有预算的挖掘失败");
+    expect(unlimited.itemsets > 0, "没有频繁项集");
+    expect(budgeted.itemsets == unlimited.itemsets, "有预算时频繁项集数量不同");
+    expect(budgeted.peak_kb < unlimited.peak_kb, "有预算时峰值 RSS 不低于不限制时");
+    std::printf("峰值 RSS：不限制 %ld KB，预算 1 MB %ld KB；频繁项集 %zu 个\n",
+                unlimited.peak_kb, budgeted.peak_kb, unlimited.itemsets);
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::printf("apriori_budget_test 通过\n");
+    return 0;
+}
@@ -0,0 +1,32 @@
+/**
+ * 最小支持计数换算的测试
+ * 编译运行: g++ -std=c++17 -Isrc tests/support_test.cpp -o support_test && ./support_test
+ */
+#include "miner/support.hpp"
+#include <cstdio>
+
+static int failures = 0;
+
+static void expect(size_t actual, size_t expected, const char* what) {
+    if (actual != expected) {
+        std::printf("失败: %s 期望 %zu 实际 %zu\n", what, expected, actual);
+        failures++;
+    }
+}
+
+int main() {
+    // 0.07 * 100 在 double 下是 7.000000000000001，不能取整为 8
+    expect(relativeSupportCount(0.07, 100), 7, "0.07 / 100");
+    expect(resolveSupportCount(0.07, 100), 7, "resolveSupportCount(0.07, 100)");
+    expect(relativeSupportCount(0.0003, 88162), 27, "0.0003 / 88162");
+    expect(relativeSupportCount(0.071, 100), 8, "0.071 / 100");
+    expect(relativeSupportCount(1.0, 100), 100, "1.0 / 100");
+    expect(relativeSupportCount(0.0001, 10), 1, "至少为 1");
+    expect(resolveSupportCount(5, 100), 5, "绝对支持计数");
+
+    if (failures > 0) {
+        return 1;
+    }
+    std::printf("support_test 通过\n");
+    return 0;
+}
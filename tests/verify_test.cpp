@@ -0,0 +1,72 @@
+/**
+ * 结果校验的测试
+ * 编译运行: g++ -std=c++17 -Iinclude -Isrc tests/verify_test.cpp src/result/verify.cpp src/result/result_file.cpp \
+ *           src/result/itemset_pool.cpp src/profile/memory.cpp -o verify_test -pthread && ./verify_test
+ */
+#include "result/verify.hpp"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("失败: %s\n", what);
+        failures++;
+    }
+}
+
+static void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << text;
+}
+
+static VerifyReport verifyFiles(const std::string& reference, const std::string& result) {
+    ItemsetPool expected, actual;
+    loadResultFile(reference, expected, 1);
+    loadResultFile(result, actual, 1);
+    return verifyResults(expected, actual, 1);
+}
+
+int main() {
+    const std::string reference = "verify_test_reference.txt";
+    const std::string result = "verify_test_result.txt";
+    const std::string standard =
+        "level: 1\n"
+        "[39, 48]: 支持计数=29142\n"
+        "[39, 41]: 支持计数=11414\n"
+        "level: 0\n"
+        "[39]: 支持计数=50675\n";
+
+    // 完全相同
+    writeFile(reference, standard);
+    writeFile(result, standard);
+    expect(verifyFiles(reference, result).ok(), "相同的结果应当一致");
+
+    // 本次结果重复了一行：每个项集都能在标准结果中找到，但不能算作一致
+    writeFile(result, standard + "[39, 48]: 支持计数=29142\n");
+    VerifyReport report = verifyFiles(reference, result);
+    expect(!report.ok(), "本次结果有重复行时应当不一致");
+    expect(report.actual_duplicates.size() == 1, "应当报告 1 个本次结果重复项集");
+    expect(report.expected_duplicates.empty(), "标准结果没有重复项集");
+    expect(report.extra.empty() && report.missing.empty(), "重复行不是多余或缺失");
+    expect(report.levels.size() == 2 && report.levels[1].actual == 3, "level 1 本次应为 3 个");
+
+    // 两边各重复了不同的一行：每个level数量相同、互查也都能找到
+    writeFile(reference, standard + "[39, 41]: 支持计数=11414\n");
+    writeFile(result, standard + "[39, 48]: 支持计数=29142\n");
+    report = verifyFiles(reference, result);
+    expect(!report.ok(), "两边都有重复行时应当不一致");
+    expect(report.expected_duplicates.size() == 1, "应当报告 1 个标准结果重复项集");
+    expect(report.actual_duplicates.size() == 1, "应当报告 1 个本次结果重复项集");
+    expect(report.missing.empty() && report.extra.empty(), "两边的项集相同");
+
+    std::remove(reference.c_str());
+    std::remove(result.c_str());
+    if (failures > 0) {
+        return 1;
+    }
+    std::printf("verify_test 通过\n");
+    return 0;
+}